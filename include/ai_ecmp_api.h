@@ -16,6 +16,17 @@ extern "C" {
  */
 WORD32 AI_ECMP_SgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_SG_CFG* pSgCfg);
 
+/**
+ * @brief SG配置批量同步接口，用于启动或换板后一次下发大量SG
+ * @param pSgCfgs SG配置数组
+ * @param dwSgNum SG配置数
+ * @param dwFlags 批量SG配置标志（AI_ECMP_SG_BATCH_*），设置AI_ECMP_SG_BATCH_DELETE时删除，否则新增或更新
+ * @param pResult 处理结果输出指针，可为空
+ * @return 操作结果码，部分配置被拒绝时返回错误码但其余配置已处理
+ */
+WORD32 AI_ECMP_SgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags,
+                             T_AI_ECMP_SG_BATCH_RESULT* pResult);
+
 // /**
 //  * @brief SG权重修改接口，为ftm接口，暂时写在这里
 //  * @param pOpParam 指向权重修改参数的指针
@@ -35,10 +46,18 @@ WORD32 AI_ECMP_SgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_SG_CFG* pSgCfg);
 // WORD32 ftm_sgItemNhopModifyCtrl(T_AI_ECMP_NHOP_MODIFY* pOpParam, T_AI_ECMP_SG_CFG* pSgCfg);
 
 /**
- * @brief 获取当前所有ECMP实例状态
- * @param pStatusBuffer 状态缓冲区
- * @param dwBufferSize 缓冲区大小
- * @return 实际状态数量
+ * @brief FTM能力声明接口，FTM初始化或升级后调用
+ * @param dwCapability 能力位（AI_ECMP_FTM_CAP_*），包含AI_ECMP_FTM_CAP_NHOP_BATCH时下一跳修改合并为批量消息下发，
+ *                     同时包含AI_ECMP_FTM_CAP_NHOP_DELTA时批量消息中可使用增量记录
+ * @return 操作结果码
+ */
+WORD32 AI_ECMP_SetFtmCapability(WORD32 dwCapability);
+
+/**
+ * @brief 获取当前所有ECMP实例状态（无锁，一次memcpy，可高频轮询）
+ * @param pStatusBuffer 状态缓冲区，按定长 T_AI_ECMP_INSTANCE_STATUS 记录数组填写（记录带格式版本和长度），为空时只返回实例数
+ * @param dwBufferSize 缓冲区大小（字节），不足时只填写能放下的记录
+ * @return 填写的记录数（pStatusBuffer为空时为实例数）
  * @author 张志宸10350479  @date 2025/05/13
  */
 WORD32 ftm_aiEcmpGetAllStatus(void* pStatusBuffer, WORD32 dwBufferSize);
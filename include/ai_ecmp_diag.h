@@ -51,10 +51,187 @@ VOID diagAiEcmpForceOptimization(WORD32 dwSgId);
 /**
  * @brief 诊断函数：设置使用的优化算法类型
  * @param dwSgId SG ID，0表示对所有实例生效
- * @param dwAlgorithmType 算法类型: 1-LocalSearch, 2-GA_IMP
+ * @param dwAlgorithmType 算法类型: 1-LocalSearch, 3-Portfolio（2-GA_IMP未接入，返回错误）
  */
 VOID diagAiEcmpSetAlgorithm(WORD32 dwSgId, WORD32 dwAlgorithmType);
 
+/**
+ * @brief 诊断函数：打印组合优化器的算法胜出统计
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintPortfolioStats(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：打印在线参数调优器的各参数组统计
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintTuner(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：固定或取消固定在线调优器的参数组
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwArmIndex 参数组下标，0xFFFFFFFF表示取消固定
+ */
+VOID diagAiEcmpPinTunerArm(WORD32 dwSgId, WORD32 dwArmIndex);
+
+/**
+ * @brief 诊断函数：打印优化解缓存的命中统计
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintSolutionCache(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：设置负载模型
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwModelType 模型类型：0=原始累计, 1=EWMA, 2=滑动窗口, 3=峰值保持
+ * @param dwParam EWMA/峰值保持为半衰期（周期数），滑动窗口为窗口长度（周期数）
+ */
+VOID diagAiEcmpSetLoadModel(WORD32 dwSgId, WORD32 dwModelType, WORD32 dwParam);
+
+/**
+ * @brief 诊断函数：启用或禁用优化报告打印
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwEnable 1表示启用，0表示禁用（禁用后不分配打印器）
+ */
+VOID diagAiEcmpSetReport(WORD32 dwSgId, WORD32 dwEnable);
+
+/**
+ * @brief 诊断函数：打印实例内存占用
+ * @param dwSgId SG ID，0表示所有实例（仅打印汇总）
+ */
+VOID diagAiEcmpPrintMemoryUsage(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：设置负载预测
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwForecastType 预测类型：0=不预测, 1=Holt, 2=Holt-Winters
+ * @param dwSeasonCycles 季节周期长度（周期数），仅Holt-Winters使用
+ */
+VOID diagAiEcmpSetForecast(WORD32 dwSgId, WORD32 dwForecastType, WORD32 dwSeasonCycles);
+
+/**
+ * @brief 诊断函数：打印负载预测状态及预测误差
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintForecast(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：设置大流桶检测
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwEnable 1表示启用，0表示禁用
+ * @param dwEnterPercent 进入门限（端口平均负载的百分比），0表示默认50
+ * @param dwExitPercent 退出门限（端口平均负载的百分比），0表示默认30
+ */
+VOID diagAiEcmpSetElephant(WORD32 dwSgId, WORD32 dwEnable, WORD32 dwEnterPercent, WORD32 dwExitPercent);
+
+/**
+ * @brief 诊断函数：打印大流桶集合及其所在端口
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintElephants(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：模拟端口故障，所有包含该端口的实例立即执行故障快速切换
+ * @param dwPortId 故障端口ID
+ */
+VOID diagAiEcmpPortDown(WORD32 dwPortId);
+
+/**
+ * @brief 诊断函数：开始或取消端口排空
+ * @param dwPortId 排空端口ID
+ * @param dwEnable 1表示开始排空，0表示取消
+ * @param dwStepPercent 每步迁移上限（开始时端口负载的百分比），0表示默认25
+ * @param dwCapPercent 存活端口利用率上限（排空后平均利用率的百分比），0表示默认120
+ * @param dwCapOverride 1表示允许停滞时超出利用率上限（操作员显式放行），0表示上限为硬约束
+ */
+VOID diagAiEcmpDrainPort(WORD32 dwPortId, WORD32 dwEnable, WORD32 dwStepPercent, WORD32 dwCapPercent, WORD32 dwCapOverride);
+
+/**
+ * @brief 诊断函数：打印端口排空进度
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintDrain(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：设置稳定性判定
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwMode 判定方式：0-旧方式（各桶变异系数平均），1-按流量加权
+ * @param dwErrorPercent 负载估计相对误差门限（百分比），0表示默认15
+ * @param dwMinSharePercent 显著桶下限（桶平均负载的百分比），0表示默认10
+ */
+VOID diagAiEcmpSetStability(WORD32 dwSgId, WORD32 dwMode, WORD32 dwErrorPercent, WORD32 dwMinSharePercent);
+
+/**
+ * @brief 诊断函数：打印稳定性判定配置及最近一次判定结果
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintStability(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：设置优化效果显著性检验
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwEnable 1-启用，0-禁用（只按最新一次负载估计比较）
+ * @param dwConfidencePercent 单侧置信度（百分比，80~99），0表示默认90
+ * @param dwMinSamples 检验所需的最少速率样本数，0表示默认3
+ */
+VOID diagAiEcmpSetSignificance(WORD32 dwSgId, WORD32 dwEnable, WORD32 dwConfidencePercent, WORD32 dwMinSamples);
+
+/**
+ * @brief 诊断函数：打印显著性检验配置及最近一次检验结果
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintSignificance(WORD32 dwSgId);
+
+/**
+ * @brief 诊断函数：设置优化周期调度
+ * @param dwBudgetMicros 每个优化周期的CPU预算（微秒），0表示不限制
+ * @param dwAgingPercent 每推迟一个周期优先级增加的百分比
+ */
+VOID diagAiEcmpSetScheduler(WORD32 dwBudgetMicros, WORD32 dwAgingPercent);
+
+/**
+ * @brief 诊断函数：打印调度统计及参与最近周期调度、按优先级排序的SG列表
+ * @param dwTopNum 打印的SG数，0表示全部
+ */
+VOID diagAiEcmpPrintScheduler(WORD32 dwTopNum);
+
+/**
+ * @brief 诊断函数：设置实例处理相位数（按新相位数重新分配实例，并清空节拍耗时统计）
+ * @param dwPhaseNum 相位数，0表示默认10
+ */
+VOID diagAiEcmpSetPhases(WORD32 dwPhaseNum);
+
+/**
+ * @brief 诊断函数：打印各相位的实例分布及节拍耗时直方图
+ */
+VOID diagAiEcmpPrintPhases();
+
+/**
+ * @brief 诊断函数：设置下一跳修改增量下发（等同于FTM声明或撤销增量能力，启用时同时声明批量消息能力）
+ * @param dwEnable 1启用，0禁用
+ * @param dwMaxSharePct 变化表项占比超过该百分比时回退为全量，0表示默认50
+ */
+VOID diagAiEcmpSetNhopDelta(WORD32 dwEnable, WORD32 dwMaxSharePct);
+
+/**
+ * @brief 诊断函数：打印下一跳修改批量下发统计
+ */
+VOID diagAiEcmpPrintSendStats();
+
+/**
+ * @brief 诊断函数：设置下一跳修改的在途确认跟踪
+ * @param dwSgId SG ID，0表示对所有实例生效
+ * @param dwTimeoutMs 等待配置回显确认的超时（毫秒），0表示默认3000
+ * @param dwMaxRetries 超时后全量重发的次数上限，用尽后回滚到最近确认的成员表
+ */
+VOID diagAiEcmpSetInflight(WORD32 dwSgId, WORD32 dwTimeoutMs, WORD32 dwMaxRetries);
+
+/**
+ * @brief 诊断函数：打印待确认的下一跳修改及确认统计
+ * @param dwSgId SG ID，0表示打印所有实例
+ */
+VOID diagAiEcmpPrintInflight(WORD32 dwSgId);
+
 /**
  * @brief 诊断函数：打印计数器历史信息
  * @param dwSgId SG ID
@@ -20,6 +20,7 @@ typedef enum {
     AI_ECMP_ERR_ADJUST_FAILED      = 1010, /* 调整失败 */
     AI_ECMP_ERR_SG_OPERATION       = 1011, /* SG操作失败 */
     AI_ECMP_ERR_NO_INSTANCE        = 1012, /* 没有ECMP实例 */
+    AI_ECMP_ERR_SHRINK_FAILED      = 1013, /* 缩容失败 */
     AI_ECMP_ERR_INTERNAL           = 1999  /* 内部错误 */
 } T_AI_ECMP_ERROR_CODE;
 
@@ -13,16 +13,19 @@ VOID convertByteOrderWfg(T_AI_SG_WEIGHT_CFG& weightCfg);
 VOID convertByteOrderSfg(T_AI_ECMP_SG_CFG& sgCfg);
 VOID convertByteOrderWeightMod(T_AI_ECMP_WEIGHT_MODIFY& weightMod);
 VOID convertByteOrderNhopMod(T_AI_ECMP_NHOP_MODIFY& nhopMod);
+VOID convertByteOrderNhopBatch(BYTE* pMsg, WORD32 dwLen);
+VOID convertByteOrderSgBatchHdr(T_AI_ECMP_SG_BATCH_HDR& batchHdr);
 
 // 对外接口
 WORD32 aiEcmpCfgCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID * pPData, BOOLEAN bSame);   //收到cfg后回调动作
+WORD32 aiEcmpCfgBatchCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID * pPData, BOOLEAN bSame);  //收到批量cfg后回调动作
 WORD32 aiEcmpStateCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID * pPData, BOOLEAN bSame);
 // VOID aiEcmpSendWeightModify(const T_AI_ECMP_WEIGHT_MODIFY& input);  //发送权重调整信号给ECMP模块
 VOID aiEcmpSendNhopModify(const T_AI_ECMP_NHOP_MODIFY& input);      //发生新的配置给ECMP模块
+VOID aiEcmpSendNhopBatch(BYTE* pMsg, WORD32 dwLen);                 //发送批量下一跳修改消息给ECMP模块（原地转换字节序）
 
-// TODO
-// 读counter
-VOID aiEcmpReadAction();  //100ms定时器执行，度counter
+// 100ms定时器执行：按相位处理实例（读counter、优化、下发）
+VOID aiEcmpReadAction();
 #ifdef __cplusplus
 }
 #endif
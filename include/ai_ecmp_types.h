@@ -32,7 +32,8 @@ typedef enum {
     AI_ECMP_EVAL,         /* 评估中 */
     AI_ECMP_EXPAND,       /* 扩容中 */
     AI_ECMP_BALANCE,      /* 平衡状态 */
-    AI_ECMP_FAIL          /* 调整失败 */
+    AI_ECMP_FAIL,         /* 调整失败 */
+    AI_ECMP_SHRINK        /* 缩容中 */
 } T_AI_ECMP_STATUS;
 
 /* ECMP逻辑成员信息 */
@@ -60,6 +61,16 @@ typedef struct {
     T_AI_SG_WEIGHT_CFG ports[FTM_LAG_MAX_MEM_NUM_15K];  /* 物理成员数组 */
 } T_AI_ECMP_SG_CFG;
 
+/* ECMP SG配置头（不含成员数组，供实例紧凑保存） */
+typedef struct {
+    WORD32 dwSgId;           /* SG id */
+    WORD32 dwSeqId;          /* 版本号 */
+    WORD32 dwFwdLagId;       /* 微码Lag id */
+    WORD32 dwItemNum;        /* 散列后逻辑成员链路数 */
+    WORD32 dwPortNum;        /* 实际物理成员链路数 */
+    WORD32 dwCounterBase;    /* 成员Counter Id基地址 */
+} T_AI_ECMP_SG_HDR;
+
 // /* 权重修改参数 */
 // typedef struct {
 //     WORD32 dwSgId;           /* SG id */
@@ -77,6 +88,69 @@ typedef struct {
     WORD32 adwLinkItem[FTM_TRUNK_MAX_HASH_NUM_15K]; /* 修改后散列逻辑成员数组 */
 } T_AI_ECMP_NHOP_MODIFY;
 
+/* 增量下一跳修改：只携带变化的散列表项（下标，端口）对 */
+typedef struct {
+    WORD32 dwIndex;          /* 散列表项下标 */
+    WORD32 dwPortId;         /* 修改后的端口 */
+} T_AI_ECMP_NHOP_DELTA_ITEM;
+
+typedef struct {
+    WORD32 dwSgId;           /* SG id */
+    WORD32 dwSeqId;          /* 版本号 */
+    WORD32 dwItemNum;        /* 散列后逻辑成员链路数（与已下发成员表相同，0表示无法生成增量） */
+    WORD32 dwChangeNum;      /* 变化的表项数 */
+    T_AI_ECMP_NHOP_DELTA_ITEM astChange[FTM_TRUNK_MAX_HASH_NUM_15K]; /* 变化的表项 */
+} T_AI_ECMP_NHOP_DELTA;
+
+/* FTM能力位：支持批量消息中的增量记录（须同时支持批量消息） */
+const WORD32 AI_ECMP_FTM_CAP_NHOP_DELTA = 0x00000001;
+/* FTM能力位：支持批量下一跳修改消息（未声明时每个SG单独下发T_AI_ECMP_NHOP_MODIFY） */
+const WORD32 AI_ECMP_FTM_CAP_NHOP_BATCH = 0x00000002;
+
+/* 批量下一跳修改消息（FTM声明AI_ECMP_FTM_CAP_NHOP_BATCH时才使用）：消息头后紧接dwRecordNum条记录，每条记录为记录头加dwEntryNum个表项（按实际长度紧凑排列）
+ * 全量记录的表项为dwItemNum个逻辑成员（WORD32），增量记录的表项为T_AI_ECMP_NHOP_DELTA_ITEM */
+const WORD32 AI_ECMP_NHOP_BATCH_MAGIC = 0x4E484254;    /* "NHBT" */
+const WORD32 AI_ECMP_NHOP_BATCH_MAX_LEN = 4096;        /* 单条批量消息的最大长度 */
+const WORD32 AI_ECMP_NHOP_REC_FULL = 0;                /* 全量记录 */
+const WORD32 AI_ECMP_NHOP_REC_DELTA = 1;               /* 增量记录（FTM声明AI_ECMP_FTM_CAP_NHOP_DELTA时才使用） */
+
+typedef struct {
+    WORD32 dwMagic;          /* 批量消息标识 AI_ECMP_NHOP_BATCH_MAGIC */
+    WORD32 dwRecordNum;      /* 消息中的记录数 */
+    WORD32 dwTotalLen;       /* 消息总长度（含消息头） */
+} T_AI_ECMP_NHOP_BATCH_HDR;
+
+typedef struct {
+    WORD32 dwSgId;           /* SG ifindex */
+    WORD32 dwSeqId;          /* 版本号 */
+    WORD32 dwItemNum;        /* 散列后逻辑成员链路数 */
+    WORD32 dwRecType;        /* 记录类型 AI_ECMP_NHOP_REC_FULL / AI_ECMP_NHOP_REC_DELTA */
+    WORD32 dwEntryNum;       /* 记录头后紧接的表项数 */
+} T_AI_ECMP_NHOP_BATCH_REC;
+
+/* 批量SG配置标志 */
+const WORD32 AI_ECMP_SG_BATCH_DELETE = 0x00000001;     /* 删除批量中的SG（未设置时新增或更新） */
+const WORD32 AI_ECMP_SG_BATCH_VERBOSE = 0x00000002;    /* 逐个打印SG配置详情（默认只打印一行汇总） */
+const WORD32 AI_ECMP_SG_BATCH_MORE = 0x00000004;       /* 批量消息：后续还有同一批的消息，配置先暂存，收到不带此标志的消息后整批处理 */
+
+/* 批量SG配置消息：消息头后紧接dwSgNum个T_AI_ECMP_SG_CFG；消息长度为16位，一次同步拆成多条消息时除最后一条外都带AI_ECMP_SG_BATCH_MORE */
+const WORD32 AI_ECMP_SG_BATCH_MAGIC = 0x53474254;      /* "SGBT" */
+
+typedef struct {
+    WORD32 dwMagic;          /* 批量消息标识 AI_ECMP_SG_BATCH_MAGIC */
+    WORD32 dwFlags;          /* 批量SG配置标志 AI_ECMP_SG_BATCH_* */
+    WORD32 dwSgNum;          /* 消息中的SG配置数 */
+} T_AI_ECMP_SG_BATCH_HDR;
+
+/* 批量SG配置结果 */
+typedef struct {
+    WORD32 dwCreated;        /* 新建的实例数 */
+    WORD32 dwUpdated;        /* 更新配置的实例数 */
+    WORD32 dwRemoved;        /* 删除的实例数 */
+    WORD32 dwDuplicated;     /* 批量中重复的SG配置数（同一SG以最后一个为准） */
+    WORD32 dwRejected;       /* 校验失败或实例池已满而未处理的SG配置数 */
+} T_AI_ECMP_SG_BATCH_RESULT;
+
 /* 评估指标 */
 typedef struct {
     DOUBLE upBoundGap;      /* 正偏差 */
@@ -86,6 +160,63 @@ typedef struct {
     DOUBLE balanceScore;    /* 平衡度得分 */
 } T_AI_ECMP_EVAL;
 
+/* 实例状态记录格式版本：新增字段只追加在记录末尾并递增版本，读者按wLength跳过不认识的字段 */
+const WORD16 AI_ECMP_STATUS_VERSION = 2;
+
+/* 实例状态概览（状态发布板中的一项，也是ftm_aiEcmpGetAllStatus输出的记录格式）
+ * 定长布局：字段按自然对齐排列，无填充字节，记录长度固定为72字节 */
+typedef struct {
+    WORD16 wVersion;         /* 记录格式版本 AI_ECMP_STATUS_VERSION */
+    WORD16 wLength;          /* 记录长度（字节） */
+    WORD32 dwSgId;           /* SG ifindex */
+    WORD32 dwStatus;         /* 实例状态 T_AI_ECMP_STATUS */
+    WORD32 dwItemNum;        /* 逻辑成员数 */
+    WORD32 dwPortNum;        /* 端口数 */
+    WORD32 dwCycle;          /* 监测周期数 */
+    WORD32 dwOptEnabled;     /* 优化是否启用 */
+    WORD32 dwDisabledCycles; /* 禁用期间的周期数 */
+    WORD32 dwFailures;       /* 连续调整失败次数 */
+    WORD32 dwLastOptMicros;  /* 最近一次优化算法耗时（微秒） */
+    WORD32 dwPending;        /* 是否有待配置回显确认的下一跳修改 */
+    WORD32 dwPendingSeqId;   /* 待确认修改的版本号（dwPending为0时无意义） */
+    DOUBLE avgGap;           /* 最近一次评估的平均偏差 */
+    DOUBLE totalGap;         /* 最近一次评估的总体偏差 */
+    DOUBLE balanceScore;     /* 最近一次评估的平衡度得分 */
+} T_AI_ECMP_INSTANCE_STATUS;
+
+/* 成员表变化项 */
+typedef struct {
+    WORD32 dwHashIndex;      /* 逻辑成员索引 */
+    WORD32 dwOldPortId;      /* 变化前PortId */
+    WORD32 dwNewPortId;      /* 变化后PortId */
+} T_AI_ECMP_MEMBER_CHANGE;
+
+/* 算法优化统计 */
+typedef struct {
+    WORD32 dwEvaluations;    /* 候选解评估次数（未统计时为0） */
+    WORD32 dwChangedEntries; /* 变化的逻辑成员数 */
+    DOUBLE scoreBefore;      /* 优化前平衡得分 */
+    DOUBLE scoreAfter;       /* 优化后平衡得分 */
+    WORD64 qwWorkerCpuMicros; /* 调用线程之外的工作线程消耗的CPU时间（微秒，无工作线程时为0） */
+} T_AI_ECMP_OPTIMIZE_STATS;
+
+/* 端口排空进度 */
+typedef struct {
+    BOOLEAN bActive;         /* 是否正在排空 */
+    BOOLEAN bCompleted;      /* 是否已排空完成（端口已退出优化的端口集合） */
+    WORD32 dwPortId;         /* 排空端口ID */
+    WORD32 dwStartBuckets;   /* 开始时端口上的桶数 */
+    WORD32 dwRemainBuckets;  /* 端口上剩余桶数 */
+    WORD64 qwStartLoad;      /* 开始时端口负载 */
+    WORD64 qwRemainLoad;     /* 端口上剩余负载 */
+    WORD32 dwSteps;          /* 已下发的迁移步数 */
+    WORD32 dwStalledCycles;  /* 连续受利用率上限限制未能迁移的周期数（非0表示排空停滞中） */
+    WORD32 dwRebalances;     /* 停滞期间在存活端口间下发的再均衡次数 */
+    BOOLEAN bCapOverride;    /* 操作员允许停滞时超出利用率上限 */
+    DOUBLE stepShare;        /* 每步迁移上限（开始时端口负载/桶数的比例） */
+    DOUBLE utilCap;          /* 存活端口利用率上限（相对排空后平均利用率的倍数） */
+} T_AI_ECMP_DRAIN_STATE;
+
 typedef struct 
 {
     WORD64 statCounter[AI_FCM_ECMP_MSG_ITEM_NUM];  /*当前支持智能队列数*/
@@ -52,6 +52,48 @@ VOID convertByteOrderNhopMod(T_AI_ECMP_NHOP_MODIFY& nhopMod)
     }
 }
 
+VOID convertByteOrderNhopBatch(BYTE* pMsg, WORD32 dwLen)
+{
+    // 消息按主机字节序打包，先读出记录数和各记录长度再转换
+    T_AI_ECMP_NHOP_BATCH_HDR* pHdr = reinterpret_cast<T_AI_ECMP_NHOP_BATCH_HDR*>(pMsg);
+    WORD32 dwRecordNum = pHdr->dwRecordNum;
+    pHdr->dwMagic = XOS_INVERT_WORD32(pHdr->dwMagic);
+    pHdr->dwRecordNum = XOS_INVERT_WORD32(pHdr->dwRecordNum);
+    pHdr->dwTotalLen = XOS_INVERT_WORD32(pHdr->dwTotalLen);
+
+    WORD32 dwOffset = sizeof(T_AI_ECMP_NHOP_BATCH_HDR);
+    for (WORD32 i = 0; i < dwRecordNum && dwOffset + sizeof(T_AI_ECMP_NHOP_BATCH_REC) <= dwLen; ++i)
+    {
+        T_AI_ECMP_NHOP_BATCH_REC* pRec = reinterpret_cast<T_AI_ECMP_NHOP_BATCH_REC*>(pMsg + dwOffset);
+        // 全量记录的表项为一个WORD32，增量记录的表项为（下标，端口）两个WORD32
+        WORD32 dwWordNum = pRec->dwEntryNum;
+        if (pRec->dwRecType == AI_ECMP_NHOP_REC_DELTA)
+        {
+            dwWordNum *= sizeof(T_AI_ECMP_NHOP_DELTA_ITEM) / sizeof(WORD32);
+        }
+        pRec->dwSgId = XOS_INVERT_WORD32(pRec->dwSgId);
+        pRec->dwSeqId = XOS_INVERT_WORD32(pRec->dwSeqId);
+        pRec->dwItemNum = XOS_INVERT_WORD32(pRec->dwItemNum);
+        pRec->dwRecType = XOS_INVERT_WORD32(pRec->dwRecType);
+        pRec->dwEntryNum = XOS_INVERT_WORD32(pRec->dwEntryNum);
+        dwOffset += sizeof(T_AI_ECMP_NHOP_BATCH_REC);
+
+        WORD32* pItems = reinterpret_cast<WORD32*>(pMsg + dwOffset);
+        for (WORD32 j = 0; j < dwWordNum && dwOffset + sizeof(WORD32) <= dwLen; ++j)
+        {
+            pItems[j] = XOS_INVERT_WORD32(pItems[j]);
+            dwOffset += sizeof(WORD32);
+        }
+    }
+}
+
+VOID convertByteOrderSgBatchHdr(T_AI_ECMP_SG_BATCH_HDR& batchHdr)
+{
+    batchHdr.dwMagic = XOS_INVERT_WORD32(batchHdr.dwMagic);
+    batchHdr.dwFlags = XOS_INVERT_WORD32(batchHdr.dwFlags);
+    batchHdr.dwSgNum = XOS_INVERT_WORD32(batchHdr.dwSgNum);
+}
+
 static inline void LogEcmpSgCfg(const T_AI_ECMP_SG_CFG& cfg)
 {
     /* 整体信息 */
@@ -128,6 +170,46 @@ WORD32 aiEcmpCfgCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID * pP
 }
 
 
+WORD32 aiEcmpCfgBatchCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID * pPData, BOOLEAN bSame)
+{
+    if (NULL == pMsgBody || wMsgLen < sizeof(T_AI_ECMP_SG_BATCH_HDR))
+    {
+        XOS_SysLog(LOG_EMERGENCY, "[AILP] %s: Invalid batch message, length %d\n", __FUNCTION__, wMsgLen);
+        return AI_FAILURE;
+    }
+
+    T_AI_ECMP_SG_BATCH_HDR& batchHdr = *reinterpret_cast<T_AI_ECMP_SG_BATCH_HDR*>(pMsgBody);
+    if (FALSE == bSame)
+    {
+        convertByteOrderSgBatchHdr(batchHdr);
+    }
+
+    // 消息头后紧接dwSgNum个SG配置，长度必须与配置数一致
+    const size_t expectedSize = sizeof(T_AI_ECMP_SG_BATCH_HDR) + static_cast<size_t>(batchHdr.dwSgNum) * sizeof(T_AI_ECMP_SG_CFG);
+    if (batchHdr.dwMagic != AI_ECMP_SG_BATCH_MAGIC || wMsgLen != expectedSize)
+    {
+        XOS_SysLog(LOG_EMERGENCY, "[AILP] %s: Invalid batch message, magic 0x%X, sg num %u, length %d\n",
+                   __FUNCTION__, batchHdr.dwMagic, batchHdr.dwSgNum, wMsgLen);
+        return AI_FAILURE;
+    }
+
+    // 配置原地转换字节序后交给管理器暂存，同一批的最后一条消息（不带AI_ECMP_SG_BATCH_MORE）到达后整批处理
+    T_AI_ECMP_SG_CFG* pSgCfgs = reinterpret_cast<T_AI_ECMP_SG_CFG*>(
+        static_cast<BYTE*>(pMsgBody) + sizeof(T_AI_ECMP_SG_BATCH_HDR));
+    if (FALSE == bSame)
+    {
+        for (WORD32 i = 0; i < batchHdr.dwSgNum; ++i)
+        {
+            convertByteOrderSfg(pSgCfgs[i]);
+        }
+    }
+
+    auto& aiSlbManagerSingleton = CAISlbManagerSingleton::getManagerInstance();
+    aiSlbManagerSingleton.stageSgConfigBatch(pSgCfgs, batchHdr.dwSgNum, batchHdr.dwFlags);
+    return AI_SUCCESS;
+}
+
+
 WORD32 aiEcmpStateCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID * pPData, BOOLEAN bSame)
 {
     XOS_SysLog(LOG_EMERGENCY, "[AILP] %s entered \n", __FUNCTION__);
@@ -175,7 +257,7 @@ WORD32 aiEcmpStateCallback(VOID * pArg, VOID * pMsgBody, WORD16 wMsgLen, VOID *
     // todo: 对 ecmpMsg 进行处理操作
 
     auto& aiSlbManagerSingleton = CAISlbManagerSingleton::getManagerInstance();
-    aiSlbManagerSingleton.runOptimizationCycle(ecmpMsg);  //更新计数
+    aiSlbManagerSingleton.handleCounterMessage(ecmpMsg);  //保存计数，由定时器节拍按相位分批处理
     XOS_SysLog(LOG_EMERGENCY, "[AILP] %s: Processing ECMP message data...\n", __FUNCTION__);
 
     return dwRet;
@@ -221,16 +303,19 @@ VOID aiEcmpSendNhopModify(const T_AI_ECMP_NHOP_MODIFY& input)
 }
 
 
+VOID aiEcmpSendNhopBatch(BYTE* pMsg, WORD32 dwLen)
+{
+    // 批量消息已按实际长度打包，原地转换字节序后直接发送，不再复制到固定长度缓冲区
+    convertByteOrderNhopBatch(pMsg, dwLen);
+    aiEcmpSendSynCfgToUfp(pMsg, dwLen);
+}
+
 
 VOID aiEcmpReadAction()
 {
-   // todo 执行动作
-   // runOptimizationCycle
-   // for instance 
-   //   du counter
-   //   算平衡度
-   //   runOptimizationCycle()
-   //   dilever() 
+    // 每个节拍只处理一个相位的实例：读counter、算平衡度、优化并下发
+    auto& aiSlbManagerSingleton = CAISlbManagerSingleton::getManagerInstance();
+    aiSlbManagerSingleton.runTick();
 }    
 
 
@@ -0,0 +1,93 @@
+#include "ai_ecmp_algorithm_base.hpp"
+#include "../utils/ai_ecmp_metrics.hpp"
+#include <time.h>
+
+namespace ai_ecmp {
+
+T_AI_ECMP_OPTIMIZE_STATS AlgorithmBase::optimizeInto(
+    const T_AI_ECMP_PROBLEM_VIEW& problem,
+    std::vector<WORD32>& outTable,
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) {
+
+    // 默认实现：将视图转换为容器后调用optimize
+    std::unordered_map<WORD32, WORD32> memberTable;
+    memberTable.reserve(problem.memberTable.size());
+    for (size_t i = 0; i < problem.memberTable.size(); ++i) {
+        memberTable[static_cast<WORD32>(i)] = problem.memberTable[i];
+    }
+
+    std::vector<WORD64> memberCounts(problem.memberCounts.begin(), problem.memberCounts.end());
+
+    std::unordered_map<WORD32, WORD32> portSpeeds;
+    for (size_t i = 0; i < problem.portIds.size() && i < problem.portSpeeds.size(); ++i) {
+        portSpeeds[problem.portIds[i]] = problem.portSpeeds[i];
+    }
+
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    stats.scoreBefore = utils::calculateBalanceScore(
+        utils::calculateLoadBalanceMetrics(utils::calculatePortLoads(memberTable, memberCounts), portSpeeds));
+
+    auto optimizedTable = optimize(memberTable, memberCounts, portSpeeds);
+
+    outTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+    for (const auto& entry : optimizedTable) {
+        if (entry.first < outTable.size()) {
+            outTable[entry.first] = entry.second;
+        }
+    }
+
+    // optimize不感知固定表项，固定表项保持输入值
+    for (size_t i = 0; i < problem.pinnedMask.size() && i < outTable.size(); ++i) {
+        if (problem.pinnedMask[i]) {
+            outTable[i] = problem.memberTable[i];
+        }
+    }
+
+    // optimize的搜索以固定表项可迁移为前提，恢复固定表项后须重新评分：不优于输入时保持原成员表
+    stats.scoreAfter = utils::calculateBalanceScore(
+        utils::calculateLoadBalanceMetrics(utils::calculatePortLoads(outTable, memberCounts), portSpeeds));
+    if (stats.scoreAfter <= stats.scoreBefore) {
+        outTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+        stats.scoreAfter = stats.scoreBefore;
+    }
+
+    collectMemberChanges(problem.memberTable, outTable, changes);
+    stats.dwChangedEntries = static_cast<WORD32>(changes.size());
+    return stats;
+}
+
+void AlgorithmBase::collectMemberChanges(
+    const ArrayView<WORD32>& before,
+    const std::vector<WORD32>& after,
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) {
+
+    changes.clear();
+    for (size_t i = 0; i < before.size() && i < after.size(); ++i) {
+        if (before[i] != after[i]) {
+            changes.push_back({static_cast<WORD32>(i), before[i], after[i]});
+        }
+    }
+}
+
+WORD64 AlgorithmBase::getThreadCpuMicros() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<WORD64>(ts.tv_sec) * 1000000 + static_cast<WORD64>(ts.tv_nsec) / 1000;
+}
+
+T_AI_ECMP_EVAL AlgorithmBase::evaluateBalance(
+    const std::unordered_map<WORD32, WORD32>& memberTable,
+    const std::vector<WORD64>& memberCounts,
+    const std::unordered_map<WORD32, WORD32>& portSpeeds) {
+    return utils::calculateLoadBalanceMetrics(calculatePortLoads(memberTable, memberCounts), portSpeeds);
+}
+
+std::unordered_map<WORD32, WORD64> AlgorithmBase::calculatePortLoads(
+    const std::unordered_map<WORD32, WORD32>& memberTable,
+    const std::vector<WORD64>& memberCounts) {
+    return utils::calculatePortLoads(memberTable, memberCounts);
+}
+
+} // namespace ai_ecmp
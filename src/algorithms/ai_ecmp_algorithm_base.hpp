@@ -3,30 +3,111 @@
 
 #include <unordered_map>
 #include <vector>
+#include <atomic>
+#include <chrono>
 #include "ai_ecmp_types.h"
 
 namespace ai_ecmp {
 
+/**
+ * 只读数组视图（指针 + 长度），不持有数据
+ */
+template <typename T>
+class ArrayView {
+public:
+    ArrayView() : m_pData(nullptr), m_size(0) {}
+    ArrayView(const T* pData, size_t size) : m_pData(pData), m_size(size) {}
+    ArrayView(const std::vector<T>& values) : m_pData(values.data()), m_size(values.size()) {}
+
+    const T& operator[](size_t index) const { return m_pData[index]; }
+    const T* data() const { return m_pData; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const T* begin() const { return m_pData; }
+    const T* end() const { return m_pData + m_size; }
+
+private:
+    const T* m_pData;
+    size_t m_size;
+};
+
+/**
+ * 优化问题只读视图
+ * 成员表以hash_index为下标；端口信息为两个等长数组
+ */
+typedef struct {
+    ArrayView<WORD32> memberTable;   /* 成员表 (hash_index -> portId) */
+    ArrayView<WORD64> memberCounts;  /* 成员计数表 (hash_index -> count) */
+    ArrayView<WORD32> portIds;       /* 端口ID数组 */
+    ArrayView<WORD32> portSpeeds;    /* 端口速率数组，与portIds等长同序 */
+    ArrayView<BYTE>   pinnedMask;    /* 固定表项掩码（hash_index -> 非0表示不可迁移），为空表示无固定表项 */
+} T_AI_ECMP_PROBLEM_VIEW;
+
 /**
  * 算法基类，定义通用接口
  */
 class AlgorithmBase {
 public:
     virtual ~AlgorithmBase() = default;
-    
+
     /**
      * 运行算法优化
      * @param memberTable 成员表 (hash_index -> portId)
      * @param memberCounts 成员计数表(hash_index -> count)
      * @param portSpeeds 端口速率表(portId -> speed)
-     * @return 优化后的成员表(hash_index -> portId) 
+     * @return 优化后的成员表(hash_index -> portId)
      */
     virtual std::unordered_map<WORD32, WORD32> optimize(
         const std::unordered_map<WORD32, WORD32>& memberTable,
         const std::vector<WORD64>& memberCounts,
         const std::unordered_map<WORD32, WORD32>& portSpeeds) = 0;
-    
-    /** 
+
+    /**
+     * @brief 运行算法优化（零拷贝接口）
+     * 结果写入调用方持有的缓冲区，缓冲区在多次调用间复用，稳态下不产生内存分配。
+     * 默认实现转换为容器后调用optimize，固定表项在结果中恢复为输入值后重新评分，不优于输入时保持原成员表；
+     * 算法可重写以直接在视图上工作并在搜索中排除固定表项
+     * @param problem 优化问题只读视图
+     * @param outTable 输出参数，优化后的成员表（以hash_index为下标，长度与输入成员表相同）
+     * @param changes 输出参数，相对输入成员表变化的表项（先清空）
+     * @return 优化统计
+     */
+    virtual T_AI_ECMP_OPTIMIZE_STATS optimizeInto(
+        const T_AI_ECMP_PROBLEM_VIEW& problem,
+        std::vector<WORD32>& outTable,
+        std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes);
+
+    /**
+     * @brief 对比输入成员表与输出成员表，生成变化列表
+     * @param before 输入成员表
+     * @param after 输出成员表
+     * @param changes 输出参数，变化列表（先清空）
+     */
+    static void collectMemberChanges(
+        const ArrayView<WORD32>& before,
+        const std::vector<WORD32>& after,
+        std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes);
+
+    /**
+     * @brief 获取当前线程已消耗的CPU时间（用于统计算法的CPU开销，不受并发线程数和调度等待影响）
+     * @return CPU时间(微秒)
+     */
+    static WORD64 getThreadCpuMicros();
+
+    /**
+     * @brief 获取算法名称（用于日志和报告）
+     * @return 算法名称
+     */
+    virtual const char* getName() const { return "Unknown"; }
+
+    /**
+     * @brief 设置搜索参数（在线调优使用），不支持的算法忽略
+     * @param dwMaxIterations 最大迭代次数
+     * @param exchangeCostFactor 交换代价因子
+     */
+    virtual void setSearchParameters(WORD32 /*dwMaxIterations*/, double /*exchangeCostFactor*/) {}
+
+    /**
      * 计算负载分布指标
      * @param memberTable 成员表(hash_index -> portId)
      * @param memberCounts 成员计数表(hash_index -> count)
@@ -37,17 +118,77 @@ public:
         const std::unordered_map<WORD32, WORD32>& memberTable,
         const std::vector<WORD64>& memberCounts,
         const std::unordered_map<WORD32, WORD32>& portSpeeds);
-    
+
+    // ===== 新增：协作式停止控制（供组合优化器并发竞速使用） =====
+    /**
+     * @brief 请求算法尽快停止，算法在下一次检查点返回当前最优解
+     */
+    void requestStop() { m_bStopRequested.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 设置本次优化的截止时间
+     * @param deadline 截止时间点
+     */
+    void setDeadline(const std::chrono::steady_clock::time_point& deadline) {
+        m_deadline = deadline;
+        m_bHasDeadline = true;
+    }
+
+    /**
+     * @brief 设置目标得分，算法达到该得分后即可提前结束
+     * @param targetScore 目标平衡得分（越大越好）
+     */
+    void setTargetScore(double targetScore) {
+        m_targetScore = targetScore;
+        m_bHasTargetScore = true;
+    }
+
+    /**
+     * @brief 清除停止请求、截止时间和目标得分，恢复为无约束运行
+     */
+    void clearRunLimits() {
+        m_bStopRequested.store(false, std::memory_order_relaxed);
+        m_bHasDeadline = false;
+        m_bHasTargetScore = false;
+    }
+
 protected:
     /**
      * 计算端口负载
-     * @param memberTable 成员表(hash_index -> portId) 
+     * @param memberTable 成员表(hash_index -> portId)
      * @param memberCounts 成员计数表(hash_index -> count)
      * @return 端口负载表(portId -> load)
      */
     std::unordered_map<WORD32, WORD64> calculatePortLoads(
         const std::unordered_map<WORD32, WORD32>& memberTable,
         const std::vector<WORD64>& memberCounts);
+
+    /**
+     * @brief 检查是否应当停止迭代（收到停止请求或已过截止时间）
+     * @return true表示应当停止
+     */
+    bool shouldStop() const {
+        if (m_bStopRequested.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return m_bHasDeadline && std::chrono::steady_clock::now() >= m_deadline;
+    }
+
+    /**
+     * @brief 检查得分是否已达到目标得分
+     * @param score 当前平衡得分
+     * @return true表示已达到目标
+     */
+    bool reachedTargetScore(double score) const {
+        return m_bHasTargetScore && score >= m_targetScore;
+    }
+
+private:
+    std::atomic<bool> m_bStopRequested{false};
+    bool m_bHasDeadline = false;
+    std::chrono::steady_clock::time_point m_deadline;
+    bool m_bHasTargetScore = false;
+    double m_targetScore = 0.0;
 };
 
 } // namespace ai_ecmp
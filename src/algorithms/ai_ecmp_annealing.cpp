@@ -0,0 +1,239 @@
+#include "ai_ecmp_annealing.hpp"
+#include "../utils/ai_ecmp_metrics.hpp"
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+namespace ai_ecmp {
+
+SimulatedAnnealing::SimulatedAnnealing(WORD32 dwMaxIterations,
+                                       double initialTemperature,
+                                       double coolingRate)
+    : m_dwMaxIterations(dwMaxIterations)
+    , m_initialTemperature(initialTemperature)
+    , m_coolingRate(coolingRate) {
+}
+
+std::unordered_map<WORD32, WORD32> SimulatedAnnealing::optimize(
+    const std::unordered_map<WORD32, WORD32>& memberTable,
+    const std::vector<WORD64>& memberCounts,
+    const std::unordered_map<WORD32, WORD32>& portSpeeds) {
+
+    XOS_SysLog(LOG_EMERGENCY, "[Annealing] 开始模拟退火优化，最大迭代次数: %u，初始温度: %.6f，降温系数: %.6f\n",
+                  m_dwMaxIterations, m_initialTemperature, m_coolingRate);
+
+    std::unordered_map<WORD32, WORD32> current = memberTable;
+
+    std::vector<WORD32> hashIndices;
+    hashIndices.reserve(memberTable.size());
+    for (const auto& entry : memberTable) {
+        hashIndices.push_back(entry.first);
+    }
+
+    if (hashIndices.size() < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[Annealing] 哈希索引数量不足(%zu < 2)，无法进行交换优化\n", hashIndices.size());
+        return current;
+    }
+
+    std::random_device randomDevice;
+    std::mt19937 randomGenerator(randomDevice());
+    std::uniform_int_distribution<size_t> indexDistribution(0, hashIndices.size() - 1);
+    std::uniform_real_distribution<double> probDistribution(0.0, 1.0);
+
+    auto portLoads = utils::calculatePortLoads(current, memberCounts);
+    double currentScore = utils::calculateBalanceScore(
+        utils::calculateLoadBalanceMetrics(portLoads, portSpeeds));
+    const double originalScore = currentScore;
+
+    auto bestResult = current;
+    double bestScore = currentScore;
+
+    double temperature = m_initialTemperature;
+    WORD32 dwIterations = 0;
+    WORD32 dwAcceptedSwaps = 0;
+    WORD32 dwUphillSwaps = 0;
+
+    while (dwIterations < m_dwMaxIterations) {
+        if (shouldStop() || reachedTargetScore(bestScore)) {
+            break;
+        }
+        dwIterations++;
+
+        size_t idx1 = indexDistribution(randomGenerator);
+        size_t idx2 = indexDistribution(randomGenerator);
+        if (idx1 == idx2) {
+            continue;
+        }
+
+        WORD32 dwHashIndex1 = hashIndices[idx1];
+        WORD32 dwHashIndex2 = hashIndices[idx2];
+        WORD32 dwPortId1 = current[dwHashIndex1];
+        WORD32 dwPortId2 = current[dwHashIndex2];
+        if (dwPortId1 == dwPortId2) {
+            continue;
+        }
+
+        double delta = utils::calculateSwapImprovement(
+            current, memberCounts, portLoads, portSpeeds, dwHashIndex1, dwHashIndex2);
+
+        // Metropolis准则：改进则接受，变差则以 exp(delta/T) 的概率接受
+        bool bAccept = delta > 0;
+        if (!bAccept && temperature > 0) {
+            bAccept = probDistribution(randomGenerator) < std::exp(delta / temperature);
+            if (bAccept) {
+                dwUphillSwaps++;
+            }
+        }
+
+        if (bAccept) {
+            WORD64 count1 = dwHashIndex1 < memberCounts.size() ? memberCounts[dwHashIndex1] : 0;
+            WORD64 count2 = dwHashIndex2 < memberCounts.size() ? memberCounts[dwHashIndex2] : 0;
+
+            portLoads[dwPortId1] = portLoads[dwPortId1] - count1 + count2;
+            portLoads[dwPortId2] = portLoads[dwPortId2] - count2 + count1;
+            current[dwHashIndex1] = dwPortId2;
+            current[dwHashIndex2] = dwPortId1;
+            currentScore += delta;
+            dwAcceptedSwaps++;
+
+            if (currentScore > bestScore) {
+                bestScore = currentScore;
+                bestResult = current;
+            }
+        }
+
+        temperature *= m_coolingRate;
+    }
+
+    XOS_SysLog(LOG_EMERGENCY, "[Annealing] 模拟退火完成 - 迭代: %u/%u, 接受交换: %u (其中变差接受: %u), 得分: %.6f -> %.6f\n",
+                  dwIterations, m_dwMaxIterations, dwAcceptedSwaps, dwUphillSwaps, originalScore, bestScore);
+
+    return bestResult;
+}
+
+struct SimulatedAnnealing::ViewRunner {
+    SimulatedAnnealing* pSelf;
+    const T_AI_ECMP_PROBLEM_VIEW& view;
+    std::vector<WORD32>& outTable;
+    T_AI_ECMP_OPTIMIZE_STATS& stats;
+
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    void operator()(kernels::CapacityTag<MAX_ITEMS, MAX_PORTS>) {
+        kernels::DenseProblem<MAX_ITEMS, MAX_PORTS> problem;
+        if (!kernels::buildDenseProblem(
+                view.memberTable.data(), static_cast<WORD32>(view.memberTable.size()),
+                view.memberCounts.data(), static_cast<WORD32>(view.memberCounts.size()),
+                view.portIds.data(), view.portSpeeds.data(),
+                static_cast<WORD32>(std::min(view.portIds.size(), view.portSpeeds.size())),
+                problem,
+                view.pinnedMask.size() >= view.memberTable.size() ? view.pinnedMask.data() : nullptr)) {
+            XOS_SysLog(LOG_EMERGENCY, "[Annealing] 稠密问题构建失败（容量: %u），保持原成员表\n", MAX_ITEMS);
+            return;
+        }
+        stats = pSelf->searchDense(problem);
+        kernels::writeBackMemberTable(problem, outTable);
+    }
+};
+
+T_AI_ECMP_OPTIMIZE_STATS SimulatedAnnealing::optimizeInto(
+    const T_AI_ECMP_PROBLEM_VIEW& problem,
+    std::vector<WORD32>& outTable,
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) {
+
+    XOS_SysLog(LOG_EMERGENCY, "[Annealing] 开始模拟退火优化（视图接口），最大迭代次数: %u，初始温度: %.6f，降温系数: %.6f\n",
+                  m_dwMaxIterations, m_initialTemperature, m_coolingRate);
+
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    outTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+    changes.clear();
+
+    ViewRunner runner = {this, problem, outTable, stats};
+    WORD32 dwItemNum = static_cast<WORD32>(problem.memberTable.size());
+    if (dwItemNum < 2 || !kernels::dispatchByCapacity(dwItemNum, dwItemNum, runner)) {
+        XOS_SysLog(LOG_EMERGENCY, "[Annealing] 成员表规模(%u)不足或超出内核容量，保持原成员表\n", dwItemNum);
+        return stats;
+    }
+
+    collectMemberChanges(problem.memberTable, outTable, changes);
+    stats.dwChangedEntries = static_cast<WORD32>(changes.size());
+    return stats;
+}
+
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+T_AI_ECMP_OPTIMIZE_STATS SimulatedAnnealing::searchDense(kernels::DenseProblem<MAX_ITEMS, MAX_PORTS>& problem) {
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    double currentScore = utils::calculateBalanceScore(kernels::evaluateProblem(problem));
+    stats.scoreBefore = currentScore;
+    stats.scoreAfter = currentScore;
+    if (problem.dwItemNum < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[Annealing] 可交换表项数量不足(%u < 2)，无法进行交换优化\n", problem.dwItemNum);
+        return stats;
+    }
+
+    std::random_device randomDevice;
+    std::mt19937 randomGenerator(randomDevice());
+    std::uniform_int_distribution<WORD32> indexDistribution(0, problem.dwItemNum - 1);
+    std::uniform_real_distribution<double> probDistribution(0.0, 1.0);
+
+    // 最优解（成员表及端口负载）保存在栈上，结束时恢复到稠密问题
+    BYTE abyBestPort[MAX_ITEMS];
+    WORD64 aqwBestLoads[MAX_PORTS];
+    std::copy(problem.abyMemberPort, problem.abyMemberPort + problem.dwItemNum, abyBestPort);
+    std::copy(problem.aqwLoads, problem.aqwLoads + problem.dwPortNum, aqwBestLoads);
+    double bestScore = currentScore;
+
+    double temperature = m_initialTemperature;
+    WORD32 dwIterations = 0;
+    WORD32 dwAcceptedSwaps = 0;
+    WORD32 dwUphillSwaps = 0;
+
+    while (dwIterations < m_dwMaxIterations) {
+        if (shouldStop() || reachedTargetScore(bestScore)) {
+            break;
+        }
+        dwIterations++;
+
+        WORD32 dwSlot1 = indexDistribution(randomGenerator);
+        WORD32 dwSlot2 = indexDistribution(randomGenerator);
+        if (dwSlot1 == dwSlot2 || problem.abyMemberPort[dwSlot1] == problem.abyMemberPort[dwSlot2]) {
+            continue;
+        }
+        stats.dwEvaluations++;
+
+        double delta = kernels::evaluateSwap(problem, currentScore, dwSlot1, dwSlot2);
+
+        // Metropolis准则：改进则接受，变差则以 exp(delta/T) 的概率接受
+        bool bAccept = delta > 0;
+        if (!bAccept && temperature > 0) {
+            bAccept = probDistribution(randomGenerator) < std::exp(delta / temperature);
+            if (bAccept) {
+                dwUphillSwaps++;
+            }
+        }
+
+        if (bAccept) {
+            kernels::applySwap(problem, dwSlot1, dwSlot2);
+            currentScore += delta;
+            dwAcceptedSwaps++;
+
+            if (currentScore > bestScore) {
+                bestScore = currentScore;
+                std::copy(problem.abyMemberPort, problem.abyMemberPort + problem.dwItemNum, abyBestPort);
+                std::copy(problem.aqwLoads, problem.aqwLoads + problem.dwPortNum, aqwBestLoads);
+            }
+        }
+
+        temperature *= m_coolingRate;
+    }
+
+    std::copy(abyBestPort, abyBestPort + problem.dwItemNum, problem.abyMemberPort);
+    std::copy(aqwBestLoads, aqwBestLoads + problem.dwPortNum, problem.aqwLoads);
+
+    XOS_SysLog(LOG_EMERGENCY, "[Annealing] 模拟退火完成 - 迭代: %u/%u, 接受交换: %u (其中变差接受: %u), 得分: %.6f -> %.6f\n",
+                  dwIterations, m_dwMaxIterations, dwAcceptedSwaps, dwUphillSwaps, stats.scoreBefore, bestScore);
+
+    stats.scoreAfter = bestScore;
+    return stats;
+}
+
+} // namespace ai_ecmp
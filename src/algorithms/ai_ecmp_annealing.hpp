@@ -0,0 +1,67 @@
+#ifndef AI_ECMP_ANNEALING_HPP
+#define AI_ECMP_ANNEALING_HPP
+
+#include "ai_ecmp_algorithm_base.hpp"
+#include "../utils/ai_ecmp_kernels.hpp"
+
+namespace ai_ecmp {
+
+/**
+ * 模拟退火算法实现
+ * 与局部搜索相同只做哈希索引交换（保持各端口逻辑成员数不变），
+ * 但以一定概率接受变差的交换，以跳出局部最优
+ */
+class SimulatedAnnealing : public AlgorithmBase {
+public:
+    /**
+     * 构造函数
+     * @param dwMaxIterations 最大迭代次数
+     * @param initialTemperature 初始温度（与得分同量纲）
+     * @param coolingRate 每次迭代的降温系数 (0,1)
+     */
+    SimulatedAnnealing(WORD32 dwMaxIterations = 20000,
+                       double initialTemperature = 0.05,
+                       double coolingRate = 0.9995);
+
+    /**
+     * 运行算法优化
+     * @param memberTable 成员表 (hash_index -> portId)
+     * @param memberCounts 成员计数表
+     * @param portSpeeds 端口速率表
+     * @return 优化后的成员表（搜索过程中的最优解）
+     */
+    std::unordered_map<WORD32, WORD32> optimize(
+        const std::unordered_map<WORD32, WORD32>& memberTable,
+        const std::vector<WORD64>& memberCounts,
+        const std::unordered_map<WORD32, WORD32>& portSpeeds) override;
+
+    /**
+     * 运行算法优化（零拷贝接口），在定长稠密问题上退火，固定表项不参与交换
+     */
+    T_AI_ECMP_OPTIMIZE_STATS optimizeInto(
+        const T_AI_ECMP_PROBLEM_VIEW& problem,
+        std::vector<WORD32>& outTable,
+        std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) override;
+
+    const char* getName() const override { return "Annealing"; }
+
+private:
+    WORD32 m_dwMaxIterations;    // 最大迭代次数
+    double m_initialTemperature; // 初始温度
+    double m_coolingRate;        // 降温系数
+
+    // 按容量档位分派到定长内核的访问者（视图输入）
+    struct ViewRunner;
+
+    /**
+     * @brief 定长稠密内核上的退火主循环，搜索过程中的最优解保留在稠密问题中
+     * @param problem 稠密问题
+     * @return 优化统计（不含变化表项数）
+     */
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    T_AI_ECMP_OPTIMIZE_STATS searchDense(kernels::DenseProblem<MAX_ITEMS, MAX_PORTS>& problem);
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_ANNEALING_HPP */
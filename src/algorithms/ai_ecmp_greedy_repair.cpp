@@ -0,0 +1,274 @@
+#include "ai_ecmp_greedy_repair.hpp"
+#include "../utils/ai_ecmp_metrics.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace ai_ecmp {
+
+GreedyRepair::GreedyRepair(WORD32 dwMaxRepairPasses)
+    : m_dwMaxRepairPasses(dwMaxRepairPasses) {
+}
+
+std::unordered_map<WORD32, WORD32> GreedyRepair::optimize(
+    const std::unordered_map<WORD32, WORD32>& memberTable,
+    const std::vector<WORD64>& memberCounts,
+    const std::unordered_map<WORD32, WORD32>& portSpeeds) {
+
+    XOS_SysLog(LOG_EMERGENCY, "[GreedyRepair] 开始构造+修复优化，最大修复轮数: %u\n", m_dwMaxRepairPasses);
+
+    if (memberTable.size() < 2) {
+        return memberTable;
+    }
+
+    // ===== 构造阶段 =====
+    // 统计各端口的逻辑成员数（空位数），构造解保持该分布不变
+    std::unordered_map<WORD32, WORD32> portSlots;
+    for (const auto& entry : memberTable) {
+        portSlots[entry.second]++;
+    }
+
+    std::vector<WORD32> hashIndices;
+    hashIndices.reserve(memberTable.size());
+    for (const auto& entry : memberTable) {
+        hashIndices.push_back(entry.first);
+    }
+
+    auto countOf = [&memberCounts](WORD32 dwHashIndex) -> WORD64 {
+        return dwHashIndex < memberCounts.size() ? memberCounts[dwHashIndex] : 0;
+    };
+
+    // 按流量降序排列（LPT），流量相同时按索引保证结果确定
+    std::sort(hashIndices.begin(), hashIndices.end(), [&countOf](WORD32 a, WORD32 b) {
+        WORD64 countA = countOf(a);
+        WORD64 countB = countOf(b);
+        return countA != countB ? countA > countB : a < b;
+    });
+
+    std::unordered_map<WORD32, WORD32> result;
+    std::unordered_map<WORD32, WORD64> portLoads;
+    for (const auto& slotEntry : portSlots) {
+        portLoads[slotEntry.first] = 0;
+    }
+
+    for (WORD32 dwHashIndex : hashIndices) {
+        WORD64 count = countOf(dwHashIndex);
+        WORD32 dwCurrentPort = memberTable.at(dwHashIndex);
+        WORD32 dwBestPort = dwCurrentPort;
+        double bestUtil = -1.0;
+
+        for (const auto& slotEntry : portSlots) {
+            if (slotEntry.second == 0) {
+                continue;
+            }
+            WORD32 dwPortId = slotEntry.first;
+            auto speedIt = portSpeeds.find(dwPortId);
+            double speed = (speedIt != portSpeeds.end() && speedIt->second > 0) ? speedIt->second : 1.0;
+            double util = static_cast<double>(portLoads[dwPortId] + count) / speed;
+
+            // 利用率相同时优先保持原端口，减少流迁移
+            if (bestUtil < 0 || util < bestUtil ||
+                (util == bestUtil && dwPortId == dwCurrentPort)) {
+                bestUtil = util;
+                dwBestPort = dwPortId;
+            }
+        }
+
+        result[dwHashIndex] = dwBestPort;
+        portLoads[dwBestPort] += count;
+        portSlots[dwBestPort]--;
+    }
+
+    double constructedScore = utils::calculateBalanceScore(
+        utils::calculateLoadBalanceMetrics(portLoads, portSpeeds));
+
+    // ===== 修复阶段：最优改进交换下降 =====
+    WORD32 dwPasses = 0;
+    WORD32 dwRepairSwaps = 0;
+    double currentScore = constructedScore;
+
+    while (dwPasses < m_dwMaxRepairPasses && !shouldStop() && !reachedTargetScore(currentScore)) {
+        dwPasses++;
+
+        double bestImprovement = 0.0;
+        WORD32 dwBestIndex1 = 0;
+        WORD32 dwBestIndex2 = 0;
+
+        for (size_t i = 0; i < hashIndices.size(); ++i) {
+            for (size_t j = i + 1; j < hashIndices.size(); ++j) {
+                double improvement = utils::calculateSwapImprovement(
+                    result, memberCounts, portLoads, portSpeeds, hashIndices[i], hashIndices[j]);
+                if (improvement > bestImprovement) {
+                    bestImprovement = improvement;
+                    dwBestIndex1 = hashIndices[i];
+                    dwBestIndex2 = hashIndices[j];
+                }
+            }
+        }
+
+        if (bestImprovement <= 0.0) {
+            break;
+        }
+
+        WORD32 dwPortId1 = result[dwBestIndex1];
+        WORD32 dwPortId2 = result[dwBestIndex2];
+        WORD64 count1 = countOf(dwBestIndex1);
+        WORD64 count2 = countOf(dwBestIndex2);
+
+        portLoads[dwPortId1] = portLoads[dwPortId1] - count1 + count2;
+        portLoads[dwPortId2] = portLoads[dwPortId2] - count2 + count1;
+        result[dwBestIndex1] = dwPortId2;
+        result[dwBestIndex2] = dwPortId1;
+        currentScore += bestImprovement;
+        dwRepairSwaps++;
+    }
+
+    XOS_SysLog(LOG_EMERGENCY, "[GreedyRepair] 构造+修复完成 - 构造得分: %.6f, 修复轮数: %u, 修复交换: %u, 最终得分: %.6f\n",
+                  constructedScore, dwPasses, dwRepairSwaps, currentScore);
+
+    return result;
+}
+
+struct GreedyRepair::ViewRunner {
+    GreedyRepair* pSelf;
+    const T_AI_ECMP_PROBLEM_VIEW& view;
+    std::vector<WORD32>& outTable;
+    T_AI_ECMP_OPTIMIZE_STATS& stats;
+
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    void operator()(kernels::CapacityTag<MAX_ITEMS, MAX_PORTS>) {
+        kernels::DenseProblem<MAX_ITEMS, MAX_PORTS> problem;
+        if (!kernels::buildDenseProblem(
+                view.memberTable.data(), static_cast<WORD32>(view.memberTable.size()),
+                view.memberCounts.data(), static_cast<WORD32>(view.memberCounts.size()),
+                view.portIds.data(), view.portSpeeds.data(),
+                static_cast<WORD32>(std::min(view.portIds.size(), view.portSpeeds.size())),
+                problem,
+                view.pinnedMask.size() >= view.memberTable.size() ? view.pinnedMask.data() : nullptr)) {
+            XOS_SysLog(LOG_EMERGENCY, "[GreedyRepair] 稠密问题构建失败（容量: %u），保持原成员表\n", MAX_ITEMS);
+            return;
+        }
+        stats = pSelf->searchDense(problem);
+        kernels::writeBackMemberTable(problem, outTable);
+    }
+};
+
+T_AI_ECMP_OPTIMIZE_STATS GreedyRepair::optimizeInto(
+    const T_AI_ECMP_PROBLEM_VIEW& problem,
+    std::vector<WORD32>& outTable,
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) {
+
+    XOS_SysLog(LOG_EMERGENCY, "[GreedyRepair] 开始构造+修复优化（视图接口），最大修复轮数: %u\n", m_dwMaxRepairPasses);
+
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    outTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+    changes.clear();
+
+    ViewRunner runner = {this, problem, outTable, stats};
+    WORD32 dwItemNum = static_cast<WORD32>(problem.memberTable.size());
+    if (dwItemNum < 2 || !kernels::dispatchByCapacity(dwItemNum, dwItemNum, runner)) {
+        XOS_SysLog(LOG_EMERGENCY, "[GreedyRepair] 成员表规模(%u)不足或超出内核容量，保持原成员表\n", dwItemNum);
+        return stats;
+    }
+
+    collectMemberChanges(problem.memberTable, outTable, changes);
+    stats.dwChangedEntries = static_cast<WORD32>(changes.size());
+    return stats;
+}
+
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+T_AI_ECMP_OPTIMIZE_STATS GreedyRepair::searchDense(kernels::DenseProblem<MAX_ITEMS, MAX_PORTS>& problem) {
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    stats.scoreBefore = utils::calculateBalanceScore(kernels::evaluateProblem(problem));
+    stats.scoreAfter = stats.scoreBefore;
+    if (problem.dwItemNum < 2) {
+        return stats;
+    }
+
+    // ===== 构造阶段 =====
+    // 各端口的空位数为可重排表项占用的逻辑成员数；初始负载只含固定表项
+    WORD32 adwSlots[MAX_PORTS] = {0};
+    BYTE abyOriginalPort[MAX_ITEMS];
+    std::copy(problem.abyMemberPort, problem.abyMemberPort + problem.dwItemNum, abyOriginalPort);
+    for (WORD32 i = 0; i < problem.dwItemNum; ++i) {
+        adwSlots[problem.abyMemberPort[i]]++;
+        problem.aqwLoads[problem.abyMemberPort[i]] -= problem.aqwCounts[i];
+    }
+
+    // 按流量降序排列（LPT），流量相同时按索引保证结果确定
+    WORD32 adwOrder[MAX_ITEMS];
+    for (WORD32 i = 0; i < problem.dwItemNum; ++i) {
+        adwOrder[i] = i;
+    }
+    std::sort(adwOrder, adwOrder + problem.dwItemNum, [&problem](WORD32 a, WORD32 b) {
+        return problem.aqwCounts[a] != problem.aqwCounts[b] ? problem.aqwCounts[a] > problem.aqwCounts[b]
+                                                            : problem.adwHashIndex[a] < problem.adwHashIndex[b];
+    });
+
+    for (WORD32 n = 0; n < problem.dwItemNum; ++n) {
+        const WORD32 dwSlot = adwOrder[n];
+        const WORD64 qwCount = problem.aqwCounts[dwSlot];
+        BYTE byBestPort = abyOriginalPort[dwSlot];
+        double bestUtil = -1.0;
+        for (WORD32 p = 0; p < problem.dwPortNum; ++p) {
+            if (adwSlots[p] == 0) {
+                continue;
+            }
+            // 速率未知的端口按速率1计算，与容器接口一致
+            const double invSpeed = problem.adInvSpeeds[p] > 0 ? problem.adInvSpeeds[p] : 1.0;
+            const double util = static_cast<double>(problem.aqwLoads[p] + qwCount) * invSpeed;
+            // 利用率相同时优先保持原端口，减少流迁移
+            if (bestUtil < 0 || util < bestUtil || (util == bestUtil && p == abyOriginalPort[dwSlot])) {
+                bestUtil = util;
+                byBestPort = static_cast<BYTE>(p);
+            }
+        }
+        problem.abyMemberPort[dwSlot] = byBestPort;
+        problem.aqwLoads[byBestPort] += qwCount;
+        adwSlots[byBestPort]--;
+    }
+
+    const double constructedScore = utils::calculateBalanceScore(kernels::evaluateProblem(problem));
+
+    // ===== 修复阶段：最优改进交换下降 =====
+    WORD32 dwPasses = 0;
+    WORD32 dwRepairSwaps = 0;
+    double currentScore = constructedScore;
+
+    while (dwPasses < m_dwMaxRepairPasses && !shouldStop() && !reachedTargetScore(currentScore)) {
+        dwPasses++;
+
+        double bestImprovement = 0.0;
+        WORD32 dwBestSlot1 = 0;
+        WORD32 dwBestSlot2 = 0;
+        for (WORD32 i = 0; i < problem.dwItemNum; ++i) {
+            for (WORD32 j = i + 1; j < problem.dwItemNum; ++j) {
+                if (problem.abyMemberPort[i] == problem.abyMemberPort[j]) {
+                    continue;
+                }
+                stats.dwEvaluations++;
+                double improvement = kernels::evaluateSwap(problem, currentScore, i, j);
+                if (improvement > bestImprovement) {
+                    bestImprovement = improvement;
+                    dwBestSlot1 = i;
+                    dwBestSlot2 = j;
+                }
+            }
+        }
+
+        if (bestImprovement <= 0.0) {
+            break;
+        }
+
+        kernels::applySwap(problem, dwBestSlot1, dwBestSlot2);
+        currentScore += bestImprovement;
+        dwRepairSwaps++;
+    }
+
+    XOS_SysLog(LOG_EMERGENCY, "[GreedyRepair] 构造+修复完成 - 构造得分: %.6f, 修复轮数: %u, 修复交换: %u, 最终得分: %.6f\n",
+                  constructedScore, dwPasses, dwRepairSwaps, currentScore);
+
+    stats.scoreAfter = currentScore;
+    return stats;
+}
+
+} // namespace ai_ecmp
@@ -0,0 +1,63 @@
+#ifndef AI_ECMP_GREEDY_REPAIR_HPP
+#define AI_ECMP_GREEDY_REPAIR_HPP
+
+#include "ai_ecmp_algorithm_base.hpp"
+#include "../utils/ai_ecmp_kernels.hpp"
+
+namespace ai_ecmp {
+
+/**
+ * 构造+修复算法实现
+ * 构造阶段：按流量降序将哈希桶分配给归一化负载最小且仍有空位的端口
+ *           （各端口逻辑成员数保持不变，仅重新排列）；
+ * 修复阶段：在构造解上执行最优改进交换下降，直至无改进或达到轮数上限
+ */
+class GreedyRepair : public AlgorithmBase {
+public:
+    /**
+     * 构造函数
+     * @param dwMaxRepairPasses 修复阶段最大轮数（每轮执行一次最优交换）
+     */
+    explicit GreedyRepair(WORD32 dwMaxRepairPasses = 32);
+
+    /**
+     * 运行算法优化
+     * @param memberTable 成员表 (hash_index -> portId)
+     * @param memberCounts 成员计数表
+     * @param portSpeeds 端口速率表
+     * @return 优化后的成员表
+     */
+    std::unordered_map<WORD32, WORD32> optimize(
+        const std::unordered_map<WORD32, WORD32>& memberTable,
+        const std::vector<WORD64>& memberCounts,
+        const std::unordered_map<WORD32, WORD32>& portSpeeds) override;
+
+    /**
+     * 运行算法优化（零拷贝接口），在定长稠密问题上构造和修复，
+     * 固定表项不参与重新排列，其负载作为构造阶段各端口的初始负载
+     */
+    T_AI_ECMP_OPTIMIZE_STATS optimizeInto(
+        const T_AI_ECMP_PROBLEM_VIEW& problem,
+        std::vector<WORD32>& outTable,
+        std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) override;
+
+    const char* getName() const override { return "GreedyRepair"; }
+
+private:
+    WORD32 m_dwMaxRepairPasses; // 修复阶段最大轮数
+
+    // 按容量档位分派到定长内核的访问者（视图输入）
+    struct ViewRunner;
+
+    /**
+     * @brief 定长稠密内核上的构造+修复，结果保留在稠密问题中
+     * @param problem 稠密问题
+     * @return 优化统计（不含变化表项数）
+     */
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    T_AI_ECMP_OPTIMIZE_STATS searchDense(kernels::DenseProblem<MAX_ITEMS, MAX_PORTS>& problem);
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_GREEDY_REPAIR_HPP */
@@ -14,6 +14,50 @@ LocalSearch::LocalSearch(WORD32 dwMaxIterations, double exchangeCostFactor)
     , m_exchangeCostFactor(exchangeCostFactor) {
 }
 
+struct LocalSearch::MapRunner {
+    LocalSearch* pSelf;
+    const std::unordered_map<WORD32, WORD32>& memberTable;
+    const std::vector<WORD64>& memberCounts;
+    const std::unordered_map<WORD32, WORD32>& portSpeeds;
+    std::unordered_map<WORD32, WORD32>& result;
+
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    void operator()(kernels::CapacityTag<MAX_ITEMS, MAX_PORTS>) {
+        // 稠密问题驻留在栈上，成员表、计数和端口负载均为定长数组
+        kernels::DenseProblem<MAX_ITEMS, MAX_PORTS> problem;
+        if (!kernels::buildDenseProblem(memberTable, memberCounts, portSpeeds, problem)) {
+            XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 稠密问题构建失败（容量: %u），保持原成员表\n", MAX_ITEMS);
+            return;
+        }
+        pSelf->searchDense(problem);
+        kernels::writeBackMemberTable(problem, result);
+    }
+};
+
+struct LocalSearch::ViewRunner {
+    LocalSearch* pSelf;
+    const T_AI_ECMP_PROBLEM_VIEW& view;
+    std::vector<WORD32>& outTable;
+    T_AI_ECMP_OPTIMIZE_STATS& stats;
+
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    void operator()(kernels::CapacityTag<MAX_ITEMS, MAX_PORTS>) {
+        kernels::DenseProblem<MAX_ITEMS, MAX_PORTS> problem;
+        if (!kernels::buildDenseProblem(
+                view.memberTable.data(), static_cast<WORD32>(view.memberTable.size()),
+                view.memberCounts.data(), static_cast<WORD32>(view.memberCounts.size()),
+                view.portIds.data(), view.portSpeeds.data(),
+                static_cast<WORD32>(std::min(view.portIds.size(), view.portSpeeds.size())),
+                problem,
+                view.pinnedMask.size() >= view.memberTable.size() ? view.pinnedMask.data() : nullptr)) {
+            XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 稠密问题构建失败（容量: %u），保持原成员表\n", MAX_ITEMS);
+            return;
+        }
+        stats = pSelf->searchDense(problem);
+        kernels::writeBackMemberTable(problem, outTable);
+    }
+};
+
 std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
     const std::unordered_map<WORD32, WORD32>& memberTable,
     const std::vector<WORD64>& memberCounts,
@@ -25,20 +69,65 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
     // 创建结果的副本
     std::unordered_map<WORD32, WORD32> result = memberTable;
     
-    // 获取所有哈希索引
-    std::vector<WORD32> hashIndices;
-    for (const auto& entry : memberTable) {
-        hashIndices.push_back(entry.first);
-    }
-    
-    XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] 📊 成员表信息 - 哈希索引总数: %zu\n", hashIndices.size());
+    XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] 📊 成员表信息 - 哈希索引总数: %zu\n", memberTable.size());
     
     // 如果没有足够的哈希索引用于交换，直接返回
-    if (hashIndices.size() < 2) {
-        XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 哈希索引数量不足(%zu < 2)，无法进行交换优化\n", hashIndices.size());
+    if (memberTable.size() < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 哈希索引数量不足(%zu < 2)，无法进行交换优化\n", memberTable.size());
         return result;
     }
 
+    // 按规模分派到定长内核（成员表中出现的端口数不超过表项数）
+    MapRunner runner = {this, memberTable, memberCounts, portSpeeds, result};
+    WORD32 dwItemNum = static_cast<WORD32>(memberTable.size());
+    if (!kernels::dispatchByCapacity(dwItemNum, dwItemNum, runner)) {
+        XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 成员表规模(%u)超出内核容量，保持原成员表\n", dwItemNum);
+    }
+    
+    return result;
+}
+
+T_AI_ECMP_OPTIMIZE_STATS LocalSearch::optimizeInto(
+    const T_AI_ECMP_PROBLEM_VIEW& problem,
+    std::vector<WORD32>& outTable,
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) {
+    
+    XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] 🚀 开始局部搜索优化（视图接口），最大迭代次数: %u，交换代价因子: %.6f\n", 
+                  m_dwMaxIterations, m_exchangeCostFactor);
+    
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    outTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+    changes.clear();
+    
+    if (problem.memberTable.size() < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 哈希索引数量不足(%zu < 2)，无法进行交换优化\n", problem.memberTable.size());
+        return stats;
+    }
+    
+    ViewRunner runner = {this, problem, outTable, stats};
+    WORD32 dwItemNum = static_cast<WORD32>(problem.memberTable.size());
+    if (!kernels::dispatchByCapacity(dwItemNum, dwItemNum, runner)) {
+        XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 成员表规模(%u)超出内核容量，保持原成员表\n", dwItemNum);
+        return stats;
+    }
+    
+    collectMemberChanges(problem.memberTable, outTable, changes);
+    stats.dwChangedEntries = static_cast<WORD32>(changes.size());
+    return stats;
+}
+
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+T_AI_ECMP_OPTIMIZE_STATS LocalSearch::searchDense(kernels::DenseProblem<MAX_ITEMS, MAX_PORTS>& problem) {
+    
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    if (problem.dwItemNum < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] ⚠️ 有效哈希索引数量不足(%u < 2)，无法进行交换优化\n", problem.dwItemNum);
+        return stats;
+    }
+
+    XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] 📊 定长内核容量: %u，有效表项: %u，端口: %u\n", 
+                  MAX_ITEMS, problem.dwItemNum, problem.dwPortNum);
+
     // ===== 新增：定义交换记录结构体 =====
     struct SwapRecord {
         WORD32 iteration;
@@ -63,11 +152,10 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
     // 初始化随机数生成器
     std::random_device randomDevice;
     std::mt19937 randomGenerator(randomDevice());
-    std::uniform_int_distribution<size_t> indexDistribution(0, hashIndices.size() - 1);
+    std::uniform_int_distribution<WORD32> indexDistribution(0, problem.dwItemNum - 1);
     
     // 计算初始负载
-    auto portLoads = utils::calculatePortLoads(result, memberCounts);
-    auto originalEval = utils::calculateLoadBalanceMetrics(portLoads, portSpeeds);
+    auto originalEval = kernels::evaluateProblem(problem);
     auto originalScore = utils::calculateBalanceScore(originalEval);
 
   
@@ -75,9 +163,7 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
                   originalEval.totalGap, originalEval.upBoundGap, originalEval.lowBoundGap, 
                   originalScore);
     
-    // 记录最佳解
-    auto bestResult = result;
-    auto bestPortLoads = portLoads;
+    // 记录最佳解（只接受改进交换，当前解即最佳解）
     auto bestEval = originalEval;
     double bestScore = originalScore;
     
@@ -92,22 +178,25 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
     
     // 实施局部搜索
     while (dwIterations < m_dwMaxIterations && dwConsecutiveFailures < MAX_CONSECUTIVE_FAILURES) {
+        // 组合优化器竞速时：收到停止请求、超过截止时间或已达到目标得分则提前结束
+        if (shouldStop() || reachedTargetScore(bestScore)) {
+            break;
+        }
+
         // 随机选择两个不同的哈希索引
-        size_t idx1 = indexDistribution(randomGenerator);
-        size_t idx2;
+        WORD32 idx1 = indexDistribution(randomGenerator);
+        WORD32 idx2;
         do {
             idx2 = indexDistribution(randomGenerator);
-        } while (idx1 == idx2 && hashIndices.size() > 1);
+        } while (idx1 == idx2);
         
-        WORD32 dwHashIndex1 = hashIndices[idx1];
-        WORD32 dwHashIndex2 = hashIndices[idx2];
+        WORD32 dwHashIndex1 = problem.adwHashIndex[idx1];
+        WORD32 dwHashIndex2 = problem.adwHashIndex[idx2];
         
         dwTotalSwapsAttempted++;
         
-        // 评估交换的改进量
-        double improvement = utils::calculateSwapImprovement(
-            result, memberCounts, portLoads, portSpeeds, dwHashIndex1, dwHashIndex2
-        );
+        // 评估交换的改进量（增量评估，仅改动两个端口的负载）
+        double improvement = kernels::evaluateSwap(problem, bestScore, idx1, idx2);
         
         // 考虑交换成本
         improvement -= m_exchangeCostFactor;
@@ -115,29 +204,21 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
         // 如果有改进，执行交换
         if (improvement > 0) {
             // 获取当前端口分配
-            WORD32 dwPortId1 = result[dwHashIndex1];
-            WORD32 dwPortId2 = result[dwHashIndex2];
+            WORD32 dwPortId1 = problem.adwPortIds[problem.abyMemberPort[idx1]];
+            WORD32 dwPortId2 = problem.adwPortIds[problem.abyMemberPort[idx2]];
             
             // 获取流量计数
-            WORD64 count1 = dwHashIndex1 < memberCounts.size() ? memberCounts[dwHashIndex1] : 0;
-            WORD64 count2 = dwHashIndex2 < memberCounts.size() ? memberCounts[dwHashIndex2] : 0;
+            WORD64 count1 = problem.aqwCounts[idx1];
+            WORD64 count2 = problem.aqwCounts[idx2];
             
             XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] 🔄 第%u次迭代 - 执行交换: [Hash%u->Port%u(流量:%llu)] <-> [Hash%u->Port%u(流量:%llu)], 改进量: +%.6f\n",
                           dwIterations + 1, dwHashIndex1, dwPortId1, count1, dwHashIndex2, dwPortId2, count2, improvement);
             
-            // 更新端口负载
-            portLoads[dwPortId1] -= count1;
-            portLoads[dwPortId2] -= count2;
-            
-            // 交换端口分配
-            result[dwHashIndex1] = dwPortId2;
-            result[dwHashIndex2] = dwPortId1;
-            
-            portLoads[dwPortId1] += count2;
-            portLoads[dwPortId2] += count1;
+            // 交换端口分配并更新端口负载
+            kernels::applySwap(problem, idx1, idx2);
             
             // 评估新解
-            auto newEval = utils::calculateLoadBalanceMetrics(portLoads, portSpeeds);
+            auto newEval = kernels::evaluateProblem(problem);
             double newScore = utils::calculateBalanceScore(newEval);
             
             dwSuccessfulSwaps++;
@@ -161,8 +242,6 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
             bestScore = newScore;
             dwConsecutiveFailures = 0;    //重置连续失败次数
             bestEval = newEval;
-            bestResult = result;
-            bestScore = newScore;
             
         } else {
             dwConsecutiveFailures++;
@@ -194,8 +273,15 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
     XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]   - 尝试交换次数: %u\n", dwTotalSwapsAttempted);
     XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]   - 成功交换次数: %u (成功率: %.1f%%)\n", dwSuccessfulSwaps, finalSuccessRate);
     XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]   - 连续失败次数: %u\n", dwConsecutiveFailures);
-    XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]   - 终止原因: %s\n", 
-                  dwIterations >= m_dwMaxIterations ? "达到最大迭代次数" : "达到最大连续失败次数");
+    const char* pszStopReason = "达到最大连续失败次数";
+    if (dwIterations >= m_dwMaxIterations) {
+        pszStopReason = "达到最大迭代次数";
+    } else if (reachedTargetScore(bestScore)) {
+        pszStopReason = "达到目标得分";
+    } else if (dwConsecutiveFailures < MAX_CONSECUTIVE_FAILURES) {
+        pszStopReason = "收到停止请求或超过截止时间";
+    }
+    XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]   - 终止原因: %s\n", pszStopReason);
     
     XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]  优化效果:\n");
     XOS_SysLog(LOG_EMERGENCY, "[LocalSearch]   - 初始得分: %.6f -> 最终得分: %.6f (改进: %.6f)\n",
@@ -240,8 +326,11 @@ std::unordered_map<WORD32, WORD32> LocalSearch::optimize(
         XOS_SysLog(LOG_EMERGENCY, "[LocalSearch] 💡 总共记录了 %zu 次成功交换\n", swapHistory.size());
     }
     
-    // 返回最佳解
-    return bestResult;
+    // 最佳解保留在稠密问题中，由调用方写回
+    stats.dwEvaluations = dwTotalSwapsAttempted;
+    stats.scoreBefore = originalScore;
+    stats.scoreAfter = bestScore;
+    return stats;
 }
 
 } // namespace ai_ecmp
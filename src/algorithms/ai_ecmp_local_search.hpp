@@ -2,6 +2,7 @@
 #define AI_ECMP_LOCAL_SEARCH_HPP
 
 #include "ai_ecmp_algorithm_base.hpp"
+#include "../utils/ai_ecmp_kernels.hpp"
 
 namespace ai_ecmp {
 
@@ -28,17 +29,37 @@ public:
         const std::unordered_map<WORD32, WORD32>& memberTable,
         const std::vector<WORD64>& memberCounts,
         const std::unordered_map<WORD32, WORD32>& portSpeeds) override;
+
+    /**
+     * 运行算法优化（零拷贝接口），直接在视图上构建定长稠密问题
+     */
+    T_AI_ECMP_OPTIMIZE_STATS optimizeInto(
+        const T_AI_ECMP_PROBLEM_VIEW& problem,
+        std::vector<WORD32>& outTable,
+        std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) override;
+
+    const char* getName() const override { return "LocalSearch"; }
+
+    void setSearchParameters(WORD32 dwMaxIterations, double exchangeCostFactor) override {
+        m_dwMaxIterations = dwMaxIterations;
+        m_exchangeCostFactor = exchangeCostFactor;
+    }
     
 private:
     WORD32 m_dwMaxIterations; // 最大迭代次数
     double m_exchangeCostFactor; // 交换代价因子
     
-    // 评估交换操作的改进
-    double evaluateSwap(
-        const std::unordered_map<WORD32, WORD32>& memberTable,
-        const std::vector<WORD64>& memberCounts,
-        std::unordered_map<WORD32, WORD64>& portLoads,
-        WORD32 dwHashIndex1, WORD32 dwHashIndex2);
+    // 按容量档位分派到定长内核的访问者（容器输入 / 视图输入）
+    struct MapRunner;
+    struct ViewRunner;
+
+    /**
+     * @brief 定长稠密内核上的局部搜索主循环，结果保留在稠密问题中
+     * @param problem 稠密问题
+     * @return 优化统计（不含变化表项数）
+     */
+    template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+    T_AI_ECMP_OPTIMIZE_STATS searchDense(kernels::DenseProblem<MAX_ITEMS, MAX_PORTS>& problem);
 };
 
 } // namespace ai_ecmp
@@ -0,0 +1,438 @@
+#include "ai_ecmp_portfolio.hpp"
+#include "ai_ecmp_local_search.hpp"
+#include "ai_ecmp_annealing.hpp"
+#include "ai_ecmp_greedy_repair.hpp"
+#include "../utils/ai_ecmp_metrics.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <mutex>
+
+namespace ai_ecmp {
+
+namespace {
+
+// 形状维度下单个算法的统计
+struct ShapeAlgoStats {
+    WORD32 dwRaces;
+    WORD32 dwWins;
+};
+
+// 全局形状统计：shapeKey -> (算法名称 -> 统计)，所有SG共享
+std::mutex& shapeStatsMutex() {
+    static std::mutex s_mutex;
+    return s_mutex;
+}
+
+std::unordered_map<WORD32, std::unordered_map<std::string, ShapeAlgoStats>>& shapeStats() {
+    static std::unordered_map<WORD32, std::unordered_map<std::string, ShapeAlgoStats>> s_stats;
+    return s_stats;
+}
+
+// 竞速线程池的最大工作线程数（默认组合有3个参赛算法，调用线程也参与执行）
+const size_t RACE_POOL_MAX_WORKERS = 3;
+
+/**
+ * 竞速工作线程池：进程内常驻，所有SG的组合优化器共享
+ * 一次竞速作为一个作业提交，作业中的任务由工作线程和调用线程共同领取，
+ * 工作线程全部忙碌（或没有工作线程）时调用线程独自执行剩余任务，不会因等待线程池而阻塞
+ */
+class RaceWorkerPool {
+public:
+    static RaceWorkerPool& instance() {
+        static RaceWorkerPool s_pool;
+        return s_pool;
+    }
+
+    RaceWorkerPool(const RaceWorkerPool&) = delete;
+    RaceWorkerPool& operator=(const RaceWorkerPool&) = delete;
+
+    // 执行taskNum个任务，返回时全部任务已完成；返回工作线程在这些任务上消耗的CPU时间(微秒)
+    WORD64 run(size_t taskNum, const std::function<void(size_t)>& task) {
+        RaceJob job = {&task, taskNum, 0, 0, 0};
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (taskNum > 1 && !m_workers.empty()) {
+            m_jobs.push_back(&job);
+            m_workCv.notify_all();
+        }
+        while (job.nextTask < job.taskNum) {
+            const size_t index = claim(job);
+            lock.unlock();
+            task(index);
+            lock.lock();
+            job.doneNum++;
+        }
+        m_doneCv.wait(lock, [&job] { return job.doneNum == job.taskNum; });
+        return job.qwWorkerCpuMicros;
+    }
+
+private:
+    struct RaceJob {
+        const std::function<void(size_t)>* pTask;
+        size_t taskNum;
+        size_t nextTask;            // 下一个待领取的任务（池锁内访问）
+        size_t doneNum;             // 已完成的任务数（池锁内访问）
+        WORD64 qwWorkerCpuMicros;   // 工作线程消耗的CPU时间（池锁内访问）
+    };
+
+    RaceWorkerPool() : m_bStop(false) {
+        const unsigned int hwThreads = std::thread::hardware_concurrency();
+        const size_t workerNum = hwThreads > 1 ? std::min<size_t>(RACE_POOL_MAX_WORKERS, hwThreads - 1) : 0;
+        for (size_t i = 0; i < workerNum; ++i) {
+            m_workers.emplace_back(&RaceWorkerPool::workerLoop, this);
+        }
+    }
+
+    ~RaceWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = true;
+        }
+        m_workCv.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    // 领取作业的下一个任务，最后一个任务被领取后作业移出队列（调用方须持有池锁）
+    size_t claim(RaceJob& job) {
+        const size_t index = job.nextTask++;
+        if (job.nextTask == job.taskNum) {
+            auto it = std::find(m_jobs.begin(), m_jobs.end(), &job);
+            if (it != m_jobs.end()) {
+                m_jobs.erase(it);
+            }
+        }
+        return index;
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_workCv.wait(lock, [this] { return m_bStop || !m_jobs.empty(); });
+            if (m_bStop) {
+                return;
+            }
+            RaceJob& job = *m_jobs.front();
+            const size_t index = claim(job);
+            lock.unlock();
+            const WORD64 qwCpuStart = AlgorithmBase::getThreadCpuMicros();
+            (*job.pTask)(index);
+            const WORD64 qwCpuMicros = AlgorithmBase::getThreadCpuMicros() - qwCpuStart;
+            lock.lock();
+            job.qwWorkerCpuMicros += qwCpuMicros;
+            if (++job.doneNum == job.taskNum) {
+                m_doneCv.notify_all();
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_workCv;   // 有新作业
+    std::condition_variable m_doneCv;   // 有作业完成
+    std::deque<RaceJob*> m_jobs;        // 尚有任务未领取的作业
+    std::vector<std::thread> m_workers;
+    bool m_bStop;
+};
+
+} // namespace
+
+PortfolioOptimizer::PortfolioOptimizer(WORD32 dwDeadlineMs)
+    : m_dwDeadlineMs(dwDeadlineMs)
+    , m_dwRaceCount(0)
+    , m_lastWinner(-1) {
+}
+
+std::unique_ptr<PortfolioOptimizer> PortfolioOptimizer::createDefault(WORD32 dwDeadlineMs) {
+    std::unique_ptr<PortfolioOptimizer> pPortfolio(new PortfolioOptimizer(dwDeadlineMs));
+    pPortfolio->registerAlgorithm(std::unique_ptr<AlgorithmBase>(new LocalSearch(10000, 0.1)));
+    pPortfolio->registerAlgorithm(std::unique_ptr<AlgorithmBase>(new SimulatedAnnealing()));
+    pPortfolio->registerAlgorithm(std::unique_ptr<AlgorithmBase>(new GreedyRepair()));
+    return pPortfolio;
+}
+
+void PortfolioOptimizer::registerAlgorithm(std::unique_ptr<AlgorithmBase>&& pAlgorithm) {
+    if (!pAlgorithm) {
+        return;
+    }
+    PortfolioMember member;
+    member.pAlgorithm = std::move(pAlgorithm);
+    member.dwRaces = 0;
+    member.dwWins = 0;
+    member.qwTotalMicros = 0;
+    m_members.push_back(std::move(member));
+}
+
+std::vector<size_t> PortfolioOptimizer::startRace(WORD32 dwShapeKey, double targetScore) {
+    std::vector<size_t> participants = selectParticipants(dwShapeKey);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_dwDeadlineMs);
+
+    XOS_SysLog(LOG_EMERGENCY, "[Portfolio] 开始第%u次竞速 - 形状键: 0x%x, 参赛算法数: %zu/%zu, 截止时间: %u ms, 目标得分: %.6f\n",
+                  m_dwRaceCount + 1, dwShapeKey, participants.size(), m_members.size(), m_dwDeadlineMs, targetScore);
+
+    for (size_t idx : participants) {
+        AlgorithmBase* pAlgorithm = m_members[idx].pAlgorithm.get();
+        pAlgorithm->clearRunLimits();
+        pAlgorithm->setDeadline(deadline);
+        pAlgorithm->setTargetScore(targetScore);
+    }
+    m_outcomes.assign(participants.size(), RaceOutcome{0.0, 0, 0, 0});
+    return participants;
+}
+
+WORD64 PortfolioOptimizer::runParticipants(const std::vector<size_t>& participants,
+                                           const std::function<void(size_t)>& runMember) {
+    // 每个参赛算法完整地在一个线程上运行，按线程CPU时间统计其开销
+    return RaceWorkerPool::instance().run(participants.size(), [&](size_t slot) {
+        const WORD64 qwCpuStart = getThreadCpuMicros();
+        runMember(slot);
+        m_outcomes[slot].qwCpuMicros = getThreadCpuMicros() - qwCpuStart;
+    });
+}
+
+size_t PortfolioOptimizer::finishRace(WORD32 dwShapeKey, const std::vector<size_t>& participants) {
+    size_t bestSlot = 0;
+    for (size_t slot = 1; slot < m_outcomes.size(); ++slot) {
+        const RaceOutcome& candidate = m_outcomes[slot];
+        const RaceOutcome& best = m_outcomes[bestSlot];
+        if (candidate.score > best.score ||
+            (candidate.score == best.score && candidate.dwChangedEntries < best.dwChangedEntries)) {
+            bestSlot = slot;
+        }
+    }
+
+    for (size_t slot = 0; slot < participants.size(); ++slot) {
+        PortfolioMember& member = m_members[participants[slot]];
+        member.dwRaces++;
+        member.qwTotalMicros += m_outcomes[slot].qwCpuMicros;
+        member.pAlgorithm->clearRunLimits();
+
+        XOS_SysLog(LOG_EMERGENCY, "[Portfolio]   %-14s 得分: %.6f, 改动条目: %u, CPU: %llu us%s\n",
+                      member.pAlgorithm->getName(), m_outcomes[slot].score, m_outcomes[slot].dwChangedEntries,
+                      m_outcomes[slot].qwCpuMicros, slot == bestSlot ? " <- 胜出" : "");
+    }
+
+    size_t winner = participants[bestSlot];
+    m_members[winner].dwWins++;
+    m_lastWinner = static_cast<int>(winner);
+    m_dwRaceCount++;
+    recordShapeResult(dwShapeKey, participants, winner);
+    return bestSlot;
+}
+
+std::unordered_map<WORD32, WORD32> PortfolioOptimizer::optimize(
+    const std::unordered_map<WORD32, WORD32>& memberTable,
+    const std::vector<WORD64>& memberCounts,
+    const std::unordered_map<WORD32, WORD32>& portSpeeds) {
+
+    if (m_members.empty() || memberTable.size() < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[Portfolio] 无参赛算法或成员表过小(%zu)，直接返回原成员表\n", memberTable.size());
+        return memberTable;
+    }
+
+    std::vector<WORD32> speeds;
+    speeds.reserve(portSpeeds.size());
+    for (const auto& entry : portSpeeds) {
+        speeds.push_back(entry.second);
+    }
+    WORD32 dwShapeKey = calculateShapeKey(memberTable.size(), speeds.data(), speeds.size());
+    double targetScore = utils::calculateTargetBalanceScore(memberCounts, portSpeeds) - TARGET_SCORE_TOLERANCE;
+    std::vector<size_t> participants = startRace(dwShapeKey, targetScore);
+    std::vector<std::unordered_map<WORD32, WORD32>> tables(participants.size());
+
+    // 单个算法的执行体：完成后若达到目标得分，立即通知其余算法停止
+    auto runMember = [&](size_t slot) {
+        AlgorithmBase* pAlgorithm = m_members[participants[slot]].pAlgorithm.get();
+        RaceOutcome& outcome = m_outcomes[slot];
+        tables[slot] = pAlgorithm->optimize(memberTable, memberCounts, portSpeeds);
+
+        auto portLoads = utils::calculatePortLoads(tables[slot], memberCounts);
+        outcome.score = utils::calculateBalanceScore(utils::calculateLoadBalanceMetrics(portLoads, portSpeeds));
+
+        outcome.dwChangedEntries = 0;
+        for (const auto& entry : tables[slot]) {
+            auto it = memberTable.find(entry.first);
+            if (it == memberTable.end() || it->second != entry.second) {
+                outcome.dwChangedEntries++;
+            }
+        }
+
+        if (outcome.score >= targetScore) {
+            for (size_t other : participants) {
+                m_members[other].pAlgorithm->requestStop();
+            }
+        }
+    };
+    runParticipants(participants, runMember);
+
+    size_t bestSlot = finishRace(dwShapeKey, participants);
+    return std::move(tables[bestSlot]);
+}
+
+T_AI_ECMP_OPTIMIZE_STATS PortfolioOptimizer::optimizeInto(
+    const T_AI_ECMP_PROBLEM_VIEW& problem,
+    std::vector<WORD32>& outTable,
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) {
+
+    T_AI_ECMP_OPTIMIZE_STATS stats = {};
+    outTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+    changes.clear();
+    const size_t portNum = std::min(problem.portIds.size(), problem.portSpeeds.size());
+    if (m_members.empty() || problem.memberTable.size() < 2) {
+        XOS_SysLog(LOG_EMERGENCY, "[Portfolio] 无参赛算法或成员表过小(%zu)，保持原成员表\n", problem.memberTable.size());
+        return stats;
+    }
+
+    // 各算法的结果按同一口径评分（含固定表项的负载），评分数组跨调用复用
+    m_scoreCounts.assign(problem.memberCounts.begin(), problem.memberCounts.end());
+    m_scorePortIds.assign(problem.portIds.begin(), problem.portIds.begin() + portNum);
+    m_scorePortSpeeds.assign(problem.portSpeeds.begin(), problem.portSpeeds.begin() + portNum);
+    m_scoreTable.assign(problem.memberTable.begin(), problem.memberTable.end());
+    stats.scoreBefore = utils::calculateBalanceScore(utils::calculateLoadBalanceMetrics(
+        m_scoreTable, m_scoreCounts, m_scorePortIds, m_scorePortSpeeds));
+
+    WORD32 dwShapeKey = calculateShapeKey(problem.memberTable.size(), problem.portSpeeds.data(), portNum);
+    double targetScore = utils::calculateTargetBalanceScore(problem.memberCounts.data(), problem.memberCounts.size(),
+                                                            problem.portSpeeds.data(), portNum) - TARGET_SCORE_TOLERANCE;
+    std::vector<size_t> participants = startRace(dwShapeKey, targetScore);
+
+    auto runMember = [&](size_t slot) {
+        PortfolioMember& member = m_members[participants[slot]];
+        RaceOutcome& outcome = m_outcomes[slot];
+        T_AI_ECMP_OPTIMIZE_STATS memberStats = member.pAlgorithm->optimizeInto(problem, member.outTable, member.changes);
+        outcome.score = utils::calculateBalanceScore(utils::calculateLoadBalanceMetrics(
+            member.outTable, m_scoreCounts, m_scorePortIds, m_scorePortSpeeds));
+        outcome.dwChangedEntries = static_cast<WORD32>(member.changes.size());
+        outcome.dwEvaluations = memberStats.dwEvaluations;
+
+        if (outcome.score >= targetScore) {
+            for (size_t other : participants) {
+                m_members[other].pAlgorithm->requestStop();
+            }
+        }
+    };
+    stats.qwWorkerCpuMicros = runParticipants(participants, runMember);
+    for (const RaceOutcome& outcome : m_outcomes) {
+        stats.dwEvaluations += outcome.dwEvaluations;
+    }
+
+    size_t bestSlot = finishRace(dwShapeKey, participants);
+    const PortfolioMember& winner = m_members[participants[bestSlot]];
+    outTable = winner.outTable;
+    changes = winner.changes;
+    stats.dwChangedEntries = m_outcomes[bestSlot].dwChangedEntries;
+    stats.scoreAfter = m_outcomes[bestSlot].score;
+    return stats;
+}
+
+void PortfolioOptimizer::setSearchParameters(WORD32 dwMaxIterations, double exchangeCostFactor) {
+    for (auto& member : m_members) {
+        member.pAlgorithm->setSearchParameters(dwMaxIterations, exchangeCostFactor);
+    }
+}
+
+std::vector<PortfolioOptimizer::T_MEMBER_STATS> PortfolioOptimizer::getMemberStats() const {
+    std::vector<T_MEMBER_STATS> stats;
+    stats.reserve(m_members.size());
+    for (const auto& member : m_members) {
+        stats.push_back({member.pAlgorithm->getName(), member.dwRaces, member.dwWins, member.qwTotalMicros});
+    }
+    return stats;
+}
+
+const char* PortfolioOptimizer::getLastWinnerName() const {
+    if (m_lastWinner < 0 || static_cast<size_t>(m_lastWinner) >= m_members.size()) {
+        return "None";
+    }
+    return m_members[m_lastWinner].pAlgorithm->getName();
+}
+
+WORD32 PortfolioOptimizer::calculateShapeKey(size_t itemNum, const WORD32* pdwPortSpeeds, size_t portNum) {
+
+    // 逻辑成员规模按2的幂分档
+    WORD32 dwItemClass = 0;
+    while ((1u << dwItemClass) < itemNum && dwItemClass < 31) {
+        dwItemClass++;
+    }
+
+    WORD32 dwPortNum = std::min<WORD32>(static_cast<WORD32>(portNum), 0x7F);
+
+    bool bHeterogeneous = false;
+    for (size_t i = 1; i < portNum; ++i) {
+        if (pdwPortSpeeds[i] != pdwPortSpeeds[0]) {
+            bHeterogeneous = true;
+            break;
+        }
+    }
+
+    return (dwItemClass << 8) | (dwPortNum << 1) | (bHeterogeneous ? 1u : 0u);
+}
+
+std::vector<size_t> PortfolioOptimizer::selectParticipants(WORD32 dwShapeKey) const {
+    std::vector<size_t> participants;
+
+    // 周期性全员探索，避免早期偶然结果把算法永久排除
+    bool bExplore = (m_dwRaceCount % EXPLORE_PERIOD) == 0;
+
+    std::unordered_map<std::string, ShapeAlgoStats> algoStats;
+    if (!bExplore) {
+        std::lock_guard<std::mutex> lock(shapeStatsMutex());
+        auto it = shapeStats().find(dwShapeKey);
+        if (it != shapeStats().end()) {
+            algoStats = it->second;
+        }
+    }
+
+    WORD32 dwShapeRaces = 0;
+    for (const auto& entry : algoStats) {
+        dwShapeRaces = std::max(dwShapeRaces, entry.second.dwRaces);
+    }
+
+    if (bExplore || dwShapeRaces < MIN_RACES_FOR_BIAS) {
+        for (size_t i = 0; i < m_members.size(); ++i) {
+            participants.push_back(i);
+        }
+        return participants;
+    }
+
+    // 按平滑胜率筛选，至少保留胜率最高的算法
+    size_t bestIdx = 0;
+    double bestRate = -1.0;
+    for (size_t i = 0; i < m_members.size(); ++i) {
+        ShapeAlgoStats stats = {0, 0};
+        auto it = algoStats.find(m_members[i].pAlgorithm->getName());
+        if (it != algoStats.end()) {
+            stats = it->second;
+        }
+        double winRate = (stats.dwWins + 1.0) / (stats.dwRaces + 2.0);
+        if (winRate >= MIN_WIN_RATE) {
+            participants.push_back(i);
+        }
+        if (winRate > bestRate) {
+            bestRate = winRate;
+            bestIdx = i;
+        }
+    }
+
+    if (participants.empty()) {
+        participants.push_back(bestIdx);
+    }
+    return participants;
+}
+
+void PortfolioOptimizer::recordShapeResult(
+    WORD32 dwShapeKey, const std::vector<size_t>& participants, size_t winner) const {
+
+    std::lock_guard<std::mutex> lock(shapeStatsMutex());
+    auto& algoStats = shapeStats()[dwShapeKey];
+    for (size_t idx : participants) {
+        ShapeAlgoStats& stats = algoStats[m_members[idx].pAlgorithm->getName()];
+        stats.dwRaces++;
+        if (idx == winner) {
+            stats.dwWins++;
+        }
+    }
+}
+
+} // namespace ai_ecmp
@@ -0,0 +1,160 @@
+#ifndef AI_ECMP_PORTFOLIO_HPP
+#define AI_ECMP_PORTFOLIO_HPP
+
+#include "ai_ecmp_algorithm_base.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace ai_ecmp {
+
+/**
+ * 组合优化器：在共享截止时间内并发运行多个已注册算法，返回最优结果
+ * - 参赛算法由进程内常驻的竞速工作线程池执行（所有SG共享，调用线程也参与执行），不为每次竞速创建线程
+ * - 任一算法达到可达最优得分估计后，立即通知其余算法停止
+ * - 记录本SG各算法的胜出统计
+ * - 按SG形状（逻辑成员规模、端口数、速率是否异构）累计全局胜出统计，
+ *   统计充分后只让胜率足够的算法参赛（周期性全员探索），使CPU花在有效的算法上
+ */
+class PortfolioOptimizer : public AlgorithmBase {
+public:
+    /**
+     * 单个参赛算法的统计信息
+     */
+    struct T_MEMBER_STATS {
+        const char* pszName;    // 算法名称
+        WORD32 dwRaces;         // 参赛次数
+        WORD32 dwWins;          // 胜出次数
+        WORD64 qwTotalMicros;   // 累计CPU时间(微秒)
+    };
+
+    /**
+     * 构造函数
+     * @param dwDeadlineMs 每次优化的共享截止时间(毫秒)
+     */
+    explicit PortfolioOptimizer(WORD32 dwDeadlineMs = 100);
+
+    /**
+     * @brief 创建注册了默认算法组合（局部搜索、模拟退火、构造+修复）的组合优化器
+     * @param dwDeadlineMs 每次优化的共享截止时间(毫秒)
+     * @return 组合优化器实例
+     */
+    static std::unique_ptr<PortfolioOptimizer> createDefault(WORD32 dwDeadlineMs = 100);
+
+    /**
+     * @brief 注册参赛算法
+     * @param pAlgorithm 算法实例（所有权转移给组合优化器）
+     */
+    void registerAlgorithm(std::unique_ptr<AlgorithmBase>&& pAlgorithm);
+
+    /**
+     * 运行算法优化
+     * @param memberTable 成员表 (hash_index -> portId)
+     * @param memberCounts 成员计数表
+     * @param portSpeeds 端口速率表
+     * @return 所有参赛算法中的最优成员表
+     */
+    std::unordered_map<WORD32, WORD32> optimize(
+        const std::unordered_map<WORD32, WORD32>& memberTable,
+        const std::vector<WORD64>& memberCounts,
+        const std::unordered_map<WORD32, WORD32>& portSpeeds) override;
+
+    /**
+     * 运行算法优化（零拷贝接口）：各参赛算法在同一视图上竞速（固定表项对所有算法生效），
+     * 结果写入各算法跨调用复用的缓冲区，胜出者的结果复制到输出
+     */
+    T_AI_ECMP_OPTIMIZE_STATS optimizeInto(
+        const T_AI_ECMP_PROBLEM_VIEW& problem,
+        std::vector<WORD32>& outTable,
+        std::vector<T_AI_ECMP_MEMBER_CHANGE>& changes) override;
+
+    const char* getName() const override { return "Portfolio"; }
+
+    /**
+     * @brief 将搜索参数转发给所有参赛算法
+     */
+    void setSearchParameters(WORD32 dwMaxIterations, double exchangeCostFactor) override;
+
+    /**
+     * @brief 设置共享截止时间
+     * @param dwDeadlineMs 截止时间(毫秒)
+     */
+    void setDeadlineMs(WORD32 dwDeadlineMs) { m_dwDeadlineMs = dwDeadlineMs; }
+    WORD32 getDeadlineMs() const { return m_dwDeadlineMs; }
+
+    /**
+     * @brief 获取本SG各参赛算法的统计信息
+     * @return 统计信息列表（按注册顺序）
+     */
+    std::vector<T_MEMBER_STATS> getMemberStats() const;
+
+    /**
+     * @brief 获取最近一次竞速的胜出算法名称
+     * @return 算法名称，尚未竞速时返回"None"
+     */
+    const char* getLastWinnerName() const;
+
+    /**
+     * @brief 获取竞速总次数
+     */
+    WORD32 getRaceCount() const { return m_dwRaceCount; }
+
+private:
+    // 形状统计充分前的最少竞速次数
+    static constexpr WORD32 MIN_RACES_FOR_BIAS = 10;
+    // 参赛所需的最低胜率（拉普拉斯平滑后）
+    static constexpr double MIN_WIN_RATE = 0.2;
+    // 全员探索周期（每隔若干次竞速让所有算法参赛一次）
+    static constexpr WORD32 EXPLORE_PERIOD = 8;
+    // 达到目标得分的容差
+    static constexpr double TARGET_SCORE_TOLERANCE = 0.01;
+
+    struct PortfolioMember {
+        std::unique_ptr<AlgorithmBase> pAlgorithm;
+        WORD32 dwRaces;
+        WORD32 dwWins;
+        WORD64 qwTotalMicros;                               // 累计CPU时间(微秒)
+        std::vector<WORD32> outTable;                       // 零拷贝接口的结果缓冲区（跨调用复用）
+        std::vector<T_AI_ECMP_MEMBER_CHANGE> changes;       // 零拷贝接口的变化列表（跨调用复用）
+    };
+
+    // 单个参赛算法的竞速结果
+    struct RaceOutcome {
+        double score;
+        WORD32 dwChangedEntries;
+        WORD32 dwEvaluations;   // 候选解评估次数
+        WORD64 qwCpuMicros;     // 算法运行消耗的CPU时间(微秒)
+    };
+
+    std::vector<PortfolioMember> m_members;
+    WORD32 m_dwDeadlineMs;
+    WORD32 m_dwRaceCount;
+    int m_lastWinner;   // -1表示尚未竞速
+    std::vector<RaceOutcome> m_outcomes;                    // 本次竞速结果（跨调用复用）
+    std::vector<WORD32> m_scoreTable;                       // 评分用的成员表、计数和端口数组（跨调用复用）
+    std::vector<WORD64> m_scoreCounts;
+    std::vector<WORD32> m_scorePortIds;
+    std::vector<WORD32> m_scorePortSpeeds;
+
+    // 计算SG形状键：逻辑成员规模(log2)、端口数、速率是否异构
+    static WORD32 calculateShapeKey(size_t itemNum, const WORD32* pdwPortSpeeds, size_t portNum);
+
+    // 设置参赛算法的截止时间和目标得分，返回本次参赛的算法下标
+    std::vector<size_t> startRace(WORD32 dwShapeKey, double targetScore);
+
+    // 在竞速线程池上并发运行参赛算法（当前线程也参与），返回工作线程消耗的CPU时间(微秒)
+    WORD64 runParticipants(const std::vector<size_t>& participants, const std::function<void(size_t)>& runMember);
+
+    // 选出胜者并更新统计：得分更高者胜，得分相同时改动条目更少者胜；返回胜出的参赛序号
+    size_t finishRace(WORD32 dwShapeKey, const std::vector<size_t>& participants);
+
+    // 根据形状统计选出本次参赛的算法下标
+    std::vector<size_t> selectParticipants(WORD32 dwShapeKey) const;
+
+    // 更新形状统计
+    void recordShapeResult(WORD32 dwShapeKey, const std::vector<size_t>& participants, size_t winner) const;
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_PORTFOLIO_HPP */
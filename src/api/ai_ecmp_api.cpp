@@ -1,5 +1,7 @@
 #include "ai_ecmp_api.h"
 #include "../core/ai_ecmp_manager.hpp"
+#include <algorithm>
+#include <cstring>
 
 using namespace ai_ecmp;
 
@@ -10,6 +12,17 @@ WORD32 AI_ECMP_SgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_SG_CFG* pSgCfg) {
     return CAISlbManagerSingleton::getManagerInstance().handleSgConfigCtrl(bSwitchFlag, pSgCfg);
 }
 
+WORD32 AI_ECMP_SgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags,
+                             T_AI_ECMP_SG_BATCH_RESULT* pResult) {
+    // 批量配置：一次查找和取槽，并行构造新实例
+    return CAISlbManagerSingleton::getManagerInstance().handleSgConfigBatch(pSgCfgs, dwSgNum, dwFlags, pResult);
+}
+
+WORD32 AI_ECMP_SetFtmCapability(WORD32 dwCapability) {
+    // 按FTM声明的能力选择下一跳修改的下发格式
+    return CAISlbManagerSingleton::getManagerInstance().setFtmCapability(dwCapability);
+}
+
 // WORD32 ftm_sgWeightModifyCtrl(T_AI_ECMP_WEIGHT_MODIFY* pOpParam, T_AI_ECMP_SG_CFG* pSgCfg) {
 //     // 此函数应由UFP L1(SG)模块实现，这里仅作示例
 //     // 在实际项目中，此函数将由外部模块提供
@@ -35,10 +48,8 @@ WORD32 AI_ECMP_SgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_SG_CFG* pSgCfg) {
 // }
 
 WORD32 ftm_aiEcmpGetAllStatus(void* pStatusBuffer, WORD32 dwBufferSize) {
-    // 获取所有实例状态信息
-    // TODO: 实现状态信息获取逻辑
-    
-    return EcmpManager::getManagerInstance().getInstanceCount();
+    // 从状态发布板复制定长记录：一次有界的memcpy，不遍历实例、不加锁
+    return CAISlbManagerSingleton::getManagerInstance().getStatusBoard().exportTo(pStatusBuffer, dwBufferSize);
 }
 
 } // extern "C"
@@ -0,0 +1,149 @@
+#include "ai_ecmp_batch.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ai_ecmp {
+
+constexpr double NhopBatcher::DEFAULT_DELTA_MAX_SHARE;
+
+// 单条记录最大时也必须能放入一条消息（增量门限最大为1，增量记录最长为全部表项的（下标，端口）对）
+static_assert(sizeof(T_AI_ECMP_NHOP_BATCH_HDR) + sizeof(T_AI_ECMP_NHOP_BATCH_REC)
+                  + FTM_TRUNK_MAX_HASH_NUM_15K * sizeof(T_AI_ECMP_NHOP_DELTA_ITEM) <= AI_ECMP_NHOP_BATCH_MAX_LEN,
+              "nhop batch message cannot hold a full record");
+
+NhopBatcher::NhopBatcher()
+    : m_cfg{false, false, DEFAULT_DELTA_MAX_SHARE}
+    , m_stats() {
+}
+
+void NhopBatcher::configure(const T_AI_ECMP_BATCH_CFG& cfg) {
+    m_cfg = cfg;
+    // 增量记录只能放在批量消息中
+    m_cfg.bDelta = m_cfg.bDelta && m_cfg.bBatch;
+    m_cfg.deltaMaxShare = std::min(std::max(m_cfg.deltaMaxShare, 0.0), 1.0);
+}
+
+bool NhopBatcher::acceptDelta(const T_AI_ECMP_NHOP_DELTA& delta) const {
+    return m_cfg.bDelta && delta.dwItemNum > 0 && delta.dwChangeNum <= delta.dwItemNum &&
+           delta.dwChangeNum <= m_cfg.deltaMaxShare * delta.dwItemNum;
+}
+
+void NhopBatcher::mergeDelta(T_AI_ECMP_NHOP_DELTA& pending, const T_AI_ECMP_NHOP_DELTA& delta) {
+    for (WORD32 i = 0; i < delta.dwChangeNum; ++i) {
+        const T_AI_ECMP_NHOP_DELTA_ITEM& change = delta.astChange[i];
+        WORD32 j = 0;
+        while (j < pending.dwChangeNum && pending.astChange[j].dwIndex != change.dwIndex) {
+            ++j;
+        }
+        if (j == pending.dwChangeNum) {
+            pending.dwChangeNum++;
+        }
+        pending.astChange[j] = change;
+    }
+    pending.dwSeqId = delta.dwSeqId;
+}
+
+void NhopBatcher::add(const T_AI_ECMP_NHOP_MODIFY& modify, const T_AI_ECMP_NHOP_DELTA* pDelta) {
+    m_stats.qwSubmitted++;
+    const bool bNewDelta = pDelta && pDelta->dwItemNum == modify.dwItemNum && m_cfg.bDelta && pDelta->dwItemNum > 0;
+
+    auto it = m_positions.find(modify.dwSgId);
+    if (it != m_positions.end()) {
+        // 同一SG在本周期内的后续修改覆盖之前的修改，只下发最终结果；
+        // 待下发的是全量时，FTM侧的基准未知，只能继续全量下发
+        T_PENDING& pending = m_pending[it->second];
+        pending.full = modify;
+        if (pending.bDelta && bNewDelta) {
+            mergeDelta(pending.delta, *pDelta);
+            pending.bDelta = acceptDelta(pending.delta);
+        } else {
+            pending.bDelta = false;
+        }
+        m_stats.qwCoalesced++;
+        return;
+    }
+
+    m_positions.emplace(modify.dwSgId, m_pending.size());
+    m_pending.emplace_back();
+    T_PENDING& pending = m_pending.back();
+    pending.full = modify;
+    pending.bDelta = bNewDelta && acceptDelta(*pDelta);
+    if (pending.bDelta) {
+        pending.delta = *pDelta;
+    }
+}
+
+WORD32 NhopBatcher::flush(const Sender& sender, const ModifySender& modifySender) {
+    if (m_pending.empty()) {
+        return 0;
+    }
+
+    // FTM不支持批量消息：合并后的修改逐个全量下发
+    if (!m_cfg.bBatch) {
+        for (const T_PENDING& pending : m_pending) {
+            modifySender(pending.full);
+        }
+        const WORD32 dwMessages = static_cast<WORD32>(m_pending.size());
+        m_stats.qwMessages += dwMessages;
+        m_stats.qwRecords += dwMessages;
+        m_stats.qwBytes += static_cast<WORD64>(dwMessages) * sizeof(T_AI_ECMP_NHOP_MODIFY);
+        m_pending.clear();
+        m_positions.clear();
+        return dwMessages;
+    }
+
+    m_buffer.resize(AI_ECMP_NHOP_BATCH_MAX_LEN);
+    BYTE* pBuffer = m_buffer.data();
+    WORD32 dwMessages = 0;
+    WORD32 dwOffset = sizeof(T_AI_ECMP_NHOP_BATCH_HDR);
+    WORD32 dwRecordNum = 0;
+
+    // 消息头在消息发送前填写
+    auto sendMessage = [&]() {
+        T_AI_ECMP_NHOP_BATCH_HDR hdr = {AI_ECMP_NHOP_BATCH_MAGIC, dwRecordNum, dwOffset};
+        memcpy(pBuffer, &hdr, sizeof(hdr));
+        m_stats.qwMessages++;
+        m_stats.qwRecords += dwRecordNum;
+        m_stats.qwBytes += dwOffset;
+        dwMessages++;
+        sender(pBuffer, dwOffset);
+        dwOffset = sizeof(T_AI_ECMP_NHOP_BATCH_HDR);
+        dwRecordNum = 0;
+    };
+
+    for (const T_PENDING& pending : m_pending) {
+        const T_AI_ECMP_NHOP_MODIFY& modify = pending.full;
+        const WORD32 dwItemNum = std::min(modify.dwItemNum, FTM_TRUNK_MAX_HASH_NUM_15K);
+        T_AI_ECMP_NHOP_BATCH_REC rec = {modify.dwSgId, modify.dwSeqId, dwItemNum, AI_ECMP_NHOP_REC_FULL, dwItemNum};
+        const void* pEntries = modify.adwLinkItem;
+        WORD32 dwEntryLen = dwItemNum * sizeof(WORD32);
+        if (pending.bDelta) {
+            rec.dwRecType = AI_ECMP_NHOP_REC_DELTA;
+            rec.dwEntryNum = pending.delta.dwChangeNum;
+            pEntries = pending.delta.astChange;
+            dwEntryLen = pending.delta.dwChangeNum * sizeof(T_AI_ECMP_NHOP_DELTA_ITEM);
+            m_stats.qwDeltaRecords++;
+            m_stats.qwDeltaEntries += pending.delta.dwChangeNum;
+        } else if (m_cfg.bDelta) {
+            m_stats.qwFullFallbacks++;
+        }
+
+        const WORD32 dwRecordLen = sizeof(T_AI_ECMP_NHOP_BATCH_REC) + dwEntryLen;
+        if (dwOffset + dwRecordLen > AI_ECMP_NHOP_BATCH_MAX_LEN) {
+            sendMessage();
+        }
+
+        memcpy(pBuffer + dwOffset, &rec, sizeof(rec));
+        memcpy(pBuffer + dwOffset + sizeof(rec), pEntries, dwEntryLen);
+        dwOffset += dwRecordLen;
+        dwRecordNum++;
+    }
+    sendMessage();
+
+    // 只清空内容，保留容量供下个周期复用
+    m_pending.clear();
+    m_positions.clear();
+    return dwMessages;
+}
+
+} // namespace ai_ecmp
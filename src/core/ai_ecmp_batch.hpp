@@ -0,0 +1,115 @@
+#ifndef AI_ECMP_BATCH_HPP
+#define AI_ECMP_BATCH_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 下一跳修改下发配置
+ */
+typedef struct {
+    bool bBatch;                        /* 是否使用批量消息（FTM声明支持批量消息时启用，否则逐个SG全量下发） */
+    bool bDelta;                        /* 是否使用增量记录（FTM声明支持批量消息和增量时启用） */
+    double deltaMaxShare;               /* 变化表项占比超过该值时回退为全量记录 */
+} T_AI_ECMP_BATCH_CFG;
+
+/**
+ * 下一跳修改下发统计（累计）
+ */
+typedef struct {
+    WORD64 qwSubmitted;                 /* 提交的修改数 */
+    WORD64 qwCoalesced;                 /* 被同一SG后续修改覆盖的修改数 */
+    WORD64 qwRecords;                   /* 实际下发的记录数 */
+    WORD64 qwDeltaRecords;              /* 其中的增量记录数 */
+    WORD64 qwDeltaEntries;              /* 增量记录携带的表项数 */
+    WORD64 qwFullFallbacks;             /* 启用增量时仍按全量下发的记录数（变化过多或成员数变化） */
+    WORD64 qwMessages;                  /* 下发的消息数 */
+    WORD64 qwBytes;                     /* 下发的总字节数 */
+} T_AI_ECMP_BATCH_STATS;
+
+/**
+ * 下一跳修改批量下发
+ * 收集一个处理周期内产生的所有下一跳修改，同一SG的多次修改只保留最后一次；
+ * 提交时按实际逻辑成员数紧凑打包为带批量消息头的消息，单条消息不超过 AI_ECMP_NHOP_BATCH_MAX_LEN，
+ * 多个SG同时调整时只需一条或少数几条消息。
+ * FTM支持增量时，只有少量表项变化的SG以（下标，端口）对下发，变化过多或无法生成增量时回退为全量记录。
+ * FTM不支持批量消息时，合并后的修改逐个以T_AI_ECMP_NHOP_MODIFY下发。
+ * 打包按主机字节序进行，字节序转换由发送函数负责
+ */
+class NhopBatcher {
+public:
+    /** 发送函数：pMsg为可原地修改的消息缓冲区，dwLen为消息实际长度 */
+    typedef std::function<void(BYTE* pMsg, WORD32 dwLen)> Sender;
+
+    /** 逐个下发函数：不使用批量消息时每个SG的修改调用一次 */
+    typedef std::function<void(const T_AI_ECMP_NHOP_MODIFY& modify)> ModifySender;
+
+    /** 默认增量门限：一个（下标，端口）对是全量表项的两倍长，变化超过一半时全量更短 */
+    static constexpr double DEFAULT_DELTA_MAX_SHARE = 0.5;
+
+    NhopBatcher();
+
+    /**
+     * @brief 设置下发配置，参数越界时收敛到有效范围
+     * @param cfg 下发配置
+     */
+    void configure(const T_AI_ECMP_BATCH_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_BATCH_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 加入一个下一跳修改（同一SG已有待下发修改时覆盖）
+     * 同一SG的增量与待下发增量合并；待下发的是全量或新修改无法增量下发时按全量下发
+     * @param modify 下一跳修改（全量成员表）
+     * @param pDelta 相对已下发成员表的增量，为空表示只能全量下发
+     */
+    void add(const T_AI_ECMP_NHOP_MODIFY& modify, const T_AI_ECMP_NHOP_DELTA* pDelta = nullptr);
+
+    /**
+     * @brief 是否有待下发的修改
+     */
+    bool empty() const { return m_pending.empty(); }
+
+    /**
+     * @brief 打包并下发所有待下发的修改，然后清空
+     * @param sender 批量消息发送函数，每条消息调用一次
+     * @param modifySender 逐个下发函数，未启用批量消息时每个SG调用一次
+     * @return 下发的消息数
+     */
+    WORD32 flush(const Sender& sender, const ModifySender& modifySender);
+
+    /**
+     * @brief 获取下发统计
+     */
+    const T_AI_ECMP_BATCH_STATS& getStats() const { return m_stats; }
+
+private:
+    typedef struct {
+        T_AI_ECMP_NHOP_MODIFY full;     /* 全量成员表（总是保留，用于回退） */
+        T_AI_ECMP_NHOP_DELTA delta;     /* 相对已下发成员表的累计增量 */
+        bool bDelta;                    /* 是否按增量下发 */
+    } T_PENDING;
+
+    // 增量是否可用且未超过门限
+    bool acceptDelta(const T_AI_ECMP_NHOP_DELTA& delta) const;
+
+    // 把增量合并到待下发增量（同一表项以后者为准）
+    static void mergeDelta(T_AI_ECMP_NHOP_DELTA& pending, const T_AI_ECMP_NHOP_DELTA& delta);
+
+    T_AI_ECMP_BATCH_CFG m_cfg;
+    std::vector<T_PENDING> m_pending;                   /* 待下发的修改（按首次提交顺序） */
+    std::unordered_map<WORD32, size_t> m_positions;     /* SG ID -> 待下发修改的下标 */
+    std::vector<BYTE> m_buffer;                         /* 消息打包缓冲区（跨周期复用） */
+    T_AI_ECMP_BATCH_STATS m_stats;
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_BATCH_HPP */
@@ -0,0 +1,94 @@
+#include "ai_ecmp_elephant.hpp"
+#include <algorithm>
+
+namespace ai_ecmp {
+
+constexpr WORD32 ElephantDetector::MAX_ELEPHANTS;
+
+ElephantDetector::ElephantDetector()
+    : m_totalShare(0.0) {
+    // 默认：单桶达到端口平均负载的一半即视为大流，降到30%以下才退出
+    T_AI_ECMP_ELEPHANT_CFG cfg = {true, 0.5, 0.3};
+    configure(cfg);
+}
+
+void ElephantDetector::configure(const T_AI_ECMP_ELEPHANT_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.enterShare = std::max(m_cfg.enterShare, 0.05);
+    m_cfg.exitShare = std::min(std::max(m_cfg.exitShare, 0.0), m_cfg.enterShare);
+    reset(m_mask.size());
+}
+
+void ElephantDetector::reset(size_t bucketNum) {
+    m_totalShare = 0.0;
+    m_elephants.clear();
+
+    if (!m_cfg.bEnable || bucketNum == 0) {
+        std::vector<BYTE>().swap(m_mask);
+        std::vector<WORD32>().swap(m_elephants);
+        return;
+    }
+
+    m_mask.assign(bucketNum, 0);
+    m_elephants.reserve(MAX_ELEPHANTS);
+}
+
+void ElephantDetector::update(const std::vector<WORD64>& loads, WORD32 dwPortNum) {
+    if (!m_cfg.bEnable || loads.empty() || loads.size() != m_mask.size()) {
+        return;
+    }
+
+    WORD64 qwTotal = 0;
+    for (WORD64 qwLoad : loads) {
+        qwTotal += qwLoad;
+    }
+
+    // 单端口或无流量时不存在需要特殊放置的大流
+    if (dwPortNum < 2 || qwTotal == 0) {
+        std::fill(m_mask.begin(), m_mask.end(), 0);
+        m_elephants.clear();
+        m_totalShare = 0.0;
+        return;
+    }
+
+    // 桶数与端口数接近时端口平均负载只相当于少数几个桶，门限同时不低于桶平均负载的MIN_BUCKET_RATIO倍，
+    // 避免把普通的随机波动识别为大流；退出门限按同一比例缩放以保持迟滞
+    const double portAvg = static_cast<double>(qwTotal) / dwPortNum;
+    const double bucketAvg = static_cast<double>(qwTotal) / loads.size();
+    const double enterLoad = std::max(m_cfg.enterShare * portAvg, MIN_BUCKET_RATIO * bucketAvg);
+    const double exitLoad = enterLoad * (m_cfg.exitShare / m_cfg.enterShare);
+
+    // 先按退出门限剔除已有大流桶（保持加入顺序）
+    size_t dwKept = 0;
+    for (size_t i = 0; i < m_elephants.size(); ++i) {
+        WORD32 dwIndex = m_elephants[i];
+        if (static_cast<double>(loads[dwIndex]) < exitLoad) {
+            m_mask[dwIndex] = 0;
+        } else {
+            m_elephants[dwKept++] = dwIndex;
+        }
+    }
+    m_elephants.resize(dwKept);
+
+    // 再按进入门限加入新的大流桶
+    for (size_t i = 0; i < loads.size() && m_elephants.size() < MAX_ELEPHANTS; ++i) {
+        if (!m_mask[i] && static_cast<double>(loads[i]) >= enterLoad) {
+            m_mask[i] = 1;
+            m_elephants.push_back(static_cast<WORD32>(i));
+        }
+    }
+
+    WORD64 qwElephantLoad = 0;
+    for (WORD32 dwIndex : m_elephants) {
+        qwElephantLoad += loads[dwIndex];
+    }
+    m_totalShare = static_cast<double>(qwElephantLoad) / qwTotal;
+}
+
+size_t ElephantDetector::getMemoryFootprint() const {
+    return sizeof(*this)
+        + m_mask.capacity() * sizeof(BYTE)
+        + m_elephants.capacity() * sizeof(WORD32);
+}
+
+} // namespace ai_ecmp
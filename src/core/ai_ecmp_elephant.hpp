@@ -0,0 +1,89 @@
+#ifndef AI_ECMP_ELEPHANT_HPP
+#define AI_ECMP_ELEPHANT_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 大流桶检测配置
+ * 门限均相对于端口平均负载（总负载/端口数，且进入门限不低于桶平均负载的固定倍数），进入门限高于退出门限形成迟滞，
+ * 避免负载在门限附近波动时大流集合反复变化
+ */
+typedef struct {
+    bool bEnable;                       /* 是否启用大流检测 */
+    double enterShare;                  /* 进入门限：桶负载 >= enterShare * 端口平均负载 */
+    double exitShare;                   /* 退出门限：桶负载 < exitShare * 端口平均负载 */
+} T_AI_ECMP_ELEPHANT_CFG;
+
+/**
+ * 大流桶检测
+ * 在每桶负载估计上按相对门限（带迟滞）识别少数承载大比例流量的桶。
+ * 状态按桶数一次性分配，每周期 O(桶数) 且不分配内存
+ */
+class ElephantDetector {
+public:
+    /** 大流桶数量上限，超过后不再加入新的大流桶 */
+    static constexpr WORD32 MAX_ELEPHANTS = 32;
+
+    ElephantDetector();
+
+    /**
+     * @brief 设置检测配置，门限越界时收敛到有效范围，并清空已有大流集合
+     * @param cfg 检测配置
+     */
+    void configure(const T_AI_ECMP_ELEPHANT_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_ELEPHANT_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 按桶数重置检测状态（未启用时不分配）
+     * @param bucketNum 桶数
+     */
+    void reset(size_t bucketNum);
+
+    /**
+     * @brief 按本周期每桶负载更新大流集合
+     * @param loads 每桶负载估计，长度与reset时不一致时忽略
+     * @param dwPortNum 端口数
+     */
+    void update(const std::vector<WORD64>& loads, WORD32 dwPortNum);
+
+    /**
+     * @brief 获取大流桶掩码（以hash_index为下标，非0表示大流桶；未启用时为空）
+     */
+    const std::vector<BYTE>& getMask() const { return m_mask; }
+
+    /**
+     * @brief 获取大流桶的hash_index列表（按加入顺序）
+     */
+    const std::vector<WORD32>& getElephants() const { return m_elephants; }
+
+    /**
+     * @brief 获取大流桶负载之和占总负载的比例（最近一次更新）
+     */
+    double getTotalShare() const { return m_totalShare; }
+
+    /**
+     * @brief 获取检测器占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+private:
+    // 进入门限下限：桶平均负载的倍数
+    static constexpr double MIN_BUCKET_RATIO = 4.0;
+
+    T_AI_ECMP_ELEPHANT_CFG m_cfg;
+
+    double m_totalShare;                /* 大流桶负载占比 */
+    std::vector<BYTE> m_mask;           /* 大流桶掩码（hash_index -> 0/1） */
+    std::vector<WORD32> m_elephants;    /* 大流桶hash_index列表 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_ELEPHANT_HPP */
@@ -0,0 +1,145 @@
+#include "ai_ecmp_forecaster.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ai_ecmp {
+
+constexpr WORD32 LoadForecaster::MAX_SEASON_CYCLES;
+
+LoadForecaster::LoadForecaster()
+    : m_dwSamples(0)
+    , m_dwSeasonPos(0) {
+    // 默认：Holt线性趋势，跟随流量迁移的同时抑制单周期抖动
+    T_AI_ECMP_FORECAST_CFG cfg = {AI_ECMP_FORECAST_HOLT, 0.5, 0.2, 0.3, 0};
+    configure(cfg);
+}
+
+void LoadForecaster::configure(const T_AI_ECMP_FORECAST_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.alpha = std::min(std::max(m_cfg.alpha, 0.01), 1.0);
+    m_cfg.beta = std::min(std::max(m_cfg.beta, 0.0), 1.0);
+    m_cfg.gamma = std::min(std::max(m_cfg.gamma, 0.0), 1.0);
+    m_cfg.dwSeasonCycles = std::min(m_cfg.dwSeasonCycles, MAX_SEASON_CYCLES);
+
+    // 季节长度不足2时没有季节性可言，退化为Holt
+    if (m_cfg.eType == AI_ECMP_FORECAST_HOLT_WINTERS && m_cfg.dwSeasonCycles < 2) {
+        m_cfg.eType = AI_ECMP_FORECAST_HOLT;
+    }
+
+    reset(m_forecast.size());
+}
+
+void LoadForecaster::reset(size_t bucketNum) {
+    m_dwSamples = 0;
+    m_dwSeasonPos = 0;
+    m_error = {0, 0.0, 0.0, 0.0};
+
+    if (m_cfg.eType == AI_ECMP_FORECAST_NONE || bucketNum == 0) {
+        std::vector<double>().swap(m_level);
+        std::vector<double>().swap(m_trend);
+        std::vector<double>().swap(m_season);
+        std::vector<WORD64>().swap(m_forecast);
+        return;
+    }
+
+    m_level.assign(bucketNum, 0.0);
+    m_trend.assign(bucketNum, 0.0);
+    m_forecast.assign(bucketNum, 0);
+    if (m_cfg.eType == AI_ECMP_FORECAST_HOLT_WINTERS) {
+        m_season.assign(bucketNum * m_cfg.dwSeasonCycles, 0.0);
+    } else {
+        std::vector<double>().swap(m_season);
+    }
+}
+
+void LoadForecaster::update(const WORD64* pCurrent, const WORD64* pPrevious, size_t bucketNum) {
+    if (m_cfg.eType == AI_ECMP_FORECAST_NONE || bucketNum == 0 || bucketNum != m_forecast.size()) {
+        return;
+    }
+
+    const bool bSeasonal = (m_cfg.eType == AI_ECMP_FORECAST_HOLT_WINTERS);
+    const WORD32 dwSeason = m_cfg.dwSeasonCycles;
+    const WORD32 dwNextPos = bSeasonal ? (m_dwSeasonPos + 1) % dwSeason : 0;
+    const double alpha = m_cfg.alpha;
+    const double beta = m_cfg.beta;
+    const double gamma = m_cfg.gamma;
+
+    // 上一周期给出的预测与本周期实际值的误差（首个样本没有预测可比）
+    double sumAbsError = 0.0;
+    double sumError = 0.0;
+    double sumActual = 0.0;
+
+    for (size_t i = 0; i < bucketNum; ++i) {
+        WORD64 qwRate = pCurrent[i] >= pPrevious[i] ? pCurrent[i] - pPrevious[i] : pCurrent[i];
+        double y = static_cast<double>(qwRate);
+
+        if (m_dwSamples > 0) {
+            double err = static_cast<double>(m_forecast[i]) - y;
+            sumAbsError += std::abs(err);
+            sumError += err;
+            sumActual += y;
+        }
+
+        double& level = m_level[i];
+        double& trend = m_trend[i];
+
+        if (m_dwSamples == 0) {
+            level = y;
+            trend = 0.0;
+        } else {
+            double seasonal = bSeasonal ? m_season[i * dwSeason + m_dwSeasonPos] : 0.0;
+            double prevLevel = level;
+            level = alpha * (y - seasonal) + (1.0 - alpha) * (level + trend);
+            trend = beta * (level - prevLevel) + (1.0 - beta) * trend;
+            if (bSeasonal) {
+                m_season[i * dwSeason + m_dwSeasonPos] = gamma * (y - level) + (1.0 - gamma) * seasonal;
+            }
+        }
+
+        double forecast = level + trend + (bSeasonal ? m_season[i * dwSeason + dwNextPos] : 0.0);
+        m_forecast[i] = forecast > 0.0 ? static_cast<WORD64>(forecast + 0.5) : 0;
+    }
+
+    if (m_dwSamples > 0 && sumActual > 0.0) {
+        double wape = sumAbsError / sumActual;
+        double bias = sumError / sumActual;
+        if (m_error.dwSamples == 0) {
+            m_error.avgWape = wape;
+            m_error.avgBias = bias;
+        } else {
+            m_error.avgWape += ERROR_SMOOTHING * (wape - m_error.avgWape);
+            m_error.avgBias += ERROR_SMOOTHING * (bias - m_error.avgBias);
+        }
+        m_error.lastWape = wape;
+        m_error.dwSamples++;
+    }
+
+    m_dwSeasonPos = dwNextPos;
+    m_dwSamples++;
+}
+
+bool LoadForecaster::isReady() const {
+    if (m_cfg.eType == AI_ECMP_FORECAST_NONE || m_forecast.empty()) {
+        return false;
+    }
+    // Holt至少需要两个样本才有趋势；Holt-Winters需要完整走过一个季节
+    WORD32 dwMinSamples = (m_cfg.eType == AI_ECMP_FORECAST_HOLT_WINTERS) ? m_cfg.dwSeasonCycles + 1 : 2;
+    return m_dwSamples >= dwMinSamples;
+}
+
+size_t LoadForecaster::getMemoryFootprint() const {
+    return sizeof(*this)
+        + (m_level.capacity() + m_trend.capacity() + m_season.capacity()) * sizeof(double)
+        + m_forecast.capacity() * sizeof(WORD64);
+}
+
+const char* LoadForecaster::typeToString(T_AI_ECMP_FORECAST_TYPE eType) {
+    switch (eType) {
+        case AI_ECMP_FORECAST_NONE:         return "NONE";
+        case AI_ECMP_FORECAST_HOLT:         return "HOLT";
+        case AI_ECMP_FORECAST_HOLT_WINTERS: return "HOLT_WINTERS";
+        default:                            return "UNKNOWN";
+    }
+}
+
+} // namespace ai_ecmp
@@ -0,0 +1,125 @@
+#ifndef AI_ECMP_FORECASTER_HPP
+#define AI_ECMP_FORECASTER_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 负载预测类型
+ */
+typedef enum {
+    AI_ECMP_FORECAST_NONE = 0,      /* 不预测，优化器直接使用负载模型估计 */
+    AI_ECMP_FORECAST_HOLT,          /* Holt线性趋势 */
+    AI_ECMP_FORECAST_HOLT_WINTERS   /* 加法季节性Holt-Winters */
+} T_AI_ECMP_FORECAST_TYPE;
+
+/**
+ * 负载预测配置
+ */
+typedef struct {
+    T_AI_ECMP_FORECAST_TYPE eType;      /* 预测类型 */
+    double alpha;                       /* 水平平滑系数 (0,1] */
+    double beta;                        /* 趋势平滑系数 [0,1] */
+    double gamma;                       /* 季节平滑系数 [0,1]，仅Holt-Winters */
+    WORD32 dwSeasonCycles;              /* 季节周期长度（周期数），仅Holt-Winters */
+} T_AI_ECMP_FORECAST_CFG;
+
+/**
+ * 预测误差统计（按全部桶汇总，WAPE = sum|实际-预测| / sum实际）
+ */
+typedef struct {
+    WORD32 dwSamples;                   /* 已评估的预测次数 */
+    double lastWape;                    /* 最近一个周期的WAPE */
+    double avgWape;                     /* WAPE的指数平滑值 */
+    double avgBias;                     /* 相对偏差(预测-实际)/实际的指数平滑值，正值表示高估 */
+} T_AI_ECMP_FORECAST_ERROR;
+
+/**
+ * 每桶短期负载预测
+ * 输入为计数器历史中相邻两个周期的累计计数，差分得到本周期速率，
+ * 增量更新每桶的水平/趋势（及季节）分量，输出下一周期的速率预测。
+ * 状态按桶数一次性分配，每周期 O(桶数) 且不分配内存
+ */
+class LoadForecaster {
+public:
+    /** 最大季节周期长度（周期数） */
+    static constexpr WORD32 MAX_SEASON_CYCLES = 32;
+
+    LoadForecaster();
+
+    /**
+     * @brief 设置预测配置，参数越界时收敛到有效范围，并清空已有状态
+     * @param cfg 预测配置
+     */
+    void configure(const T_AI_ECMP_FORECAST_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_FORECAST_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 按桶数重置预测状态（未启用预测时不分配）
+     * @param bucketNum 桶数
+     */
+    void reset(size_t bucketNum);
+
+    /**
+     * @brief 输入相邻两个周期的累计计数，更新每桶预测
+     * @param pCurrent 本周期各桶累计计数
+     * @param pPrevious 上一周期各桶累计计数（计数回绕或清零时按新值计为本周期增量）
+     * @param bucketNum 桶数，与reset时不一致时忽略本次输入
+     */
+    void update(const WORD64* pCurrent, const WORD64* pPrevious, size_t bucketNum);
+
+    /**
+     * @brief 预测是否可用（已启用且积累了足够样本）
+     */
+    bool isReady() const;
+
+    /**
+     * @brief 获取每桶下一周期的速率预测
+     * @return 预测值数组（与桶数等长）
+     */
+    const std::vector<WORD64>& getForecast() const { return m_forecast; }
+
+    /**
+     * @brief 获取预测误差统计
+     */
+    const T_AI_ECMP_FORECAST_ERROR& getError() const { return m_error; }
+
+    /**
+     * @brief 获取已输入的速率样本数
+     */
+    WORD32 getSampleCount() const { return m_dwSamples; }
+
+    /**
+     * @brief 获取预测器占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @brief 获取预测类型名称
+     */
+    static const char* typeToString(T_AI_ECMP_FORECAST_TYPE eType);
+
+private:
+    // 误差统计的平滑系数
+    static constexpr double ERROR_SMOOTHING = 0.2;
+
+    T_AI_ECMP_FORECAST_CFG m_cfg;
+    T_AI_ECMP_FORECAST_ERROR m_error;
+
+    WORD32 m_dwSamples;                 /* 速率样本数 */
+    WORD32 m_dwSeasonPos;               /* 当前周期在季节内的位置 */
+    std::vector<double> m_level;        /* 每桶水平分量 */
+    std::vector<double> m_trend;        /* 每桶趋势分量 */
+    std::vector<double> m_season;       /* 每桶季节分量（桶 x 季节长度，按桶连续存放，仅Holt-Winters分配） */
+    std::vector<WORD64> m_forecast;     /* 对外的每桶下一周期预测 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_FORECASTER_HPP */
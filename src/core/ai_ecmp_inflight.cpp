@@ -0,0 +1,116 @@
+#include "ai_ecmp_inflight.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace ai_ecmp {
+
+constexpr WORD32 InflightTracker::DEFAULT_TIMEOUT_MS;
+constexpr WORD32 InflightTracker::DEFAULT_MAX_RETRIES;
+
+// 超时下限：低于一个定时器节拍没有意义
+static const WORD32 MIN_TIMEOUT_MS = 100;
+
+InflightTracker::InflightTracker()
+    : m_cfg{DEFAULT_TIMEOUT_MS, DEFAULT_MAX_RETRIES}
+    , m_state()
+    , m_stats() {
+}
+
+void InflightTracker::configure(const T_AI_ECMP_INFLIGHT_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.dwTimeoutMs = std::max(m_cfg.dwTimeoutMs, MIN_TIMEOUT_MS);
+}
+
+WORD64 InflightTracker::nowMicros() {
+    return static_cast<WORD64>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void InflightTracker::begin(const T_AI_ECMP_NHOP_MODIFY& nhopModify, const std::vector<WORD32>& confirmedTable,
+                            WORD32 dwCycle) {
+    const WORD64 qwNow = nowMicros();
+    if (m_state.bActive) {
+        // 上一次修改未确认，确认基准和首次下发时刻保持不变
+        m_stats.qwSuperseded++;
+    } else {
+        m_confirmedTable = confirmedTable;
+        m_state.qwFirstSendMicros = qwNow;
+        m_state.dwSendCycle = dwCycle;
+    }
+
+    const WORD32 dwItemNum = std::min(nhopModify.dwItemNum, FTM_TRUNK_MAX_HASH_NUM_15K);
+    m_pendingTable.assign(nhopModify.adwLinkItem, nhopModify.adwLinkItem + dwItemNum);
+    m_state.bActive = true;
+    m_state.dwSeqId = nhopModify.dwSeqId;
+    m_state.dwRetries = 0;
+    m_state.qwLastSendMicros = qwNow;
+    m_stats.qwSent++;
+}
+
+T_AI_ECMP_ECHO_RESULT InflightTracker::onConfigEcho(const T_AI_ECMP_SG_CFG& sgConfig) {
+    if (!m_state.bActive) {
+        return AI_ECMP_ECHO_NONE;
+    }
+
+    bool bMatch = sgConfig.dwItemNum == m_pendingTable.size();
+    for (WORD32 i = 0; bMatch && i < sgConfig.dwItemNum && i < AI_ECMP_MAX_ITEM_NUM; ++i) {
+        const WORD32 dwOffset = sgConfig.items[i].dwItemOffset;
+        bMatch = dwOffset < m_pendingTable.size() && m_pendingTable[dwOffset] == sgConfig.items[i].dwPortId;
+    }
+
+    if (bMatch) {
+        const WORD64 qwAckMicros = nowMicros() - m_state.qwFirstSendMicros;
+        m_stats.qwAcked++;
+        m_stats.qwTotalAckMicros += qwAckMicros;
+        m_stats.qwMaxAckMicros = std::max(m_stats.qwMaxAckMicros, qwAckMicros);
+        m_confirmedTable.swap(m_pendingTable);
+        m_state.bActive = false;
+        return AI_ECMP_ECHO_ACK;
+    }
+    if (sgConfig.dwSeqId == m_state.dwSeqId) {
+        return AI_ECMP_ECHO_STALE;
+    }
+
+    m_stats.qwConflicts++;
+    m_state.bActive = false;
+    return AI_ECMP_ECHO_CONFLICT;
+}
+
+bool InflightTracker::isDue(WORD64 qwNowMicros) const {
+    return m_state.bActive && qwNowMicros - m_state.qwLastSendMicros >= static_cast<WORD64>(m_cfg.dwTimeoutMs) * 1000;
+}
+
+T_AI_ECMP_INFLIGHT_ACTION InflightTracker::poll(WORD64 qwNowMicros) {
+    if (!m_state.bActive) {
+        return AI_ECMP_INFLIGHT_IDLE;
+    }
+    if (!isDue(qwNowMicros)) {
+        return AI_ECMP_INFLIGHT_WAIT;
+    }
+    if (m_state.dwRetries < m_cfg.dwMaxRetries) {
+        m_state.dwRetries++;
+        m_state.qwLastSendMicros = qwNowMicros;
+        m_stats.qwRetries++;
+        return AI_ECMP_INFLIGHT_RETRY;
+    }
+
+    m_stats.qwRollbacks++;
+    m_state.bActive = false;
+    return AI_ECMP_INFLIGHT_ROLLBACK;
+}
+
+void InflightTracker::fillPending(T_AI_ECMP_NHOP_MODIFY& nhopModify) const {
+    const WORD32 dwItemNum = static_cast<WORD32>(std::min<size_t>(m_pendingTable.size(), FTM_TRUNK_MAX_HASH_NUM_15K));
+    nhopModify.dwSeqId = m_state.dwSeqId;
+    nhopModify.dwItemNum = dwItemNum;
+    for (WORD32 i = 0; i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
+        nhopModify.adwLinkItem[i] = i < dwItemNum ? m_pendingTable[i] : 0;
+    }
+}
+
+size_t InflightTracker::getMemoryFootprint() const {
+    return sizeof(*this)
+        + (m_pendingTable.capacity() + m_confirmedTable.capacity()) * sizeof(WORD32);
+}
+
+} // namespace ai_ecmp
@@ -0,0 +1,178 @@
+#ifndef AI_ECMP_INFLIGHT_HPP
+#define AI_ECMP_INFLIGHT_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 待确认修改跟踪配置
+ */
+typedef struct {
+    WORD32 dwTimeoutMs;                 /* 等待配置回显确认的超时（毫秒） */
+    WORD32 dwMaxRetries;                /* 超时后全量重发的次数上限，用尽后回滚 */
+} T_AI_ECMP_INFLIGHT_CFG;
+
+/**
+ * 待确认的下一跳修改
+ */
+typedef struct {
+    bool bActive;                       /* 是否有待确认的修改 */
+    WORD32 dwSeqId;                     /* 下发时的配置版本号 */
+    WORD32 dwRetries;                   /* 已重发次数 */
+    WORD64 qwFirstSendMicros;           /* 首次下发时刻（单调时钟，微秒） */
+    WORD64 qwLastSendMicros;            /* 最近一次下发时刻 */
+    WORD32 dwSendCycle;                 /* 首次下发时的计数周期（确认后据此识别下发后采集的计数器周期） */
+} T_AI_ECMP_INFLIGHT_STATE;
+
+/**
+ * 待确认修改跟踪统计（累计）
+ */
+typedef struct {
+    WORD64 qwSent;                      /* 下发的修改数 */
+    WORD64 qwAcked;                     /* 被配置回显确认的修改数 */
+    WORD64 qwSuperseded;                /* 确认前被同一SG的新修改取代的修改数 */
+    WORD64 qwConflicts;                 /* 回显的成员表与待确认成员表不一致（平台已另行修改）的次数 */
+    WORD64 qwRetries;                   /* 超时重发次数 */
+    WORD64 qwRollbacks;                 /* 重发用尽后回滚的次数 */
+    WORD64 qwSkippedCycles;             /* 等待确认期间跳过的优化周期数 */
+    WORD64 qwDiscardedWindows;          /* 丢弃的跨越成员表切换的计数器周期数 */
+    WORD64 qwTotalAckMicros;            /* 累计确认耗时（首次下发到确认） */
+    WORD64 qwMaxAckMicros;              /* 最大确认耗时 */
+} T_AI_ECMP_INFLIGHT_STATS;
+
+/**
+ * 配置回显的判定结果
+ */
+typedef enum {
+    AI_ECMP_ECHO_NONE = 0,              /* 没有待确认的修改 */
+    AI_ECMP_ECHO_ACK,                   /* 回显的成员表与待确认成员表一致，修改已生效 */
+    AI_ECMP_ECHO_STALE,                 /* 版本号未变化且成员表不一致，FTM尚未处理，继续等待 */
+    AI_ECMP_ECHO_CONFLICT               /* 版本号已变化但成员表不一致，以平台配置为准放弃跟踪 */
+} T_AI_ECMP_ECHO_RESULT;
+
+/**
+ * 超时检查的处理动作
+ */
+typedef enum {
+    AI_ECMP_INFLIGHT_IDLE = 0,          /* 没有待确认的修改 */
+    AI_ECMP_INFLIGHT_WAIT,              /* 未超时，继续等待 */
+    AI_ECMP_INFLIGHT_RETRY,             /* 已超时，全量重发待确认成员表 */
+    AI_ECMP_INFLIGHT_ROLLBACK           /* 重发用尽，回滚到最近确认的成员表并全量下发 */
+} T_AI_ECMP_INFLIGHT_ACTION;
+
+/**
+ * 下一跳修改的在途跟踪
+ * 下发后记录待确认的成员表、版本号和下发时刻，平台按修改更新硬件表后经SG配置回显，
+ * 回显的成员表与待确认成员表一致时确认生效；确认前该SG暂停优化，不在旧硬件表的计数上重复优化，
+ * 也不会连续写入互相冲突的修改。超时未确认时全量重发（FTM侧成员表未知，不能增量），
+ * 重发用尽后回滚到最近确认的成员表并全量下发，同样等待回显确认。
+ * 多次下发未确认时保留最早的确认基准，取代的修改计入统计
+ */
+class InflightTracker {
+public:
+    /** 默认确认超时（毫秒）和重发次数 */
+    static constexpr WORD32 DEFAULT_TIMEOUT_MS = 3000;
+    static constexpr WORD32 DEFAULT_MAX_RETRIES = 2;
+
+    InflightTracker();
+
+    /**
+     * @brief 设置跟踪配置，参数越界时收敛到有效范围
+     * @param cfg 跟踪配置
+     */
+    void configure(const T_AI_ECMP_INFLIGHT_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_INFLIGHT_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 记录一次下发，开始等待确认
+     * @param nhopModify 下发的修改
+     * @param confirmedTable 下发前FTM侧的成员表（已有待确认修改时沿用原确认基准）
+     * @param dwCycle 下发时的计数周期（已有待确认修改时沿用首次下发的周期）
+     */
+    void begin(const T_AI_ECMP_NHOP_MODIFY& nhopModify, const std::vector<WORD32>& confirmedTable, WORD32 dwCycle);
+
+    /**
+     * @brief 判定SG配置回显是否确认了待确认的修改（确认或冲突时结束跟踪）
+     * @param sgConfig 平台下发的SG配置
+     */
+    T_AI_ECMP_ECHO_RESULT onConfigEcho(const T_AI_ECMP_SG_CFG& sgConfig);
+
+    /**
+     * @brief 检查是否超时：超时且可重发时更新重发计数和下发时刻，重发用尽时结束跟踪
+     * @param qwNowMicros 当前时刻（单调时钟，微秒）
+     */
+    T_AI_ECMP_INFLIGHT_ACTION poll(WORD64 qwNowMicros);
+
+    /**
+     * @brief 是否已超时（用于调度器优先处理待重发的SG）
+     */
+    bool isDue(WORD64 qwNowMicros) const;
+
+    /**
+     * @brief 是否有待确认的修改
+     */
+    bool isActive() const { return m_state.bActive; }
+
+    /**
+     * @brief 按待确认成员表填写全量重发的修改
+     * @param nhopModify 输出参数
+     */
+    void fillPending(T_AI_ECMP_NHOP_MODIFY& nhopModify) const;
+
+    /**
+     * @brief 待确认的成员表
+     */
+    const std::vector<WORD32>& getPendingTable() const { return m_pendingTable; }
+
+    /**
+     * @brief 最近确认的成员表（回滚目标）
+     */
+    const std::vector<WORD32>& getConfirmedTable() const { return m_confirmedTable; }
+
+    /**
+     * @brief 记录等待确认期间跳过的优化周期
+     */
+    void recordSkippedCycle() { m_stats.qwSkippedCycles++; }
+
+    /**
+     * @brief 记录丢弃的计数器周期
+     */
+    void recordDiscardedWindows(WORD32 dwWindows) { m_stats.qwDiscardedWindows += dwWindows; }
+
+    /**
+     * @brief 获取跟踪状态
+     */
+    const T_AI_ECMP_INFLIGHT_STATE& getState() const { return m_state; }
+
+    /**
+     * @brief 获取跟踪统计
+     */
+    const T_AI_ECMP_INFLIGHT_STATS& getStats() const { return m_stats; }
+
+    /**
+     * @brief 获取跟踪器占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @brief 单调时钟当前时刻（微秒）
+     */
+    static WORD64 nowMicros();
+
+private:
+    T_AI_ECMP_INFLIGHT_CFG m_cfg;
+    T_AI_ECMP_INFLIGHT_STATE m_state;
+    T_AI_ECMP_INFLIGHT_STATS m_stats;
+    std::vector<WORD32> m_pendingTable;                 /* 待确认的成员表 */
+    std::vector<WORD32> m_confirmedTable;               /* 最近确认的成员表 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_INFLIGHT_HPP */
@@ -12,34 +12,171 @@
 namespace ai_ecmp {
 
 EcmpInstance::EcmpInstance(const T_AI_ECMP_SG_CFG& sgConfig)
-    : m_sgConfig(sgConfig)
-    , m_status(AI_ECMP_INIT)
+    : m_status(AI_ECMP_INIT)
     , m_wCycle(0)
-    , m_pPrinter(std::unique_ptr<EcmpPrinter>(new EcmpPrinter(sgConfig.dwSgId)))
+    , m_wBalancedCycles(0)
+    , m_wHistoryHead(0)
+    , m_wHistoryNum(0)
     , m_lastExpandCycle(0)
     , m_adjustCyclesAfterExpansion(0)
     , m_consecutiveAdjustFailures(0)
     , m_inPostExpansionPeriod(false)
     , m_bOptimizationEnabled(true)      // 默认启用优化
+    , m_bPendingRebalance(false)
+    , m_bPendingFailover(false)
+    , m_bReportEnabled(true)
     , m_dwDisabledCycles(0)              // 初始化禁用计数
+    , m_pCold(std::unique_ptr<ColdState>(new ColdState()))
 {
-    // 初始化内部数据结构
-    convertConfig();
+    // 初始化内部数据结构（计数器相关状态在首次收到计数时分配）
+    setSgHeader(sgConfig);
+    convertConfig(sgConfig);
+    syncDeliveredTable(sgConfig);
     // 初始化评估指标
     m_lastEval = {0.0, 0.0, 0.0, 0.0, 0.0};
 }
 
 void EcmpInstance::updateConfig(const T_AI_ECMP_SG_CFG& sgConfig) {
-    m_sgConfig = sgConfig;
-    convertConfig();
-    // 清空计数器历史
-    m_counterHistory.clear();
-    m_wCycle = 0;
-    // 重置扩容相关状态
-    m_lastExpandCycle = 0;
-    m_adjustCyclesAfterExpansion = 0;
-    m_consecutiveAdjustFailures = 0;
-    m_inPostExpansionPeriod = false;
+    // 平台配置反映硬件表的实际内容，先据此判定待确认的修改是否已生效
+    const T_AI_ECMP_ECHO_RESULT echo = m_pCold->inflight.onConfigEcho(sgConfig);
+    if (echo == AI_ECMP_ECHO_STALE) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 配置回显版本未变化（SeqId: %u），修改尚未生效，继续等待确认\n", 
+                      m_sgConfig.dwSgId, sgConfig.dwSeqId);
+    } else if (echo == AI_ECMP_ECHO_CONFLICT) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 配置回显（SeqId: %u）与待确认成员表不一致，以平台配置为准\n", 
+                      m_sgConfig.dwSgId, sgConfig.dwSeqId);
+    }
+    
+    // 已排空的端口不再参与优化，平台配置中仍保留该端口时先将其过滤
+    std::unique_ptr<T_AI_ECMP_SG_CFG> pFiltered = excludeDrainedPort(sgConfig);
+    applyConfig(pFiltered ? *pFiltered : sgConfig);
+    // 平台配置反映硬件表的实际内容（含已排空端口），作为后续增量的基准
+    syncDeliveredTable(sgConfig);
+    
+    if (echo == AI_ECMP_ECHO_ACK) {
+        discardStaleWindows();
+    }
+}
+
+void EcmpInstance::applyConfig(const T_AI_ECMP_SG_CFG& sgConfig) {
+    WORD32 dwDiff = diffConfig(sgConfig);
+    
+    // ===== 仅有端口退出：故障快速切换，只重分配故障端口上的桶，保留计数器历史 =====
+    if (dwDiff & CFG_DIFF_PORT_DOWN) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口退出（端口数: %zu -> %u），执行故障快速切换\n", 
+                      m_sgConfig.dwSgId, m_portIdList.size(), sgConfig.dwPortNum);
+        
+        // 以新配置的映射为基础，按旧映射识别原先落在故障端口上的桶（平台可能已自行改挂）
+        std::vector<WORD32> prevTable(m_ecmpMemberTable);
+        setSgHeader(sgConfig);
+        for (WORD32 i = 0; i < sgConfig.dwItemNum && i < AI_ECMP_MAX_ITEM_NUM; ++i) {
+            WORD32 dwOffset = sgConfig.items[i].dwItemOffset;
+            if (dwOffset < m_ecmpMemberTable.size()) {
+                m_ecmpMemberTable[dwOffset] = sgConfig.items[i].dwPortId;
+            }
+        }
+        convertPortConfig(sgConfig);
+        redistributeOrphanBuckets(prevTable);
+        return;
+    }
+    
+    // ===== 结构变化（逻辑成员数或端口集合变化）：完全重置 =====
+    if (dwDiff & (CFG_DIFF_ITEM_NUM | CFG_DIFF_PORT_SET)) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 配置结构变化（成员数: %u -> %u, 端口集合%s），重置实例状态\n", 
+                      m_sgConfig.dwSgId, m_sgConfig.dwItemNum, sgConfig.dwItemNum,
+                      (dwDiff & CFG_DIFF_PORT_SET) ? "变化" : "不变");
+        
+        // 端口加入且成员数不变时，需用重置前的负载估计挑选迁移的桶
+        const bool bItemNumUnchanged = !(dwDiff & CFG_DIFF_ITEM_NUM);
+        std::vector<WORD32> oldPortIds;
+        std::vector<WORD64> oldEstimate;
+        if (bItemNumUnchanged) {
+            oldPortIds = m_portIdList;
+            oldEstimate = getMemberCounts();
+        }
+        
+        // 本实例发起的扩容/缩容生效：保留计数器历史，拆分或合并到新表项后继续使用
+        const WORD32 dwOldItemNum = static_cast<WORD32>(m_ecmpMemberTable.size());
+        const bool bResizeApplied = !(dwDiff & CFG_DIFF_PORT_SET) &&
+            m_pCold->dwResizeToItemNum != 0 &&
+            m_pCold->dwResizeFromItemNum == dwOldItemNum &&
+            m_pCold->dwResizeToItemNum == std::min<WORD32>(sgConfig.dwItemNum, AI_ECMP_MAX_ITEM_NUM) &&
+            m_rawCounters.size() == dwOldItemNum;
+        m_pCold->dwResizeFromItemNum = 0;
+        m_pCold->dwResizeToItemNum = 0;
+        std::vector<WORD64> oldHistory;
+        const WORD16 wOldHistoryHead = m_wHistoryHead;
+        const WORD16 wOldHistoryNum = m_wHistoryNum;
+        if (bResizeApplied) {
+            oldHistory.swap(m_counterHistory);
+        }
+        
+        // 计数器历史随计数器状态一并释放，下个周期按新成员数重新分配
+        setSgHeader(sgConfig);
+        convertConfig(sgConfig);
+        
+        if (bResizeApplied) {
+            carryOverResizedHistory(oldHistory, dwOldItemNum, wOldHistoryHead, wOldHistoryNum);
+            m_pCold->solutionCache.clear();
+            m_bPendingRebalance = false;
+            m_bPendingFailover = false;
+            m_wBalancedCycles = 0;
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 逻辑成员数调整生效（%u -> %zu），%u 个周期的计数器历史已迁移到新表项\n", 
+                          m_sgConfig.dwSgId, dwOldItemNum, m_ecmpMemberTable.size(), m_wHistoryNum);
+            return;
+        }
+        // 缓存的成员表基于旧配置，不再适用
+        m_pCold->solutionCache.clear();
+        m_wCycle = 0;
+        m_wBalancedCycles = 0;
+        // 重置扩容相关状态
+        m_lastExpandCycle = 0;
+        m_adjustCyclesAfterExpansion = 0;
+        m_consecutiveAdjustFailures = 0;
+        m_inPostExpansionPeriod = false;
+        m_bPendingRebalance = false;
+        m_bPendingFailover = false;
+        if (m_pCold->drain.bActive) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 配置结构变化，取消端口 %u 的排空\n", 
+                          m_sgConfig.dwSgId, m_pCold->drain.dwPortId);
+            m_pCold->drain.bActive = false;
+        }
+        
+        if (bItemNumUnchanged) {
+            assignBucketsToNewPorts(oldPortIds, oldEstimate);
+        }
+        return;
+    }
+    
+    // ===== 非结构变化：增量更新，保留计数器历史和统计 =====
+    setSgHeader(sgConfig);
+    
+    if (dwDiff & CFG_DIFF_MEMBERS) {
+        // 计数器按桶(hash_index)统计，桶换端口后历史仍然有效，只需更新映射和端口负载
+        WORD32 dwRemapped = 0;
+        for (WORD32 i = 0; i < sgConfig.dwItemNum && i < AI_ECMP_MAX_ITEM_NUM; ++i) {
+            WORD32 dwOffset = sgConfig.items[i].dwItemOffset;
+            if (dwOffset < m_ecmpMemberTable.size() && m_ecmpMemberTable[dwOffset] != sgConfig.items[i].dwPortId) {
+                m_ecmpMemberTable[dwOffset] = sgConfig.items[i].dwPortId;
+                dwRemapped++;
+            }
+        }
+        calculateLoadMetrics();
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 增量更新 %u 个逻辑成员的端口映射，保留计数器历史\n", 
+                      m_sgConfig.dwSgId, dwRemapped);
+    }
+    
+    if (dwDiff & CFG_DIFF_PORT_ATTR) {
+        // 速率变化后缓存解的得分不再可比
+        convertPortConfig(sgConfig);
+        m_pCold->solutionCache.clear();
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 增量更新端口速率/权重，保留计数器历史\n", m_sgConfig.dwSgId);
+    }
+    
+    if (dwDiff == CFG_DIFF_NONE) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 配置内容未变化（SeqId: %u），保留全部状态\n", 
+                      m_sgConfig.dwSgId, m_sgConfig.dwSeqId);
+    }
 }
 
 void EcmpInstance::setAlgorithm(std::unique_ptr<AlgorithmBase>&& pAlgorithm) {
@@ -50,16 +187,17 @@ bool EcmpInstance::updateCounters(T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg) {
     // 从Counter获取接口读取当前的流量计数
     // 这里假设已经有了获取计数的接口
     
-    // 保存当前计数器状态
-    std::vector<WORD64> currentCounts(m_memberCounts.size());
+    // 计数器相关状态在首次收到计数时分配
+    if (m_rawCounters.size() != m_ecmpMemberTable.size()) {
+        allocCounterState();
+    }
     
-    // 遍历所有成员索引
-    for (size_t i = 0; i < m_memberCounts.size(); ++i) {
+    // 遍历所有成员索引，更新原始累计计数
+    for (size_t i = 0; i < m_rawCounters.size(); ++i) {
         // TODO: 这里需要实现实际的Counter读取逻辑
         // 假设已经有获取计数的函数: getCounterValue(baseId, offset)
         
-        // m_memberCounts[i] = counterMsg.statCounter[i];
-        // currentCounts[i] = m_memberCounts[i];
+        // m_rawCounters[i] = counterMsg.statCounter[i];
 
         // 临时用随机数代替
         static bool s_bRandSeeded = false;
@@ -67,16 +205,32 @@ bool EcmpInstance::updateCounters(T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg) {
             srand(time(nullptr));
             s_bRandSeeded = true;
         }
-        m_memberCounts[i] += rand() % 100;
-        currentCounts[i] = m_memberCounts[i];
+        m_rawCounters[i] += rand() % 100;
+    }
+    
+    // 经负载模型平滑后得到优化器使用的每桶负载估计
+    m_loadModel.update(m_rawCounters);
+    
+    // 添加到历史记录（方差稳定性检查基于原始累计计数，门限按此标定），保留最近10个周期的数据
+    std::copy(m_rawCounters.begin(), m_rawCounters.end(),
+              m_counterHistory.begin() + static_cast<size_t>(m_wHistoryHead) * m_rawCounters.size());
+    m_wHistoryHead = (m_wHistoryHead + 1) % HISTORY_CYCLES_MAX;
+    if (m_wHistoryNum < HISTORY_CYCLES_MAX) {
+        m_wHistoryNum++;
     }
     
-    // 添加到历史记录
-    m_counterHistory.push_back(currentCounts);
-    if (m_counterHistory.size() > 10) { // 保留最近10个周期的数据
-        m_counterHistory.erase(m_counterHistory.begin());
+    // 以最近两个历史周期的差分更新负载预测
+    if (m_wHistoryNum >= 2) {
+        const size_t itemNum = m_rawCounters.size();
+        const size_t curSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 1) % HISTORY_CYCLES_MAX;
+        const size_t prevSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 2) % HISTORY_CYCLES_MAX;
+        m_forecaster.update(&m_counterHistory[curSlot * itemNum], &m_counterHistory[prevSlot * itemNum], itemNum);
+        m_stabilityGate.update(&m_counterHistory[curSlot * itemNum], &m_counterHistory[prevSlot * itemNum], itemNum);
     }
     
+    // 在优化器使用的成员计数上更新大流桶集合
+    m_elephantDetector.update(getMemberCounts(), static_cast<WORD32>(m_portIdList.size()));
+    
     // 计算当前负载分布
     calculateLoadMetrics();
     
@@ -105,19 +259,49 @@ bool EcmpInstance::runOptimization() {
         return false;
     }
     
+    // ===== 故障切换结果未被即时取走时在本周期下发 =====
+    if (m_bPendingFailover) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 下发端口故障切换（迁移 %zu 个桶）\n", 
+                      m_sgConfig.dwSgId, m_pCold->memberChanges.size());
+        m_bPendingFailover = false;
+        m_status = AI_ECMP_ADJUST;
+        return true;
+    }
+    
+    // ===== 已下发的修改未被确认前硬件仍可能是旧成员表，暂停优化（排空的下一步也等待确认） =====
+    if (m_pCold->inflight.isActive()) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 等待修改确认（SeqId: %u，已重发 %u 次），跳过优化\n", 
+                      m_sgConfig.dwSgId, m_pCold->inflight.getState().dwSeqId, m_pCold->inflight.getState().dwRetries);
+        m_pCold->inflight.recordSkippedCycle();
+        m_status = AI_ECMP_WAIT;
+        return false;
+    }
+    
+    // ===== 端口排空期间暂停常规优化，每周期下发一步迁移 =====
+    if (m_pCold->drain.bActive) {
+        return runDrainStep();
+    }
+    
+    // ===== 端口加入后的再均衡结果直接下发，无需等待历史数据 =====
+    if (m_bPendingRebalance) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 下发端口加入再均衡（迁移 %zu 个桶）\n", 
+                      m_sgConfig.dwSgId, m_pCold->memberChanges.size());
+        m_bPendingRebalance = false;
+        m_status = AI_ECMP_ADJUST;
+        return true;
+    }
+    
     // 如果没有足够的历史数据，不执行优化
-    if (m_counterHistory.size() < HISTORY_CYCLES_FOR_VARIANCE) {
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 计数器历史数据不足 (%zu < %u)，等待中\n", 
-                      m_sgConfig.dwSgId, m_counterHistory.size(), HISTORY_CYCLES_FOR_VARIANCE);
+    if (m_wHistoryNum < HISTORY_CYCLES_FOR_VARIANCE) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 计数器历史数据不足 (%u < %u)，等待中\n", 
+                      m_sgConfig.dwSgId, m_wHistoryNum, HISTORY_CYCLES_FOR_VARIANCE);
         m_status = AI_ECMP_WAIT;
         return false;
     }
     
     // ===== 检查计数器数据方差稳定性 =====
     if (!isCounterVarianceStable()) {
-        double varianceCoeff = utils::calculateCounterVarianceCoefficient(m_counterHistory, m_memberCounts);
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 计数器数据方差未稳定（变异系数: %.6f > %.6f），继续等待\n", 
-                      m_sgConfig.dwSgId, varianceCoeff, VARIANCE_THRESHOLD);
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 计数器数据方差未稳定，继续等待\n", m_sgConfig.dwSgId);
         m_status = AI_ECMP_WAIT;
         return false;
     }
@@ -131,10 +315,20 @@ bool EcmpInstance::runOptimization() {
                   m_sgConfig.dwSgId, currentEval.totalGap, currentEval.upBoundGap, 
                   currentEval.lowBoundGap, currentEval.avgGap, currentEval.balanceScore);
     
-    // 记录优化前数据
-    m_pPrinter->setBeforeData(m_ecmpMemberTable, m_memberCounts, m_portLoads, m_portSpeeds);
-    m_pPrinter->printMemberTable(m_ecmpMemberTable, "优化前ECMP成员表");
-    m_pPrinter->printLoadBalanceMetrics(m_portLoads, m_portSpeeds, "优化前负载均衡指标");
+    const std::vector<WORD64>& memberCounts = getMemberCounts();
+    
+    // 记录优化前数据（打印器及其映射形式的数据只在启用报告时临时分配）
+    std::unique_ptr<EcmpPrinter> pPrinter;
+    std::unordered_map<WORD32, WORD32> portSpeedMap;
+    if (m_bReportEnabled) {
+        pPrinter.reset(new EcmpPrinter(m_sgConfig.dwSgId));
+        portSpeedMap = utils::portArrayToMap(m_portIdList, m_portSpeedList);
+        const std::unordered_map<WORD32, WORD32> beforeTableMap = utils::memberTableToMap(m_ecmpMemberTable);
+        const std::unordered_map<WORD32, WORD64> beforePortLoads = utils::calculatePortLoads(m_ecmpMemberTable, memberCounts);
+        pPrinter->setBeforeData(beforeTableMap, memberCounts, beforePortLoads, portSpeedMap);
+        pPrinter->printMemberTable(beforeTableMap, "优化前ECMP成员表");
+        pPrinter->printLoadBalanceMetrics(beforePortLoads, portSpeedMap, "优化前负载均衡指标");
+    }
     
     // 如果平均偏差小于阈值，认为是平衡的
     if (currentEval.avgGap < 0.05) {
@@ -144,9 +338,19 @@ bool EcmpInstance::runOptimization() {
         // 重置扩容控制状态
         m_inPostExpansionPeriod = false;
         m_consecutiveAdjustFailures = 0;
+        
+        // 长期平衡且逻辑成员多于所需时缩容，回收硬件散列表项
+        if (m_wBalancedCycles < COMPACT_BALANCED_CYCLES) {
+            m_wBalancedCycles++;
+        } else if (planCompaction()) {
+            m_wBalancedCycles = 0;
+            m_status = AI_ECMP_SHRINK;
+            return true;
+        }
         return false;
     }
     
+    m_wBalancedCycles = 0;
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 系统失衡，开始分析优化策略\n", m_sgConfig.dwSgId);
     
     // ===== 改进的扩容决策逻辑 =====
@@ -213,14 +417,83 @@ bool EcmpInstance::runOptimization() {
         return false;
     }
     
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 执行局部搜索优化，当前成员表大小: %zu\n", 
-                  m_sgConfig.dwSgId, m_ecmpMemberTable.size());
+    ParameterTuner& tuner = m_pCold->tuner;
+    SolutionCache& solutionCache = m_pCold->solutionCache;
+    std::vector<WORD32>& optimizedTable = m_pCold->optimizedTable;
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& memberChanges = m_pCold->memberChanges;
+    
+    // 应用调优器当前选择的搜索参数
+    const T_AI_ECMP_TUNER_ARM& tunerArm = tuner.getActiveArm();
+    m_pAlgorithm->setSearchParameters(tunerArm.dwMaxIterations, tunerArm.exchangeCostFactor);
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 执行%s优化，当前成员表大小: %zu，参数组: #%zu (迭代: %u, 交换成本: %.3f)\n", 
+                  m_sgConfig.dwSgId, m_pAlgorithm->getName(), m_ecmpMemberTable.size(),
+                  tuner.getActiveArmIndex(), tunerArm.dwMaxIterations, tunerArm.exchangeCostFactor);
     
     // ========== 开始算法执行时间测量 ==========
     auto algorithmStartTime = std::chrono::high_resolution_clock::now();
+    const WORD64 qwCpuStartMicros = AlgorithmBase::getThreadCpuMicros();
+    WORD64 qwWorkerCpuMicros = 0;
+    
+    // ===== 查找解缓存：相近流量模式下直接复用或作为热启动 =====
+    const std::vector<WORD32>* pStartTable = &m_ecmpMemberTable;
+    bool bCacheReused = false;
+    const T_AI_ECMP_CACHED_SOLUTION* pCached = solutionCache.lookup(memberCounts);
+    if (pCached && isCachedTableCompatible(pCached->memberTable)) {
+        // 用当前计数对缓存解做一次指标校验
+        T_AI_ECMP_EVAL cachedEval = utils::calculateLoadBalanceMetrics(
+            pCached->memberTable, memberCounts, m_portIdList, m_portSpeedList);
+        double cachedScore = utils::calculateBalanceScore(cachedEval);
+        double storedScore = utils::calculateBalanceScore(pCached->eval);
+        
+        if (cachedScore >= storedScore - CACHE_SCORE_TOLERANCE &&
+            isOptimizationEffective(currentEval, cachedEval, pCached->memberTable, tunerArm.minImprovementPercent)) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 命中解缓存且校验通过（得分: %.6f, 写入时: %.6f），直接复用\n", 
+                          m_sgConfig.dwSgId, cachedScore, storedScore);
+            optimizedTable.assign(pCached->memberTable.begin(), pCached->memberTable.end());
+            bCacheReused = true;
+        } else if (cachedScore > utils::calculateBalanceScore(currentEval)) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 命中解缓存但得分回退（%.6f < %.6f），作为热启动\n", 
+                          m_sgConfig.dwSgId, cachedScore, storedScore);
+            pStartTable = &pCached->memberTable;
+        } else {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 命中解缓存但不优于当前配置，忽略\n", m_sgConfig.dwSgId);
+        }
+    }
     
-    // 执行局部搜索优化
-    auto optimizedTable = m_pAlgorithm->optimize(m_ecmpMemberTable, m_memberCounts, m_portSpeeds);
+    // 存在大流桶时先固定放置大流桶，搜索只在其余桶上进行
+    const std::vector<WORD32>& elephants = m_elephantDetector.getElephants();
+    if (!bCacheReused && !elephants.empty()) {
+        std::vector<WORD32>& placementTable = m_pCold->placementTable;
+        placementTable.assign(pStartTable->begin(), pStartTable->end());
+        placeElephants(placementTable, memberCounts);
+        pStartTable = &placementTable;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 检测到 %zu 个大流桶（占总负载 %.2f%%），已预先放置并固定\n", 
+                      m_sgConfig.dwSgId, elephants.size(), m_elephantDetector.getTotalShare() * 100.0);
+    }
+    
+    // 执行算法优化：问题以只读视图传入，结果写入实例持有的缓冲区（跨周期复用）
+    if (!bCacheReused) {
+        T_AI_ECMP_PROBLEM_VIEW problemView = {
+            ArrayView<WORD32>(*pStartTable),
+            ArrayView<WORD64>(memberCounts),
+            ArrayView<WORD32>(m_portIdList),
+            ArrayView<WORD32>(m_portSpeedList),
+            ArrayView<BYTE>(m_elephantDetector.getMask())
+        };
+        T_AI_ECMP_OPTIMIZE_STATS optimizeStats =
+            m_pAlgorithm->optimizeInto(problemView, optimizedTable, memberChanges);
+        qwWorkerCpuMicros = optimizeStats.qwWorkerCpuMicros;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 算法统计 - 评估次数: %u, 得分: %.6f -> %.6f, 变化表项: %u\n", 
+                      m_sgConfig.dwSgId, optimizeStats.dwEvaluations, optimizeStats.scoreBefore,
+                      optimizeStats.scoreAfter, optimizeStats.dwChangedEntries);
+    }
+    
+    // 复用缓存解或热启动时，变化列表需相对当前成员表重新生成
+    if (bCacheReused || pStartTable != &m_ecmpMemberTable) {
+        AlgorithmBase::collectMemberChanges(ArrayView<WORD32>(m_ecmpMemberTable), optimizedTable, memberChanges);
+    }
+    const char* pszAlgorithmName = bCacheReused ? "SolutionCache" : m_pAlgorithm->getName();
     
     // ========== 结束算法执行时间测量 ==========
     auto algorithmEndTime = std::chrono::high_resolution_clock::now();
@@ -234,19 +507,23 @@ bool EcmpInstance::runOptimization() {
     auto algorithmDurationMicros = std::chrono::duration_cast<std::chrono::microseconds>(
         algorithmEndTime - algorithmStartTime);
     WORD64 executionTimeMicros = static_cast<WORD64>(algorithmDurationMicros.count());
+    m_pCold->dwLastOptimizeMicros = static_cast<WORD32>(std::min<WORD64>(executionTimeMicros, 0xFFFFFFFF));
+    
+    // 调优器按CPU开销计价：本线程CPU时间加上算法工作线程的CPU时间（并发竞速时大于墙钟耗时）
+    const WORD64 qwCpuMicros = AlgorithmBase::getThreadCpuMicros() - qwCpuStartMicros + qwWorkerCpuMicros;
     
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 局部搜索优化完成，优化后成员表大小: %zu\n", 
-                  m_sgConfig.dwSgId, optimizedTable.size());
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: %s优化完成，优化后成员表大小: %zu，变化表项: %zu\n", 
+                  m_sgConfig.dwSgId, pszAlgorithmName, optimizedTable.size(), memberChanges.size());
     
-    // 如果优化后的表与原表相同，不需要调整
-    if (optimizedTable == m_ecmpMemberTable) {
+    // 如果没有变化的表项，不需要调整
+    if (memberChanges.empty()) {
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 优化后配置与原配置相同，无需调整\n", m_sgConfig.dwSgId);
         
-        m_pPrinter->setExecutionTime(executionTimeMs);
-        m_pPrinter->setAlgorithmName("LocalSearch");
-        
         // 记录调优失败
         recordAdjustmentResult(false);
+        if (!bCacheReused) {
+            tuner.recordOutcome(0.0, qwCpuMicros, 0);
+        }
         
         // 打印简化报告（没有优化后数据）
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 📊 算法执行总结 - 耗时: %u ms, 结果: 无需调整\n", 
@@ -261,30 +538,33 @@ bool EcmpInstance::runOptimization() {
     // ===== 评估优化前的平衡状态 =====
     T_AI_ECMP_EVAL beforeEval = currentEval;
     
-    // 使用优化后的成员表临时计算端口负载
-    std::unordered_map<WORD32, WORD64> tempPortLoads = 
-        utils::calculatePortLoads(optimizedTable, m_memberCounts);
-    
-    // ===== 评估优化后的平衡状态（使用临时负载数据）=====
-    T_AI_ECMP_EVAL afterEval = utils::calculateLoadBalanceMetrics(tempPortLoads, m_portSpeeds);
+    // ===== 评估优化后的平衡状态（使用优化后的成员表）=====
+    T_AI_ECMP_EVAL afterEval = utils::calculateLoadBalanceMetrics(
+        optimizedTable, memberCounts, m_portIdList, m_portSpeedList);
     
     // ===== 计算改进百分比并判断是否达到有效阈值 =====
     double improvementPercent = utils::calculateImprovementPercentage(beforeEval, afterEval);
-    bool isEffective = isOptimizationEffective(beforeEval, afterEval, 1.0); // 1%阈值
+    double minImprovementPercent = tunerArm.minImprovementPercent;
+    bool isEffective = isOptimizationEffective(beforeEval, afterEval, optimizedTable, minImprovementPercent);
+    const T_AI_ECMP_SIGNIFICANCE_RESULT& significance = m_improvementTest.getLastResult();
+    if (significance.bTested) {
+        // 窗口上的平均改进不受单个样本噪声影响，作为本次优化的改进幅度
+        improvementPercent = significance.meanImprovement;
+    }
     
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 优化效果评估 - 改进百分比: %.2f%%, 是否有效: %s\n", 
                   m_sgConfig.dwSgId, improvementPercent, isEffective ? "是" : "否");
     
-    // ===== 如果改进不足，标记为调优失败，不进行下表，不更新成员表 =====
+    // ===== 如果改进不足或不显著，标记为调优失败，不进行下表，不更新成员表 =====
     if (!isEffective) {
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 算法优化改进不足(%.2f%% < 1%%)，标记为调优失败，保持原有配置不变\n", 
-                      m_sgConfig.dwSgId, improvementPercent);
-        
-        m_pPrinter->setExecutionTime(executionTimeMs);
-        m_pPrinter->setAlgorithmName("LocalSearch");
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 算法优化改进不足或不显著(%.2f%%, 门限 %.2f%%)，标记为调优失败，保持原有配置不变\n", 
+                      m_sgConfig.dwSgId, improvementPercent, minImprovementPercent);
         
         // 记录调优失败
         recordAdjustmentResult(false);
+        if (!bCacheReused) {
+            tuner.recordOutcome(improvementPercent, qwCpuMicros, 0);
+        }
         
         // 打印简化报告
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 📊 算法执行总结 - 耗时: %u ms, 改进: %.2f%%, 结果: 调优失败(改进不足)，配置未更新\n", 
@@ -295,25 +575,36 @@ bool EcmpInstance::runOptimization() {
     }
     
     // ===== 只有改进足够时，才真正更新成员表和负载指标 =====
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 算法优化改进足够(%.2f%% >= 1%%)，准备更新配置\n", 
-                  m_sgConfig.dwSgId, improvementPercent);
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 算法优化改进足够(%.2f%% >= %.2f%%)，准备更新配置\n", 
+                  m_sgConfig.dwSgId, improvementPercent, minImprovementPercent);
     
-    // 更新成员表
-    m_ecmpMemberTable = std::move(optimizedTable);
+    // 更新成员表（只写入变化的表项）
+    for (const auto& change : memberChanges) {
+        m_ecmpMemberTable[change.dwHashIndex] = change.dwNewPortId;
+    }
     
     // 重新计算负载指标（使用新的成员表）
     calculateLoadMetrics();
     
     // ===== 记录优化后数据并打印报告 =====
-    m_pPrinter->setAfterData(m_ecmpMemberTable, m_memberCounts, m_portLoads, m_portSpeeds);
-    m_pPrinter->setAlgorithmName("LocalSearch");
-    m_pPrinter->setExecutionTime(executionTimeMs);
-    
-    // 打印完整优化报告
-    m_pPrinter->printFullReport();
+    if (pPrinter) {
+        pPrinter->setAfterData(utils::memberTableToMap(m_ecmpMemberTable), memberCounts,
+                               utils::calculatePortLoads(m_ecmpMemberTable, memberCounts), portSpeedMap);
+        pPrinter->setAlgorithmName(pszAlgorithmName);
+        pPrinter->setExecutionTime(executionTimeMs);
+        
+        // 打印完整优化报告
+        pPrinter->printFullReport();
+    }
 
     // 记录调优成功
     recordAdjustmentResult(true);
+    if (!bCacheReused) {
+        tuner.recordOutcome(improvementPercent, qwCpuMicros, 1);
+    }
+    
+    // 写入解缓存，供后续相近流量模式复用
+    solutionCache.store(memberCounts, m_ecmpMemberTable, afterEval);
 
     m_status = AI_ECMP_ADJUST;
     
@@ -323,7 +614,7 @@ bool EcmpInstance::runOptimization() {
     return true;
 }
 
-bool EcmpInstance::getOptimizedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
+bool EcmpInstance::getOptimizedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData, T_AI_ECMP_NHOP_DELTA* pDelta) {
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始生成调整配置\n", m_sgConfig.dwSgId);
     if (m_status != AI_ECMP_ADJUST) {
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 当前状态 %s 不是调整状态，无法生成调整配置\n", 
@@ -345,30 +636,41 @@ bool EcmpInstance::getOptimizedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
     }
     
     // 直接将m_ecmpMemberTable转换为T_AI_ECMP_NHOP_MODIFY形式
-    // m_ecmpMemberTable的key是hash_index，value是port_id
-    for (const auto& memberEntry : m_ecmpMemberTable) {
-        WORD32 dwHashIndex = memberEntry.first;
-        WORD32 dwPortId = memberEntry.second;
-        
-        if (dwHashIndex < FTM_TRUNK_MAX_HASH_NUM_15K) {
-            nhopModifyData.adwLinkItem[dwHashIndex] = dwPortId;
+    // m_ecmpMemberTable的下标是hash_index，值是port_id
+    for (size_t i = 0; i < m_ecmpMemberTable.size() && i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
+        nhopModifyData.adwLinkItem[i] = m_ecmpMemberTable[i];
+    }
+    
+    // 与已下发成员表逐项比较生成增量（成员数不同时无法增量下发）
+    if (pDelta) {
+        const std::vector<WORD32>& delivered = m_pCold->deliveredTable;
+        pDelta->dwSgId = nhopModifyData.dwSgId;
+        pDelta->dwSeqId = nhopModifyData.dwSeqId;
+        pDelta->dwItemNum = delivered.size() == nhopModifyData.dwItemNum ? nhopModifyData.dwItemNum : 0;
+        pDelta->dwChangeNum = 0;
+        for (WORD32 i = 0; i < pDelta->dwItemNum && i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
+            if (delivered[i] != nhopModifyData.adwLinkItem[i]) {
+                pDelta->astChange[pDelta->dwChangeNum++] = {i, nhopModifyData.adwLinkItem[i]};
+            }
         }
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 相对已下发成员表变化 %u 个表项%s\n", 
+                  m_sgConfig.dwSgId, pDelta->dwChangeNum, pDelta->dwItemNum ? "" : "（成员数不同，只能全量下发）");
     }
+    recordDelivered(nhopModifyData);
     
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 调整配置生成完成，等待硬件表更新后同步软件配置\n", 
-              m_sgConfig.dwSgId);
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 调整配置生成完成（本次变化表项: %zu），等待硬件表更新后同步软件配置\n", 
+              m_sgConfig.dwSgId, m_pCold->memberChanges.size());
     
     return true;
 }
 
 /**
-* @brief 当前分配逻辑
-* 遍历排序后的端口。
-* 计算当前总的可用容量 available_capacity_total = MAX_TOTAL_LOGICAL_LINKS - sum_of_new_weights。
-* 如果可用容量小于等于0，则停止分配。
-* 对于每个端口，期望的增加量是其 currentWeight (目标是翻倍)。如果当前权重为0，则期望增加1。
-* 实际可增加量 actual_increase_for_this_port 取期望增加量和总可用容量中的较小者。
-* 更新该端口的 newWeight 和 sum_of_new_weights。
+* @brief 扩容分配逻辑
+* 目标逻辑成员数由端口速率决定（见selectExpandTarget，不超过硬件上限FTM_TRUNK_MAX_HASH_NUM_15K）。
+* 按端口速率用Webster最高平均数法分配各端口的逻辑成员数，再用平滑加权轮询交织排布，
+* 使同一端口的表项分散，后续交换有更多选择。
+* 新表项j由旧表项 j mod 旧成员数 拆分而来（目标数为旧数整数倍时是精确的，否则为近似），
+* 硬件表更新后的配置到达时据此把计数器历史拆分到新表项，负载历史不丢失。
 */
 bool EcmpInstance::getExpandedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始生成扩容配置\n", m_sgConfig.dwSgId);
@@ -386,136 +688,559 @@ bool EcmpInstance::getExpandedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
     nhopModifyData.dwSgId = m_sgConfig.dwSgId;
     nhopModifyData.dwSeqId = m_sgConfig.dwSeqId;
     
-    if (m_sgConfig.dwPortNum == 0) {
+    if (m_portIdList.empty()) {
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口数量为0，无需扩容\n", m_sgConfig.dwSgId);
         return true;
     }
 
-    // 创建端口权重信息结构
-    struct PortWeightInfo {
-        WORD32 dwPortId;
-        WORD32 dwCurrentWeight;
-        WORD32 dwNewWeight;
-    };
-
-    std::vector<PortWeightInfo> portInfos;
-    portInfos.reserve(m_sgConfig.dwPortNum);
-
-    WORD32 dwCurrentTotalWeight = 0;
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 当前端口权重信息:\n", m_sgConfig.dwSgId);
+    // 计算目标逻辑成员数
+    const WORD32 dwCurrentItemNum = static_cast<WORD32>(m_ecmpMemberTable.size());
+    const WORD32 dwPortNum = static_cast<WORD32>(std::min<size_t>(m_portIdList.size(), FTM_LAG_MAX_MEM_NUM_15K));
+    std::vector<WORD32> portIds(m_portIdList.begin(), m_portIdList.begin() + dwPortNum);
+    std::vector<WORD32> portSpeeds(m_portSpeedList.begin(), m_portSpeedList.begin() + dwPortNum);
+    std::vector<WORD32> newWeights;
+    const WORD32 dwTargetItemNum = selectExpandTarget(portSpeeds, dwCurrentItemNum, newWeights);
+    if (dwTargetItemNum == 0) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 逻辑成员数 %u 已达硬件上限 %u，扩容失败\n", 
+                      m_sgConfig.dwSgId, dwCurrentItemNum, dwMaxTotalLogicalLinks);
+        return false;
+    }
     
-    for (WORD16 i = 0; i < m_sgConfig.dwPortNum; ++i) {
-        if (i < FTM_LAG_MAX_MEM_NUM_15K) {
-            WORD32 dwPortId = m_sgConfig.ports[i].dwPortId;
-            WORD32 dwWeight = m_sgConfig.ports[i].dwWeight;
-            
-            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u:   端口 %u: 当前权重 %u\n", 
-                          m_sgConfig.dwSgId, dwPortId, dwWeight);
-            
-            portInfos.push_back({
-                dwPortId,
-                dwWeight,
-                dwWeight // newWeight 初始化为 currentWeight
-            });
-            dwCurrentTotalWeight += dwWeight;
-        }
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 逻辑成员数 %u -> %u，各端口按速率分配:\n", 
+                  m_sgConfig.dwSgId, dwCurrentItemNum, dwTargetItemNum);
+    for (WORD32 i = 0; i < dwPortNum; ++i) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u:   端口 %u: 速率 %u, 权重 %u -> %u\n", 
+                      m_sgConfig.dwSgId, portIds[i], portSpeeds[i], m_portWeightList[i], newWeights[i]);
     }
+    
+    // 交织排布扩容后的成员表（不更新内部状态，硬件表更新后通过配置同步）
+    std::vector<WORD32> expandedTable;
+    utils::layoutInterleaved(portIds, newWeights, expandedTable);
+    
+    nhopModifyData.dwItemNum = static_cast<WORD32>(expandedTable.size());
+    for (WORD32 i = 0; i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
+        nhopModifyData.adwLinkItem[i] = i < expandedTable.size() ? expandedTable[i] : 0;
+    }
+    
+    // 记录待生效的扩容，配置同步时据此迁移计数器历史
+    m_pCold->dwResizeFromItemNum = dwCurrentItemNum;
+    m_pCold->dwResizeToItemNum = nhopModifyData.dwItemNum;
+    recordDelivered(nhopModifyData);
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 扩容配置生成完成，总索引数: %u，等待硬件表更新后同步软件配置\n", 
+                  m_sgConfig.dwSgId, nhopModifyData.dwItemNum);
+    
+    return true;
+}
 
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 当前总权重: %u\n", m_sgConfig.dwSgId, dwCurrentTotalWeight);
-
-    // 按当前权重升序排序，优先给权重小的端口增加链路
-    std::sort(portInfos.begin(), portInfos.end(), [](const PortWeightInfo& a, const PortWeightInfo& b) {
-        return a.dwCurrentWeight < b.dwCurrentWeight;
-    });
-
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口按权重排序完成，开始扩容分配\n", m_sgConfig.dwSgId);
-
-    WORD32 dwSumOfNewWeights = dwCurrentTotalWeight; // 初始链路数
+/**
+* @brief 选择扩容目标成员数
+* 从当前成员数加端口数（平均每个端口至少增加一个逻辑成员，不超过FTM_TRUNK_MAX_HASH_NUM_15K）起，
+* 找最小的、Webster分配后每个端口逻辑成员占比与速率占比的相对偏差不超过EXPAND_SHARE_TOLERANCE的成员数；
+* 满足条件的旧成员数整数倍若不超过该最小值的EXPAND_MULTIPLE_SLACK倍则优先选用，使计数器历史拆分保持精确。
+* 没有满足容差的成员数时选偏差最小的成员数。
+*/
+WORD32 EcmpInstance::selectExpandTarget(const std::vector<WORD32>& portSpeeds, WORD32 dwCurrentItemNum,
+                                        std::vector<WORD32>& weights) {
+    const WORD32 dwMaxItemNum = FTM_TRUNK_MAX_HASH_NUM_15K;
+    const WORD32 dwPortNum = static_cast<WORD32>(portSpeeds.size());
+    const WORD32 dwMinItemNum = std::max(std::min(dwCurrentItemNum + dwPortNum, dwMaxItemNum), dwCurrentItemNum + 1);
+    WORD32 dwFitNum = 0;
+    WORD32 dwFitMultiple = 0;
+    WORD32 dwBestNum = 0;
+    double bestDeviation = 0.0;
+    for (WORD32 dwItemNum = dwMinItemNum; dwItemNum <= dwMaxItemNum; ++dwItemNum) {
+        if (dwFitNum != 0 && dwItemNum > dwFitNum * EXPAND_MULTIPLE_SLACK) {
+            break;
+        }
+        if (!utils::apportionBySpeed(portSpeeds, dwItemNum, weights)) {
+            continue;
+        }
+        
+        double deviation = utils::calculateSpeedShareDeviation(portSpeeds, weights);
+        if (dwBestNum == 0 || deviation < bestDeviation) {
+            dwBestNum = dwItemNum;
+            bestDeviation = deviation;
+        }
+        if (deviation > EXPAND_SHARE_TOLERANCE) {
+            continue;
+        }
+        if (dwFitNum == 0) {
+            dwFitNum = dwItemNum;
+        }
+        if (dwCurrentItemNum != 0 && dwItemNum % dwCurrentItemNum == 0) {
+            dwFitMultiple = dwItemNum;
+            break;
+        }
+    }
+    
+    WORD32 dwTargetNum = dwFitMultiple != 0 ? dwFitMultiple : (dwFitNum != 0 ? dwFitNum : dwBestNum);
+    if (dwTargetNum == 0) {
+        return 0;
+    }
+    
+    utils::apportionBySpeed(portSpeeds, dwTargetNum, weights);
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 扩容目标成员数 %u（%s，速率占比最大偏差 %.2f%%）\n", 
+                  m_sgConfig.dwSgId, dwTargetNum,
+                  dwFitMultiple != 0 ? "旧成员数整数倍" : (dwFitNum != 0 ? "满足速率占比的最小成员数" : "无满足容差的成员数，取偏差最小者"),
+                  utils::calculateSpeedShareDeviation(portSpeeds, weights) * 100.0);
+    return dwTargetNum;
+}
 
-    // 扩容逻辑：为每个端口分配更多的逻辑链路
-    for (WORD32 i = 0; i < portInfos.size(); ++i) {
-        WORD32 dwAvailableCapacityTotal = dwMaxTotalLogicalLinks - dwSumOfNewWeights;
+bool EcmpInstance::planCompaction() {
+    const WORD32 dwItemNum = static_cast<WORD32>(m_ecmpMemberTable.size());
+    const WORD32 dwPortNum = static_cast<WORD32>(m_portIdList.size());
+    const std::vector<WORD64>& memberCounts = getMemberCounts();
+    const WORD32 dwMinTarget = dwPortNum * COMPACT_MIN_ITEMS_PER_PORT;
+    if (dwPortNum == 0 || dwItemNum < 2 * dwMinTarget || memberCounts.size() != dwItemNum || m_inPostExpansionPeriod) {
+        return false;
+    }
+    
+    // 只考虑成员数的约数：按模散列时旧表项i的流量整体落入新表项 i mod 目标数，合并后的负载是精确的
+    std::vector<WORD64> mergedCounts;
+    std::vector<WORD32>& compactTable = m_pCold->optimizedTable;
+    for (WORD32 dwTarget = dwMinTarget; dwTarget <= dwItemNum / 2; ++dwTarget) {
+        if (dwItemNum % dwTarget != 0) {
+            continue;
+        }
         
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 处理端口 %u，剩余容量: %u\n", 
-                      m_sgConfig.dwSgId, portInfos[i].dwPortId, dwAvailableCapacityTotal);
+        mergedCounts.assign(dwTarget, 0);
+        for (WORD32 i = 0; i < dwItemNum; ++i) {
+            mergedCounts[i % dwTarget] += memberCounts[i];
+        }
         
-        // 尝试将当前端口的权重翻倍，即增加量为其当前权重
-        WORD32 dwDesiredIncrease = portInfos[i].dwCurrentWeight;
-        if (dwDesiredIncrease == 0) {
-            // 如果当前权重为0，则期望增加1
-             dwDesiredIncrease = 1;
+        // 每个新表项选用其来源表项中承载负载最多的端口，迁移的流量最少
+        compactTable.assign(dwTarget, 0);
+        for (WORD32 k = 0; k < dwTarget; ++k) {
+            WORD32 dwBestPort = m_ecmpMemberTable[k];
+            WORD64 qwBestLoad = 0;
+            for (WORD32 i = k; i < dwItemNum; i += dwTarget) {
+                WORD64 qwPortLoad = 0;
+                for (WORD32 j = k; j < dwItemNum; j += dwTarget) {
+                    if (m_ecmpMemberTable[j] == m_ecmpMemberTable[i]) {
+                        qwPortLoad += memberCounts[j];
+                    }
+                }
+                if (qwPortLoad > qwBestLoad) {
+                    qwBestLoad = qwPortLoad;
+                    dwBestPort = m_ecmpMemberTable[i];
+                }
+            }
+            compactTable[k] = dwBestPort;
         }
-
-        // ===== 修改：如果容量不足以满足期望增加量，直接扩容失败 =====
-        if (dwAvailableCapacityTotal < dwDesiredIncrease) {
-            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 容量不足以满足端口 %u 的扩容需求（需要: %u, 可用: %u），扩容失败\n", 
-                          m_sgConfig.dwSgId, portInfos[i].dwPortId, dwDesiredIncrease, dwAvailableCapacityTotal);
-            return false;
+        
+        // 每个端口至少保留一个表项，否则该端口会被移出成员表
+        bool bAllPortsKept = true;
+        for (WORD32 dwPortId : m_portIdList) {
+            if (std::find(compactTable.begin(), compactTable.end(), dwPortId) == compactTable.end()) {
+                bAllPortsKept = false;
+                break;
+            }
         }
+        if (!bAllPortsKept) {
+            continue;
+        }
+        
+        T_AI_ECMP_EVAL eval = utils::calculateLoadBalanceMetrics(compactTable, mergedCounts, m_portIdList, m_portSpeedList);
+        if (eval.avgGap >= COMPACT_MAX_AVG_GAP && m_pAlgorithm) {
+            // 直接合并不够平衡时，在缩容后的表上做一次局部优化（交换代价使迁移尽量少）
+            std::vector<WORD32> startTable(compactTable);
+            T_AI_ECMP_PROBLEM_VIEW problemView = {
+                ArrayView<WORD32>(startTable),
+                ArrayView<WORD64>(mergedCounts),
+                ArrayView<WORD32>(m_portIdList),
+                ArrayView<WORD32>(m_portSpeedList),
+                ArrayView<BYTE>()
+            };
+            m_pAlgorithm->optimizeInto(problemView, compactTable, m_pCold->memberChanges);
+            m_pCold->memberChanges.clear();
+            eval = utils::calculateLoadBalanceMetrics(compactTable, mergedCounts, m_portIdList, m_portSpeedList);
+        }
+        
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 缩容候选 %u -> %u，平均偏差: %.6f（上限 %.2f）\n", 
+                      m_sgConfig.dwSgId, dwItemNum, dwTarget, eval.avgGap, COMPACT_MAX_AVG_GAP);
+        if (eval.avgGap < COMPACT_MAX_AVG_GAP) {
+            m_pCold->dwResizeFromItemNum = dwItemNum;
+            m_pCold->dwResizeToItemNum = dwTarget;
+            return true;
+        }
+    }
+    
+    compactTable.clear();
+    return false;
+}
 
-        WORD32 dwActualIncrease = dwDesiredIncrease; // 现在实际增加量就是期望增加量
-
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 期望增加 %u，实际增加 %u\n", 
-                      m_sgConfig.dwSgId, portInfos[i].dwPortId, dwDesiredIncrease, dwActualIncrease);
+bool EcmpInstance::getCompactedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始生成缩容配置\n", m_sgConfig.dwSgId);
+    
+    const std::vector<WORD32>& compactTable = m_pCold->optimizedTable;
+    if (m_status != AI_ECMP_SHRINK || compactTable.empty() ||
+        compactTable.size() != m_pCold->dwResizeToItemNum) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 当前状态 %s 没有待下发的缩容配置\n", 
+                      m_sgConfig.dwSgId, utils::aiEcmpStatusToString(m_status));
+        return false;
+    }
+    
+    nhopModifyData.dwSgId = m_sgConfig.dwSgId;
+    nhopModifyData.dwSeqId = m_sgConfig.dwSeqId;
+    nhopModifyData.dwItemNum = static_cast<WORD32>(compactTable.size());
+    for (WORD32 i = 0; i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
+        nhopModifyData.adwLinkItem[i] = i < compactTable.size() ? compactTable[i] : 0;
+    }
+    recordDelivered(nhopModifyData);
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 缩容配置生成完成，逻辑成员数 %u -> %u，回收 %u 个散列表项，等待硬件表更新后同步软件配置\n", 
+                  m_sgConfig.dwSgId, m_pCold->dwResizeFromItemNum, nhopModifyData.dwItemNum,
+                  m_pCold->dwResizeFromItemNum - nhopModifyData.dwItemNum);
+    return true;
+}
 
-        portInfos[i].dwNewWeight += dwActualIncrease;
-        dwSumOfNewWeights += dwActualIncrease;
-        
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 新权重: %u -> %u\n", 
-                      m_sgConfig.dwSgId, portInfos[i].dwPortId, 
-                      portInfos[i].dwCurrentWeight, portInfos[i].dwNewWeight);
+bool EcmpInstance::onPortDown(WORD32 dwPortId) {
+    const size_t portIndex = findPortIndex(dwPortId);
+    if (portIndex == m_portIdList.size()) {
+        return false;
     }
+    if (m_portIdList.size() <= 1) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 故障，但没有存活端口可切换\n", 
+                      m_sgConfig.dwSgId, dwPortId);
+        return false;
+    }
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 故障，执行故障快速切换\n", m_sgConfig.dwSgId, dwPortId);
+    removePort(portIndex);
+    return redistributeOrphanBuckets(m_ecmpMemberTable);
+}
 
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 扩容后总权重: %u\n", m_sgConfig.dwSgId, dwSumOfNewWeights);
+bool EcmpInstance::getFailoverNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModifyData, T_AI_ECMP_NHOP_DELTA* pDelta) {
+    if (!m_bPendingFailover) {
+        return false;
+    }
+    m_bPendingFailover = false;
+    return getOptimizedNextHops(nhopModifyData, pDelta);
+}
 
-    // 构建扩容后的ECMP成员表用于下发（不更新内部状态）
-    WORD32 dwCurrentIndex = 0;
+bool EcmpInstance::startDrain(WORD32 dwPortId, double stepShare, double utilCap, bool bCapOverride) {
+    T_AI_ECMP_DRAIN_STATE& drain = m_pCold->drain;
+    const size_t portIndex = findPortIndex(dwPortId);
+    if (portIndex == m_portIdList.size() || m_portIdList.size() <= 1) {
+        return false;
+    }
+    if (drain.bActive) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 正在排空，不能同时排空端口 %u\n", 
+                      m_sgConfig.dwSgId, drain.dwPortId, dwPortId);
+        return false;
+    }
     
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始生成扩容后的ECMP成员表\n", m_sgConfig.dwSgId);
+    const std::vector<WORD64>& memberCounts = getMemberCounts();
+    drain = {};
+    drain.bActive = true;
+    drain.dwPortId = dwPortId;
+    drain.stepShare = std::min(std::max(stepShare, 0.01), 1.0);
+    drain.utilCap = std::max(utilCap, 1.0);
+    drain.bCapOverride = bCapOverride ? TRUE : FALSE;
+    for (size_t i = 0; i < m_ecmpMemberTable.size(); ++i) {
+        if (m_ecmpMemberTable[i] == dwPortId) {
+            drain.dwStartBuckets++;
+            drain.qwStartLoad += memberCounts.size() == m_ecmpMemberTable.size() ? memberCounts[i] : 0;
+        }
+    }
+    drain.dwRemainBuckets = drain.dwStartBuckets;
+    drain.qwRemainLoad = drain.qwStartLoad;
     
-    // 填充 T_AI_ECMP_NHOP_MODIFY 结构
-    nhopModifyData.dwItemNum = dwSumOfNewWeights;
+    // 缓存解可能把桶放回排空端口，排空期间不再适用
+    m_pCold->solutionCache.clear();
+    m_wBalancedCycles = 0;
     
-    // 初始化数组
-    for (WORD32 i = 0; i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
-        nhopModifyData.adwLinkItem[i] = 0;
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始排空端口 %u（桶数: %u, 负载: %llu, 每步上限: %.0f%%, 利用率上限: %.2f倍平均%s）\n", 
+                  m_sgConfig.dwSgId, dwPortId, drain.dwStartBuckets, drain.qwStartLoad,
+                  drain.stepShare * 100.0, drain.utilCap, bCapOverride ? "，停滞时允许超出" : "");
+    return true;
+}
+
+void EcmpInstance::cancelDrain() {
+    T_AI_ECMP_DRAIN_STATE& drain = m_pCold->drain;
+    if (!drain.bActive) {
+        return;
+    }
+    drain.bActive = false;
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 取消端口 %u 的排空（已完成 %u 步，剩余桶数: %u），恢复常规优化\n", 
+                  m_sgConfig.dwSgId, drain.dwPortId, drain.dwSteps, drain.dwRemainBuckets);
+}
+
+/**
+* @brief 端口排空单步迁移
+* 本步迁移的负载不超过开始负载的stepShare（无负载数据时按桶数），且至少迁移一个桶以保证推进。
+* 排空端口上的桶按负载降序尝试，放到放入后归一化负载最小的存活端口；放入后超过利用率上限
+* （utilCap倍的排空后平均归一化负载）时跳过该桶，上限为硬约束。没有桶可迁移时本周期暂停并累计停滞周期数，
+* 同时用常规算法在存活端口间再均衡，流量变化或再均衡后的后续步骤可能满足上限。
+* 只有操作员开始排空时显式允许（bCapOverride），连续停滞达到DRAIN_STALL_LIMIT个周期后本步第一个桶才忽略上限。
+* 端口上没有桶后从端口数组中移除，常规优化不会再把桶放回该端口。
+*/
+bool EcmpInstance::runDrainStep() {
+    T_AI_ECMP_DRAIN_STATE& drain = m_pCold->drain;
+    const size_t drainIndex = findPortIndex(drain.dwPortId);
+    if (drainIndex == m_portIdList.size()) {
+        drain.bActive = false;
+        return false;
+    }
+    
+    const size_t itemNum = m_ecmpMemberTable.size();
+    const size_t portNum = m_portIdList.size();
+    const std::vector<WORD64>& memberCounts = getMemberCounts();
+    auto bucketLoad = [&memberCounts, itemNum](size_t i) -> WORD64 {
+        return memberCounts.size() == itemNum ? memberCounts[i] : 0;
+    };
+    
+    // 存活端口的负载、桶数和总速率；排空端口上的桶为待迁移桶
+    WORD64 portLoad[AI_ECMP_MAX_PORT_NUM] = {0};
+    WORD32 bucketNum[AI_ECMP_MAX_PORT_NUM] = {0};
+    WORD64 qwTotalLoad = 0;
+    WORD64 qwSurvivingSpeed = 0;
+    // 排空期间不运行常规优化，借用大流桶预放置缓冲存放待迁移桶
+    std::vector<WORD32>& candidates = m_pCold->placementTable;
+    candidates.clear();
+    for (size_t i = 0; i < itemNum; ++i) {
+        qwTotalLoad += bucketLoad(i);
+        size_t p = findPortIndex(m_ecmpMemberTable[i]);
+        if (p == drainIndex) {
+            candidates.push_back(static_cast<WORD32>(i));
+        } else if (p < portNum) {
+            portLoad[p] += bucketLoad(i);
+            bucketNum[p]++;
+        }
+    }
+    for (size_t p = 0; p < portNum; ++p) {
+        if (p != drainIndex) {
+            qwSurvivingSpeed += std::max<WORD32>(m_portSpeedList[p], 1);
+        }
     }
     
-    // 为每个端口按照新权重分配索引到下发结构中
-    for (const auto& portInfo : portInfos) {
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 为端口 %u 分配 %u 个索引 (起始索引: %u)\n", 
-                      m_sgConfig.dwSgId, portInfo.dwPortId, portInfo.dwNewWeight, dwCurrentIndex);
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& memberChanges = m_pCold->memberChanges;
+    memberChanges.clear();
+    
+    if (!candidates.empty()) {
+        std::stable_sort(candidates.begin(), candidates.end(), [&bucketLoad](WORD32 a, WORD32 b) {
+            return bucketLoad(a) > bucketLoad(b);
+        });
         
-        for (WORD32 j = 0; j < portInfo.dwNewWeight; ++j) {
-            if (dwCurrentIndex < FTM_TRUNK_MAX_HASH_NUM_15K) {
-                nhopModifyData.adwLinkItem[dwCurrentIndex] = portInfo.dwPortId;
-                dwCurrentIndex++;
-            } else {
-                XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 达到最大索引限制\n", m_sgConfig.dwSgId);
+        const double capLoad = drain.utilCap * static_cast<double>(qwTotalLoad) / qwSurvivingSpeed;
+        const double loadBudget = drain.stepShare * static_cast<double>(drain.qwStartLoad);
+        const WORD32 dwBucketBudget = std::max<WORD32>(
+            static_cast<WORD32>(drain.stepShare * drain.dwStartBuckets + 0.5), 1);
+        WORD64 qwMovedLoad = 0;
+        const bool bRelaxCap = drain.bCapOverride && drain.dwStalledCycles >= DRAIN_STALL_LIMIT;
+        
+        for (WORD32 dwIndex : candidates) {
+            if (memberChanges.size() >= dwBucketBudget) {
                 break;
             }
+            const WORD64 qwLoad = bucketLoad(dwIndex);
+            if (!memberChanges.empty() && static_cast<double>(qwMovedLoad + qwLoad) > loadBudget) {
+                continue;
+            }
+            
+            size_t best = portNum;
+            double bestLoad = 0.0;
+            double bestCount = 0.0;
+            for (size_t p = 0; p < portNum; ++p) {
+                if (p == drainIndex) {
+                    continue;
+                }
+                const double speed = std::max<WORD32>(m_portSpeedList[p], 1);
+                const double load = static_cast<double>(portLoad[p] + qwLoad) / speed;
+                const double count = static_cast<double>(bucketNum[p] + 1) / speed;
+                if (best == portNum || load < bestLoad || (load == bestLoad && count < bestCount)) {
+                    best = p;
+                    bestLoad = load;
+                    bestCount = count;
+                }
+            }
+            if (best == portNum) {
+                continue;
+            }
+            if (qwTotalLoad > 0 && bestLoad > capLoad) {
+                if (!bRelaxCap || !memberChanges.empty()) {
+                    continue;
+                }
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 排空已连续停滞 %u 个周期，按操作员设置超出利用率上限迁移桶 %u 到端口 %u（放入后归一化负载 %.2f，上限 %.2f）\n", 
+                              m_sgConfig.dwSgId, drain.dwPortId, drain.dwStalledCycles, dwIndex,
+                              m_portIdList[best], bestLoad, capLoad);
+            }
+            
+            memberChanges.push_back({dwIndex, drain.dwPortId, m_portIdList[best]});
+            m_ecmpMemberTable[dwIndex] = m_portIdList[best];
+            portLoad[best] += qwLoad;
+            bucketNum[best]++;
+            qwMovedLoad += qwLoad;
         }
+        
+        drain.dwRemainBuckets = static_cast<WORD32>(candidates.size() - memberChanges.size());
+        drain.qwRemainLoad = 0;
+        for (size_t i = 0; i < itemNum; ++i) {
+            if (m_ecmpMemberTable[i] == drain.dwPortId) {
+                drain.qwRemainLoad += bucketLoad(i);
+            }
+        }
+    } else {
+        drain.dwRemainBuckets = 0;
+        drain.qwRemainLoad = 0;
     }
     
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 扩容配置生成完成，总索引数: %u，等待硬件表更新后同步软件配置\n", 
-                  m_sgConfig.dwSgId, dwCurrentIndex);
+    if (!memberChanges.empty()) {
+        drain.dwSteps++;
+        drain.dwStalledCycles = 0;
+        m_status = AI_ECMP_ADJUST;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 排空第 %u 步迁移 %zu 个桶，进度 %u/%u 桶，剩余负载 %llu/%llu\n", 
+                      m_sgConfig.dwSgId, drain.dwPortId, drain.dwSteps, memberChanges.size(),
+                      drain.dwStartBuckets - drain.dwRemainBuckets, drain.dwStartBuckets,
+                      drain.qwRemainLoad, drain.qwStartLoad);
+    } else if (drain.dwRemainBuckets > 0) {
+        drain.dwStalledCycles++;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 排空受利用率上限限制，本周期暂停（连续 %u 个周期，剩余桶数: %u）\n", 
+                      m_sgConfig.dwSgId, drain.dwPortId, drain.dwStalledCycles, drain.dwRemainBuckets);
+        if (rebalanceForDrain(drainIndex)) {
+            m_status = AI_ECMP_ADJUST;
+        }
+    }
+    
+    if (drain.dwRemainBuckets == 0) {
+        removePort(drainIndex);
+        drain.bActive = false;
+        drain.bCompleted = true;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 排空完成（共 %u 步），端口退出优化的端口集合\n", 
+                      m_sgConfig.dwSgId, drain.dwPortId, drain.dwSteps);
+    }
+    
+    calculateLoadMetrics();
+    return !memberChanges.empty();
+}
+
+bool EcmpInstance::rebalanceForDrain(size_t drainIndex) {
+    T_AI_ECMP_DRAIN_STATE& drain = m_pCold->drain;
+    const size_t itemNum = m_ecmpMemberTable.size();
+    const std::vector<WORD64>& memberCounts = getMemberCounts();
+    if (memberCounts.size() != itemNum) {
+        return false;
+    }
+    if (!m_pAlgorithm) {
+        setAlgorithm(std::unique_ptr<AlgorithmBase>(new LocalSearch(10000, 0.1)));
+    }
     
+    // 只保留存活端口及其上的桶：排空端口上的桶不参与，也不会有桶迁入排空端口
+    const std::vector<BYTE>& elephantMask = m_elephantDetector.getMask();
+    std::vector<WORD32> survivorIndex;
+    std::vector<WORD32> table;
+    std::vector<WORD64> counts;
+    std::vector<BYTE> pinned;
+    for (size_t i = 0; i < itemNum; ++i) {
+        if (m_ecmpMemberTable[i] == drain.dwPortId) {
+            continue;
+        }
+        survivorIndex.push_back(static_cast<WORD32>(i));
+        table.push_back(m_ecmpMemberTable[i]);
+        counts.push_back(memberCounts[i]);
+        pinned.push_back(i < elephantMask.size() ? elephantMask[i] : 0);
+    }
+    std::vector<WORD32> portIds;
+    std::vector<WORD32> portSpeeds;
+    for (size_t p = 0; p < m_portIdList.size(); ++p) {
+        if (p != drainIndex) {
+            portIds.push_back(m_portIdList[p]);
+            portSpeeds.push_back(m_portSpeedList[p]);
+        }
+    }
+    if (table.size() < 2 || portIds.size() < 2) {
+        return false;
+    }
+    
+    T_AI_ECMP_PROBLEM_VIEW problemView = {
+        ArrayView<WORD32>(table),
+        ArrayView<WORD64>(counts),
+        ArrayView<WORD32>(portIds),
+        ArrayView<WORD32>(portSpeeds),
+        ArrayView<BYTE>(pinned)
+    };
+    std::vector<WORD32> optimizedTable;
+    std::vector<T_AI_ECMP_MEMBER_CHANGE> changes;
+    m_pAlgorithm->optimizeInto(problemView, optimizedTable, changes);
+    if (changes.empty()) {
+        return false;
+    }
+    
+    // 与常规优化相同，改进不足下发门限时不下发
+    T_AI_ECMP_EVAL beforeEval = utils::calculateLoadBalanceMetrics(table, counts, portIds, portSpeeds);
+    T_AI_ECMP_EVAL afterEval = utils::calculateLoadBalanceMetrics(optimizedTable, counts, portIds, portSpeeds);
+    double improvementPercent = utils::calculateImprovementPercentage(beforeEval, afterEval);
+    if (improvementPercent < m_pCold->tuner.getActiveArm().minImprovementPercent) {
+        return false;
+    }
+    
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& memberChanges = m_pCold->memberChanges;
+    memberChanges.clear();
+    for (const T_AI_ECMP_MEMBER_CHANGE& change : changes) {
+        const WORD32 dwIndex = survivorIndex[change.dwHashIndex];
+        memberChanges.push_back({dwIndex, change.dwOldPortId, change.dwNewPortId});
+        m_ecmpMemberTable[dwIndex] = change.dwNewPortId;
+    }
+    drain.dwRebalances++;
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 排空停滞，%s在存活端口间再均衡（迁移 %zu 个桶，改进 %.2f%%）\n", 
+                  m_sgConfig.dwSgId, drain.dwPortId, m_pAlgorithm->getName(), memberChanges.size(), improvementPercent);
     return true;
 }
 
+std::unique_ptr<T_AI_ECMP_SG_CFG> EcmpInstance::excludeDrainedPort(const T_AI_ECMP_SG_CFG& sgConfig) {
+    T_AI_ECMP_DRAIN_STATE& drain = m_pCold->drain;
+    if (!drain.bCompleted) {
+        return nullptr;
+    }
+    
+    const WORD32 dwPortNum = std::min<WORD32>(sgConfig.dwPortNum, AI_ECMP_MAX_PORT_NUM);
+    WORD32 dwDrainedIndex = dwPortNum;
+    for (WORD32 i = 0; i < dwPortNum; ++i) {
+        if (sgConfig.ports[i].dwPortId == drain.dwPortId) {
+            dwDrainedIndex = i;
+            break;
+        }
+    }
+    if (dwDrainedIndex == dwPortNum) {
+        // 平台已移除该端口，排空记录不再需要
+        drain.bCompleted = false;
+        return nullptr;
+    }
+    for (WORD32 i = 0; i < sgConfig.dwItemNum && i < AI_ECMP_MAX_ITEM_NUM; ++i) {
+        if (sgConfig.items[i].dwPortId == drain.dwPortId) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 配置中有桶重新指向已排空端口 %u，视为恢复启用\n", 
+                          m_sgConfig.dwSgId, drain.dwPortId);
+            drain.bCompleted = false;
+            return nullptr;
+        }
+    }
+    
+    std::unique_ptr<T_AI_ECMP_SG_CFG> pFiltered(new T_AI_ECMP_SG_CFG(sgConfig));
+    for (WORD32 i = dwDrainedIndex; i + 1 < dwPortNum; ++i) {
+        pFiltered->ports[i] = pFiltered->ports[i + 1];
+    }
+    pFiltered->dwPortNum = dwPortNum - 1;
+    return pFiltered;
+}
+
+void EcmpInstance::removePort(size_t portIndex) {
+    m_portIdList.erase(m_portIdList.begin() + portIndex);
+    m_portSpeedList.erase(m_portSpeedList.begin() + portIndex);
+    m_portWeightList.erase(m_portWeightList.begin() + portIndex);
+    m_portLoadList.erase(m_portLoadList.begin() + portIndex);
+    m_sgConfig.dwPortNum = static_cast<WORD32>(m_portIdList.size());
+}
+
 T_AI_ECMP_EVAL EcmpInstance::evaluateBalance() {
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始平衡状态评估\n", m_sgConfig.dwSgId);
     
-    // 使用utils中的函数计算端口负载
-    std::unordered_map<WORD32, WORD64> portLoads = 
-        ai_ecmp::utils::calculatePortLoads(m_ecmpMemberTable, m_memberCounts);
-    
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 计算得到 %zu 个端口的负载数据\n", 
-              m_sgConfig.dwSgId, portLoads.size());
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 基于 %zu 个逻辑成员、%zu 个端口计算负载\n", 
+              m_sgConfig.dwSgId, m_ecmpMemberTable.size(), m_portIdList.size());
     
     // 使用utils中的函数计算负载平衡指标
-    T_AI_ECMP_EVAL evalResult = 
-        ai_ecmp::utils::calculateLoadBalanceMetrics(portLoads, m_portSpeeds);
+    T_AI_ECMP_EVAL evalResult = ai_ecmp::utils::calculateLoadBalanceMetrics(
+        m_ecmpMemberTable, getMemberCounts(), m_portIdList, m_portSpeedList);
     
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 平衡评估完成 - 总偏差: %.6f, 上界偏差: %.6f, 下界偏差: %.6f, 平均偏差: %.6f, 平衡得分: %.6f\n",
               m_sgConfig.dwSgId, evalResult.totalGap, evalResult.upBoundGap, 
@@ -527,6 +1252,26 @@ T_AI_ECMP_EVAL EcmpInstance::evaluateBalance() {
     return evalResult;
 }
 
+double EcmpInstance::getExcessLoad() const {
+    const size_t portNum = std::min(m_portLoadList.size(), m_portSpeedList.size());
+    double totalLoad = 0.0;
+    double totalSpeed = 0.0;
+    for (size_t p = 0; p < portNum; ++p) {
+        totalLoad += static_cast<double>(m_portLoadList[p]);
+        totalSpeed += m_portSpeedList[p];
+    }
+    if (totalLoad <= 0.0 || totalSpeed <= 0.0) {
+        return 0.0;
+    }
+    
+    double excess = 0.0;
+    for (size_t p = 0; p < portNum; ++p) {
+        double fairLoad = totalLoad * m_portSpeedList[p] / totalSpeed;
+        excess += std::max(static_cast<double>(m_portLoadList[p]) - fairLoad, 0.0);
+    }
+    return excess;
+}
+
 WORD32 EcmpInstance::getSgId() const {
     return m_sgConfig.dwSgId;
 }
@@ -537,8 +1282,10 @@ T_AI_ECMP_STATUS EcmpInstance::getStatus() const {
 
 void EcmpInstance::reset() {
     m_wCycle = 0;
+    m_wBalancedCycles = 0;
     m_status = AI_ECMP_INIT;
-    m_counterHistory.clear();
+    m_wHistoryHead = 0;
+    m_wHistoryNum = 0;
     // 重置扩容控制状态
     m_lastExpandCycle = 0;
     m_adjustCyclesAfterExpansion = 0;
@@ -548,67 +1295,634 @@ void EcmpInstance::reset() {
     m_dwDisabledCycles = 0;
 }
 
-void EcmpInstance::convertConfig() {
-    // 清空现有映射
-    m_ecmpMemberTable.clear();
-    m_portSpeeds.clear();
+void EcmpInstance::setSgHeader(const T_AI_ECMP_SG_CFG& sgConfig) {
+    m_sgConfig.dwSgId = sgConfig.dwSgId;
+    m_sgConfig.dwSeqId = sgConfig.dwSeqId;
+    m_sgConfig.dwFwdLagId = sgConfig.dwFwdLagId;
+    m_sgConfig.dwItemNum = sgConfig.dwItemNum;
+    m_sgConfig.dwPortNum = sgConfig.dwPortNum;
+    m_sgConfig.dwCounterBase = sgConfig.dwCounterBase;
+}
+
+void EcmpInstance::syncDeliveredTable(const T_AI_ECMP_SG_CFG& sgConfig) {
+    std::vector<WORD32>& delivered = m_pCold->deliveredTable;
+    delivered.assign(std::min<WORD32>(sgConfig.dwItemNum, AI_ECMP_MAX_ITEM_NUM), 0);
+    for (WORD32 i = 0; i < delivered.size(); ++i) {
+        WORD32 dwOffset = sgConfig.items[i].dwItemOffset;
+        if (dwOffset < delivered.size()) {
+            delivered[dwOffset] = sgConfig.items[i].dwPortId;
+        }
+    }
+}
+
+void EcmpInstance::recordDelivered(const T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
+    m_pCold->inflight.begin(nhopModifyData, m_pCold->deliveredTable, m_wCycle);
+    const WORD32 dwItemNum = std::min(nhopModifyData.dwItemNum, FTM_TRUNK_MAX_HASH_NUM_15K);
+    m_pCold->deliveredTable.assign(nhopModifyData.adwLinkItem, nhopModifyData.adwLinkItem + dwItemNum);
+}
+
+void EcmpInstance::discardStaleWindows() {
+    // 下发后采集的周期跨越成员表切换；首次下发前的周期仍然有效
+    const WORD16 wStaleNum = static_cast<WORD16>(m_wCycle - static_cast<WORD16>(m_pCold->inflight.getState().dwSendCycle));
+    if (wStaleNum == 0 || m_wHistoryNum <= 1) {
+        return;
+    }
     
-    // 初始化成员计数表
-    if (m_sgConfig.dwItemNum >= 0) {
-         m_memberCounts.assign(m_sgConfig.dwItemNum, 0);
-    } else {
-        m_memberCounts.clear();
+    const size_t itemNum = m_rawCounters.size();
+    if (wStaleNum >= m_wHistoryNum) {
+        // 下发前的周期已移出历史（或历史已重建），只保留最新一个周期作为差分基准
+        m_pCold->inflight.recordDiscardedWindows(m_wHistoryNum - 1);
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 修改已确认，丢弃跨越成员表切换的 %u 个计数器周期\n", 
+                      m_sgConfig.dwSgId, m_wHistoryNum - 1);
+        m_wHistoryNum = 1;
+        replayHistory();
+        return;
+    }
+    
+    // 去掉下发后的wStaleNum个差分：下发前的周期整体平移到最新周期处，
+    // 下发时的累计计数与最新累计计数重合，之前各周期间的差分不变，之后的差分从最新周期接续
+    const size_t latestSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 1) % HISTORY_CYCLES_MAX;
+    const size_t sendSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 1 - wStaleNum) % HISTORY_CYCLES_MAX;
+    const WORD16 wKeepNum = m_wHistoryNum - wStaleNum;
+    for (size_t i = 0; i < itemNum; ++i) {
+        const WORD64 qwShift = m_counterHistory[latestSlot * itemNum + i] - m_counterHistory[sendSlot * itemNum + i];
+        // 由新到旧搬移，源周期比目标周期早wStaleNum个，尚未被覆盖
+        for (WORD16 n = 0; n < wKeepNum; ++n) {
+            const size_t dstSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 1 - n) % HISTORY_CYCLES_MAX;
+            const size_t srcSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 1 - n - wStaleNum) % HISTORY_CYCLES_MAX;
+            m_counterHistory[dstSlot * itemNum + i] = m_counterHistory[srcSlot * itemNum + i] + qwShift;
+        }
     }
+    m_wHistoryNum = wKeepNum;
     
-    // 填充成员表
-    for (WORD16 i = 0; i < m_sgConfig.dwItemNum; ++i) {
+    m_pCold->inflight.recordDiscardedWindows(wStaleNum);
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 修改已确认，丢弃跨越成员表切换的 %u 个计数器周期，保留 %u 个历史周期\n", 
+                  m_sgConfig.dwSgId, wStaleNum, m_wHistoryNum);
+    replayHistory();
+}
+
+void EcmpInstance::replayHistory() {
+    const size_t itemNum = m_rawCounters.size();
+    if (itemNum == 0 || m_wHistoryNum == 0) {
+        return;
+    }
+    
+    // 负载模型、预测、稳定性门限和大流集合按保留的历史重建，与历史周期保持一致
+    m_loadModel.reset(itemNum);
+    m_forecaster.reset(itemNum);
+    m_elephantDetector.reset(itemNum);
+    m_stabilityGate.reset(itemNum);
+    const WORD16 wFirstSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - m_wHistoryNum) % HISTORY_CYCLES_MAX;
+    for (WORD16 n = 0; n < m_wHistoryNum; ++n) {
+        const size_t curSlot = (wFirstSlot + n) % HISTORY_CYCLES_MAX;
+        std::copy(m_counterHistory.begin() + curSlot * itemNum, m_counterHistory.begin() + (curSlot + 1) * itemNum,
+                  m_rawCounters.begin());
+        m_loadModel.update(m_rawCounters);
+        if (n >= 1) {
+            const size_t prevSlot = (curSlot + HISTORY_CYCLES_MAX - 1) % HISTORY_CYCLES_MAX;
+            m_forecaster.update(&m_counterHistory[curSlot * itemNum], &m_counterHistory[prevSlot * itemNum], itemNum);
+            m_stabilityGate.update(&m_counterHistory[curSlot * itemNum], &m_counterHistory[prevSlot * itemNum], itemNum);
+        }
+        m_elephantDetector.update(getMemberCounts(), static_cast<WORD32>(m_portIdList.size()));
+    }
+    calculateLoadMetrics();
+}
+
+T_AI_ECMP_INFLIGHT_ACTION EcmpInstance::pollInflight(T_AI_ECMP_NHOP_MODIFY& nhopModifyData) {
+    InflightTracker& inflight = m_pCold->inflight;
+    const T_AI_ECMP_INFLIGHT_ACTION action = inflight.poll(InflightTracker::nowMicros());
+    
+    if (action == AI_ECMP_INFLIGHT_RETRY) {
+        // FTM侧成员表未知，按全量重发；FTM侧成员表即为重发的内容
+        nhopModifyData.dwSgId = m_sgConfig.dwSgId;
+        inflight.fillPending(nhopModifyData);
+        m_pCold->deliveredTable = inflight.getPendingTable();
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 修改确认超时（SeqId: %u），第 %u 次全量重发\n", 
+                      m_sgConfig.dwSgId, inflight.getState().dwSeqId, inflight.getState().dwRetries);
+    } else if (action == AI_ECMP_INFLIGHT_ROLLBACK) {
+        // 回滚到最近确认的成员表；扩容/缩容未生效时成员表未改动，只取消待生效记录
+        const std::vector<WORD32>& confirmed = inflight.getConfirmedTable();
+        if (confirmed.size() == m_ecmpMemberTable.size()) {
+            m_ecmpMemberTable = confirmed;
+            calculateLoadMetrics();
+        }
+        m_pCold->dwResizeFromItemNum = 0;
+        m_pCold->dwResizeToItemNum = 0;
+        // FTM侧成员表未知，全量下发回滚后的成员表并等待回显确认，确认前不再优化
+        const WORD32 dwItemNum = static_cast<WORD32>(std::min<size_t>(m_ecmpMemberTable.size(), FTM_TRUNK_MAX_HASH_NUM_15K));
+        nhopModifyData.dwSgId = m_sgConfig.dwSgId;
+        nhopModifyData.dwSeqId = m_sgConfig.dwSeqId;
+        nhopModifyData.dwItemNum = dwItemNum;
+        for (WORD32 i = 0; i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
+            nhopModifyData.adwLinkItem[i] = i < dwItemNum ? m_ecmpMemberTable[i] : 0;
+        }
+        m_pCold->deliveredTable = m_ecmpMemberTable;
+        recordDelivered(nhopModifyData);
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 修改重发 %u 次仍未确认，回滚到最近确认的成员表并全量下发\n", 
+                      m_sgConfig.dwSgId, inflight.getConfig().dwMaxRetries);
+    }
+    return action;
+}
+
+void EcmpInstance::convertConfig(const T_AI_ECMP_SG_CFG& sgConfig) {
+    // 计数器相关状态按旧成员数分配，释放后在首次收到计数时重新分配
+    releaseCounterState();
+    m_pCold->memberChanges.clear();
+    
+    // 填充成员表（下标为hash_index，按实际成员数分配）
+    std::vector<WORD32>(std::min<WORD32>(sgConfig.dwItemNum, AI_ECMP_MAX_ITEM_NUM), 0).swap(m_ecmpMemberTable);
+    for (WORD16 i = 0; i < sgConfig.dwItemNum; ++i) {
         if (i < AI_ECMP_MAX_ITEM_NUM) {
-            WORD32 dwOffset = m_sgConfig.items[i].dwItemOffset;
-            WORD32 dwPortId = m_sgConfig.items[i].dwPortId;
-            m_ecmpMemberTable[dwOffset] = dwPortId;
+            WORD32 dwOffset = sgConfig.items[i].dwItemOffset;
+            WORD32 dwPortId = sgConfig.items[i].dwPortId;
+            if (dwOffset < m_ecmpMemberTable.size()) {
+                m_ecmpMemberTable[dwOffset] = dwPortId;
+            } else {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 逻辑成员偏移 %u 超出成员数 %zu，忽略\n", 
+                              sgConfig.dwSgId, dwOffset, m_ecmpMemberTable.size());
+            }
         }
     }
     
-    // 填充端口速率表
-    for (WORD16 i = 0; i < m_sgConfig.dwPortNum; ++i) {
-        if (i < AI_ECMP_MAX_PORT_NUM) {
-            WORD32 dwPortId = m_sgConfig.ports[i].dwPortId;
-            WORD32 dwSpeed = m_sgConfig.ports[i].dwSpeed;
-            m_portSpeeds[dwPortId] = dwSpeed;
+    convertPortConfig(sgConfig);
+}
+
+void EcmpInstance::convertPortConfig(const T_AI_ECMP_SG_CFG& sgConfig) {
+    // 端口数组按实际端口数分配
+    const size_t portNum = std::min<WORD32>(sgConfig.dwPortNum, AI_ECMP_MAX_PORT_NUM);
+    std::vector<WORD32>(portNum).swap(m_portIdList);
+    std::vector<WORD32>(portNum).swap(m_portSpeedList);
+    std::vector<WORD32>(portNum).swap(m_portWeightList);
+    std::vector<WORD64>(portNum, 0).swap(m_portLoadList);
+    
+    for (size_t i = 0; i < portNum; ++i) {
+        m_portIdList[i] = sgConfig.ports[i].dwPortId;
+        m_portSpeedList[i] = sgConfig.ports[i].dwSpeed;
+        m_portWeightList[i] = sgConfig.ports[i].dwWeight;
+    }
+}
+
+void EcmpInstance::carryOverResizedHistory(const std::vector<WORD64>& oldHistory, WORD32 dwOldItemNum,
+                                           WORD16 wOldHead, WORD16 wOldNum) {
+    allocCounterState();
+    const size_t itemNum = m_rawCounters.size();
+    if (itemNum == 0 || dwOldItemNum == 0 || oldHistory.size() != static_cast<size_t>(dwOldItemNum) * HISTORY_CYCLES_MAX) {
+        return;
+    }
+    
+    // 扩容：新表项j来自旧表项 j mod 旧成员数，旧表项的计数按拆分数均分，保持总量不变
+    // 缩容：旧表项i并入新表项 i mod 新成员数，计数累加
+    // 按时间顺序回放历史，重建负载模型、预测和大流集合
+    const WORD16 wFirstSlot = (wOldHead + HISTORY_CYCLES_MAX - wOldNum) % HISTORY_CYCLES_MAX;
+    for (WORD16 n = 0; n < wOldNum; ++n) {
+        const size_t oldBase = static_cast<size_t>((wFirstSlot + n) % HISTORY_CYCLES_MAX) * dwOldItemNum;
+        if (itemNum >= dwOldItemNum) {
+            for (size_t j = 0; j < itemNum; ++j) {
+                const size_t parent = j % dwOldItemNum;
+                const size_t splitNum = (itemNum - parent + dwOldItemNum - 1) / dwOldItemNum;
+                m_rawCounters[j] = oldHistory[oldBase + parent] / splitNum;
+            }
+        } else {
+            std::fill(m_rawCounters.begin(), m_rawCounters.end(), 0);
+            for (size_t i = 0; i < dwOldItemNum; ++i) {
+                m_rawCounters[i % itemNum] += oldHistory[oldBase + i];
+            }
+        }
+        
+        m_loadModel.update(m_rawCounters);
+        std::copy(m_rawCounters.begin(), m_rawCounters.end(),
+                  m_counterHistory.begin() + static_cast<size_t>(m_wHistoryHead) * itemNum);
+        m_wHistoryHead = (m_wHistoryHead + 1) % HISTORY_CYCLES_MAX;
+        m_wHistoryNum++;
+        if (m_wHistoryNum >= 2) {
+            const size_t curSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 1) % HISTORY_CYCLES_MAX;
+            const size_t prevSlot = (m_wHistoryHead + HISTORY_CYCLES_MAX - 2) % HISTORY_CYCLES_MAX;
+            m_forecaster.update(&m_counterHistory[curSlot * itemNum], &m_counterHistory[prevSlot * itemNum], itemNum);
+            m_stabilityGate.update(&m_counterHistory[curSlot * itemNum], &m_counterHistory[prevSlot * itemNum], itemNum);
+        }
+        m_elephantDetector.update(getMemberCounts(), static_cast<WORD32>(m_portIdList.size()));
+    }
+    
+    calculateLoadMetrics();
+}
+
+void EcmpInstance::allocCounterState() {
+    const size_t itemNum = m_ecmpMemberTable.size();
+    m_rawCounters.assign(itemNum, 0);
+    m_counterHistory.assign(itemNum * HISTORY_CYCLES_MAX, 0);
+    m_wHistoryHead = 0;
+    m_wHistoryNum = 0;
+    m_loadModel.reset(itemNum);
+    m_forecaster.reset(itemNum);
+    m_elephantDetector.reset(itemNum);
+    m_stabilityGate.reset(itemNum);
+    
+    // 预留算法输出缓冲区，避免优化过程中分配内存
+    m_pCold->optimizedTable.reserve(itemNum);
+    m_pCold->memberChanges.reserve(itemNum);
+    m_pCold->placementTable.reserve(itemNum);
+}
+
+void EcmpInstance::releaseCounterState() {
+    std::vector<WORD64>().swap(m_rawCounters);
+    std::vector<WORD64>().swap(m_counterHistory);
+    m_wHistoryHead = 0;
+    m_wHistoryNum = 0;
+    m_loadModel.reset(0);
+    m_forecaster.reset(0);
+    m_elephantDetector.reset(0);
+    m_stabilityGate.reset(0);
+    m_improvementTest.release();
+    std::vector<WORD32>().swap(m_pCold->optimizedTable);
+    std::vector<WORD32>().swap(m_pCold->placementTable);
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>().swap(m_pCold->memberChanges);
+}
+
+size_t EcmpInstance::findPortIndex(WORD32 dwPortId) const {
+    return std::find(m_portIdList.begin(), m_portIdList.end(), dwPortId) - m_portIdList.begin();
+}
+
+size_t EcmpInstance::getMemoryFootprint() const {
+    size_t bytes = sizeof(*this)
+        + m_ecmpMemberTable.capacity() * sizeof(WORD32)
+        + m_rawCounters.capacity() * sizeof(WORD64)
+        + m_counterHistory.capacity() * sizeof(WORD64)
+        + (m_portIdList.capacity() + m_portSpeedList.capacity() + m_portWeightList.capacity()) * sizeof(WORD32)
+        + m_portLoadList.capacity() * sizeof(WORD64)
+        + m_loadModel.getMemoryFootprint() - sizeof(LoadModel)
+        + m_forecaster.getMemoryFootprint() - sizeof(LoadForecaster)
+        + m_elephantDetector.getMemoryFootprint() - sizeof(ElephantDetector)
+        + m_stabilityGate.getMemoryFootprint() - sizeof(StabilityGate)
+        + m_improvementTest.getMemoryFootprint() - sizeof(ImprovementTest);
+    
+    bytes += sizeof(ColdState)
+        + m_pCold->tuner.getMemoryFootprint() - sizeof(ParameterTuner)
+        + m_pCold->solutionCache.getMemoryFootprint() - sizeof(SolutionCache)
+        + m_pCold->inflight.getMemoryFootprint() - sizeof(InflightTracker)
+        + m_pCold->optimizedTable.capacity() * sizeof(WORD32)
+        + m_pCold->placementTable.capacity() * sizeof(WORD32)
+        + m_pCold->deliveredTable.capacity() * sizeof(WORD32)
+        + m_pCold->memberChanges.capacity() * sizeof(T_AI_ECMP_MEMBER_CHANGE);
+    return bytes;
+}
+
+WORD32 EcmpInstance::diffConfig(const T_AI_ECMP_SG_CFG& sgConfig) const {
+    if (sgConfig.dwItemNum != m_sgConfig.dwItemNum) {
+        return CFG_DIFF_ITEM_NUM;
+    }
+    
+    WORD32 dwDiff = CFG_DIFF_NONE;
+    
+    // 端口集合及端口属性
+    WORD32 dwNewPortNum = std::min<WORD32>(sgConfig.dwPortNum, AI_ECMP_MAX_PORT_NUM);
+    if (dwNewPortNum != m_portIdList.size()) {
+        // 新端口集合是旧集合的非空真子集时按端口退出处理
+        bool bSubset = dwNewPortNum > 0 && dwNewPortNum < m_portIdList.size();
+        for (WORD32 i = 0; i < dwNewPortNum && bSubset; ++i) {
+            bSubset = findPortIndex(sgConfig.ports[i].dwPortId) != m_portIdList.size();
+        }
+        dwDiff |= bSubset ? CFG_DIFF_PORT_DOWN : CFG_DIFF_PORT_SET;
+    } else {
+        for (WORD32 i = 0; i < dwNewPortNum; ++i) {
+            const T_AI_SG_WEIGHT_CFG& newPort = sgConfig.ports[i];
+            size_t portIndex = findPortIndex(newPort.dwPortId);
+            if (portIndex == m_portIdList.size()) {
+                dwDiff |= CFG_DIFF_PORT_SET;
+                break;
+            }
+            if (m_portSpeedList[portIndex] != newPort.dwSpeed) {
+                dwDiff |= CFG_DIFF_PORT_ATTR;
+            }
+        }
+        for (WORD32 i = 0; i < dwNewPortNum && !(dwDiff & CFG_DIFF_PORT_ATTR); ++i) {
+            if (sgConfig.ports[i].dwWeight != m_portWeightList[i] ||
+                sgConfig.ports[i].dwPortId != m_portIdList[i]) {
+                dwDiff |= CFG_DIFF_PORT_ATTR;
+            }
+        }
+    }
+    
+    // 逻辑成员映射（与当前成员表比较，自身下发的配置回显不会产生差异）
+    for (WORD32 i = 0; i < sgConfig.dwItemNum && i < AI_ECMP_MAX_ITEM_NUM; ++i) {
+        WORD32 dwOffset = sgConfig.items[i].dwItemOffset;
+        if (dwOffset >= m_ecmpMemberTable.size() || m_ecmpMemberTable[dwOffset] != sgConfig.items[i].dwPortId) {
+            dwDiff |= CFG_DIFF_MEMBERS;
+            break;
+        }
+    }
+    
+    return dwDiff;
+}
+
+void EcmpInstance::assignBucketsToNewPorts(
+    const std::vector<WORD32>& oldPortIds,
+    const std::vector<WORD64>& oldEstimate) {
+    
+    // 尚未收到计数时负载估计为空，按零负载处理（仅按桶数分配）
+    if (!oldEstimate.empty() && oldEstimate.size() != m_ecmpMemberTable.size()) {
+        return;
+    }
+    auto bucketLoad = [&oldEstimate](size_t i) -> WORD64 {
+        return oldEstimate.empty() ? 0 : oldEstimate[i];
+    };
+    
+    // 各端口的桶数、负载和速率（按m_portIdList下标）
+    const size_t portNum = m_portIdList.size();
+    std::vector<WORD32> bucketNum(portNum, 0);
+    std::vector<WORD64> portLoad(portNum, 0);
+    std::vector<bool> isNewPort(portNum, false);
+    WORD64 qwTotalSpeed = 0;
+    for (size_t p = 0; p < portNum; ++p) {
+        isNewPort[p] = std::find(oldPortIds.begin(), oldPortIds.end(), m_portIdList[p]) == oldPortIds.end();
+        qwTotalSpeed += m_portSpeedList[p];
+    }
+    
+    for (size_t i = 0; i < m_ecmpMemberTable.size(); ++i) {
+        size_t p = findPortIndex(m_ecmpMemberTable[i]);
+        if (p < portNum) {
+            bucketNum[p]++;
+            portLoad[p] += bucketLoad(i);
+        }
+    }
+    auto normalizedLoad = [&](size_t p, WORD64 load) -> double {
+        return static_cast<double>(load) / std::max<WORD32>(m_portSpeedList[p], 1);
+    };
+    
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& memberChanges = m_pCold->memberChanges;
+    memberChanges.clear();
+    for (size_t recv = 0; recv < portNum; ++recv) {
+        if (!isNewPort[recv]) {
+            continue;
+        }
+        
+        // 目标桶数：优先取配置权重，否则按速率占比估算（至少1个）
+        WORD32 dwTarget = m_portWeightList[recv];
+        if (dwTarget == 0 && qwTotalSpeed > 0) {
+            dwTarget = static_cast<WORD32>(m_ecmpMemberTable.size() * m_portSpeedList[recv] / qwTotalSpeed);
+        }
+        dwTarget = std::max<WORD32>(dwTarget, 1);
+        
+        while (bucketNum[recv] < dwTarget) {
+            // 从归一化负载最高、且仍有多于1个桶的旧端口挑选
+            size_t donor = portNum;
+            for (size_t p = 0; p < portNum; ++p) {
+                if (isNewPort[p] || bucketNum[p] <= 1) {
+                    continue;
+                }
+                if (donor == portNum || normalizedLoad(p, portLoad[p]) > normalizedLoad(donor, portLoad[donor])) {
+                    donor = p;
+                }
+            }
+            if (donor == portNum) {
+                break;
+            }
+            
+            // 选择迁移后两端口归一化负载最接近的桶
+            size_t bestBucket = m_ecmpMemberTable.size();
+            double bestGap = 0.0;
+            for (size_t i = 0; i < m_ecmpMemberTable.size(); ++i) {
+                if (m_ecmpMemberTable[i] != m_portIdList[donor]) {
+                    continue;
+                }
+                double gap = std::abs(normalizedLoad(donor, portLoad[donor] - bucketLoad(i)) -
+                                      normalizedLoad(recv, portLoad[recv] + bucketLoad(i)));
+                if (bestBucket == m_ecmpMemberTable.size() || gap < bestGap) {
+                    bestBucket = i;
+                    bestGap = gap;
+                }
+            }
+            
+            memberChanges.push_back({static_cast<WORD32>(bestBucket), m_portIdList[donor], m_portIdList[recv]});
+            m_ecmpMemberTable[bestBucket] = m_portIdList[recv];
+            portLoad[donor] -= bucketLoad(bestBucket);
+            portLoad[recv] += bucketLoad(bestBucket);
+            bucketNum[donor]--;
+            bucketNum[recv]++;
+        }
+        
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 新加入端口 %u 分得 %u 个桶（目标: %u）\n", 
+                      m_sgConfig.dwSgId, m_portIdList[recv], bucketNum[recv], dwTarget);
+    }
+    
+    if (!memberChanges.empty()) {
+        m_bPendingRebalance = true;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口加入再均衡共迁移 %zu 个桶，下个周期下发\n", 
+                      m_sgConfig.dwSgId, memberChanges.size());
+    }
+}
+
+bool EcmpInstance::redistributeOrphanBuckets(const std::vector<WORD32>& prevTable) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    const size_t itemNum = m_ecmpMemberTable.size();
+    const size_t portNum = m_portIdList.size();
+    std::vector<T_AI_ECMP_MEMBER_CHANGE>& memberChanges = m_pCold->memberChanges;
+    memberChanges.clear();
+    if (portNum == 0 || prevTable.size() != itemNum) {
+        return false;
+    }
+    if (m_pCold->drain.bActive && findPortIndex(m_pCold->drain.dwPortId) == portNum) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 排空中的端口 %u 已退出，排空随故障切换结束\n", 
+                      m_sgConfig.dwSgId, m_pCold->drain.dwPortId);
+        m_pCold->drain.bActive = false;
+    }
+    
+    // 尚未收到计数时负载估计为空，按零负载处理（仅按桶数均分）
+    const std::vector<WORD64>& memberCounts = getMemberCounts();
+    auto bucketLoad = [&memberCounts, itemNum](size_t i) -> WORD64 {
+        return memberCounts.size() == itemNum ? memberCounts[i] : 0;
+    };
+    
+    // 存活端口上现有桶的负载和桶数；原先落在故障端口上的桶待重分配
+    WORD64 portLoad[AI_ECMP_MAX_PORT_NUM] = {0};
+    WORD32 bucketNum[AI_ECMP_MAX_PORT_NUM] = {0};
+    std::vector<WORD32> orphans;
+    orphans.reserve(itemNum);
+    for (size_t i = 0; i < itemNum; ++i) {
+        if (findPortIndex(prevTable[i]) == portNum) {
+            orphans.push_back(static_cast<WORD32>(i));
+            continue;
+        }
+        size_t p = findPortIndex(m_ecmpMemberTable[i]);
+        if (p < portNum) {
+            portLoad[p] += bucketLoad(i);
+            bucketNum[p]++;
+        }
+    }
+    
+    // 按负载降序逐个放到放入后归一化负载最小的端口（LPT），负载相同时按归一化桶数均分
+    std::stable_sort(orphans.begin(), orphans.end(), [&bucketLoad](WORD32 a, WORD32 b) {
+        return bucketLoad(a) > bucketLoad(b);
+    });
+    for (WORD32 dwIndex : orphans) {
+        const WORD64 qwLoad = bucketLoad(dwIndex);
+        size_t best = 0;
+        double bestLoad = 0.0;
+        double bestCount = 0.0;
+        for (size_t p = 0; p < portNum; ++p) {
+            const double speed = std::max<WORD32>(m_portSpeedList[p], 1);
+            const double load = static_cast<double>(portLoad[p] + qwLoad) / speed;
+            const double count = static_cast<double>(bucketNum[p] + 1) / speed;
+            if (p == 0 || load < bestLoad || (load == bestLoad && count < bestCount)) {
+                best = p;
+                bestLoad = load;
+                bestCount = count;
+            }
+        }
+        
+        portLoad[best] += qwLoad;
+        bucketNum[best]++;
+        if (m_ecmpMemberTable[dwIndex] != m_portIdList[best]) {
+            memberChanges.push_back({dwIndex, m_ecmpMemberTable[dwIndex], m_portIdList[best]});
+            m_ecmpMemberTable[dwIndex] = m_portIdList[best];
         }
     }
+    
+    // 端口集合变化后缓存解不再适用；负载历史按桶统计，继续有效
+    m_pCold->solutionCache.clear();
+    m_wBalancedCycles = 0;
+    calculateLoadMetrics();
+    
+    auto elapsedMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 故障切换重分配 %zu 个桶，实际迁移 %zu 个，耗时 %lld us\n", 
+                  m_sgConfig.dwSgId, orphans.size(), memberChanges.size(), static_cast<long long>(elapsedMicros));
+    
+    if (memberChanges.empty()) {
+        return false;
+    }
+    m_bPendingFailover = true;
+    m_status = AI_ECMP_ADJUST;
+    return true;
 }
 
 void EcmpInstance::calculateLoadMetrics() {
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始计算负载指标\n", m_sgConfig.dwSgId);
     
-    // 使用utils中的函数计算端口负载，替换原有的重复代码
-    m_portLoads = ai_ecmp::utils::calculatePortLoads(m_ecmpMemberTable, m_memberCounts);
+    // 使用utils中的函数计算端口负载（按端口数组下标存放）
+    ai_ecmp::utils::calculatePortLoads(m_ecmpMemberTable, getMemberCounts(), m_portIdList, m_portLoadList);
     
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 负载指标计算完成，共 %zu 个端口\n", 
-              m_sgConfig.dwSgId, m_portLoads.size());
+              m_sgConfig.dwSgId, m_portLoadList.size());
     
     // 打印每个端口的负载详情
-    // for (const auto& entry : m_portLoads) {
+    // for (size_t i = 0; i < m_portLoadList.size(); ++i) {
     //     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 负载: %llu\n", 
-    //               m_sgConfig.dwSgId, entry.first, entry.second);
+    //               m_sgConfig.dwSgId, m_portIdList[i], m_portLoadList[i]);
     // }
 }
 
+void EcmpInstance::placeElephants(std::vector<WORD32>& table, const std::vector<WORD64>& memberCounts) const {
+    const std::vector<WORD32>& elephants = m_elephantDetector.getElephants();
+    const size_t portNum = std::min<size_t>(m_portIdList.size(), AI_ECMP_MAX_PORT_NUM);
+    if (elephants.empty() || portNum == 0) {
+        return;
+    }
+    
+    // 大流桶按负载降序（数量受MAX_ELEPHANTS限制，使用栈上数组）
+    WORD32 adwOrder[ElephantDetector::MAX_ELEPHANTS];
+    const size_t elephantNum = std::min<size_t>(elephants.size(), ElephantDetector::MAX_ELEPHANTS);
+    std::copy(elephants.begin(), elephants.begin() + elephantNum, adwOrder);
+    std::sort(adwOrder, adwOrder + elephantNum, [&memberCounts](WORD32 a, WORD32 b) {
+        return memberCounts[a] > memberCounts[b];
+    });
+    
+    // 各端口已放置的大流负载
+    WORD64 aqwPlaced[AI_ECMP_MAX_PORT_NUM] = {0};
+    
+    for (size_t k = 0; k < elephantNum; ++k) {
+        const WORD32 dwIndex = adwOrder[k];
+        if (dwIndex >= table.size()) {
+            continue;
+        }
+        const WORD64 qwLoad = memberCounts[dwIndex];
+        
+        // 选择放置后归一化负载最小的端口；相同时优先高速端口，再优先当前端口以减少迁移
+        size_t bestPort = portNum;
+        double bestNormalized = 0.0;
+        for (size_t p = 0; p < portNum; ++p) {
+            if (m_portSpeedList[p] == 0) {
+                continue;
+            }
+            double normalized = static_cast<double>(aqwPlaced[p] + qwLoad) / m_portSpeedList[p];
+            bool bBetter = (bestPort == portNum) || normalized < bestNormalized;
+            if (!bBetter && normalized == bestNormalized) {
+                if (m_portSpeedList[p] != m_portSpeedList[bestPort]) {
+                    bBetter = m_portSpeedList[p] > m_portSpeedList[bestPort];
+                } else {
+                    bBetter = (m_portIdList[p] == table[dwIndex]);
+                }
+            }
+            if (bBetter) {
+                bestPort = p;
+                bestNormalized = normalized;
+            }
+        }
+        if (bestPort == portNum) {
+            return;
+        }
+        
+        if (table[dwIndex] != m_portIdList[bestPort]) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 大流桶 %u（负载: %llu）放置到端口 %u（原端口 %u）\n", 
+                          m_sgConfig.dwSgId, dwIndex, qwLoad, m_portIdList[bestPort], table[dwIndex]);
+        }
+        table[dwIndex] = m_portIdList[bestPort];
+        aqwPlaced[bestPort] += qwLoad;
+    }
+}
+
+bool EcmpInstance::hasOversizedElephant(const std::vector<WORD64>& memberCounts) const {
+    WORD64 qwTotalLoad = 0;
+    for (WORD64 qwCount : memberCounts) {
+        qwTotalLoad += qwCount;
+    }
+    
+    WORD64 qwTotalSpeed = 0;
+    WORD32 dwMaxSpeed = 0;
+    for (WORD32 dwSpeed : m_portSpeedList) {
+        qwTotalSpeed += dwSpeed;
+        dwMaxSpeed = std::max(dwMaxSpeed, dwSpeed);
+    }
+    if (qwTotalLoad == 0 || qwTotalSpeed == 0) {
+        return false;
+    }
+    
+    // 最快端口按速率比例应承担的负载，单个桶超过它时无论放在哪里都会成为瓶颈
+    const double maxFairShare = static_cast<double>(qwTotalLoad) * dwMaxSpeed / qwTotalSpeed;
+    for (WORD32 dwIndex : m_elephantDetector.getElephants()) {
+        if (static_cast<double>(memberCounts[dwIndex]) > maxFairShare) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 大流桶 %u 负载 %llu 超过最快端口公平份额 %.0f\n", 
+                          m_sgConfig.dwSgId, dwIndex, memberCounts[dwIndex], maxFairShare);
+            return true;
+        }
+    }
+    return false;
+}
+
 bool EcmpInstance::needExpansion() {
     // TODO：如果上一次优化结果总偏差超过某个阈值且当前权重较小，考虑扩容
     // TODO：如果检查到当前没有调整空间，则直接扩容
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 开始扩容需求分析\n", m_sgConfig.dwSgId);
     
+    // 存在大流桶时，失衡主要由大流桶造成：只有单个大流桶超过端口公平份额才需要扩容，
+    // 否则通过大流桶放置即可解决
+    if (!m_elephantDetector.getElephants().empty()) {
+        bool bOversized = hasOversizedElephant(getMemberCounts());
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 存在 %zu 个大流桶，%s\n", 
+                      m_sgConfig.dwSgId, m_elephantDetector.getElephants().size(),
+                      bOversized ? "单个大流桶超过端口公平份额，需要扩容" : "可通过大流桶放置解决，不需要扩容");
+        return bOversized;
+    }
+    
     constexpr double EXPANSION_THRESHOLD = 0.2;
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 扩容阈值: %.2f\n", m_sgConfig.dwSgId, EXPANSION_THRESHOLD);
 
     // 检查是否有端口权重小于2
     bool bHasLowWeightPort = false;
-    for(WORD16 i = 0; i < m_sgConfig.dwPortNum; ++i) {
+    for(WORD16 i = 0; i < m_portIdList.size(); ++i) {
         if (i < AI_ECMP_MAX_PORT_NUM) {
-            WORD32 dwPortId = m_sgConfig.ports[i].dwPortId;
-            WORD32 dwWeight = m_sgConfig.ports[i].dwWeight;
+            WORD32 dwPortId = m_portIdList[i];
+            WORD32 dwWeight = m_portWeightList[i];
             
             XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 端口 %u 权重: %u\n", 
                           m_sgConfig.dwSgId, dwPortId, dwWeight);
@@ -649,12 +1963,12 @@ bool EcmpInstance::hasAdjustmentSpace() {
     
     // 如果所有端口速率相同且每个端口只有一个逻辑成员，没有调整空间
     bool bAllSameSpeed = true;
-    if (m_sgConfig.dwPortNum > 0 && 0 < AI_ECMP_MAX_PORT_NUM) {
-        WORD32 dwFirstSpeed = m_sgConfig.ports[0].dwSpeed;
+    if (!m_portSpeedList.empty()) {
+        WORD32 dwFirstSpeed = m_portSpeedList[0];
         
-        for (WORD16 i = 1; i < m_sgConfig.dwPortNum; ++i) {
+        for (WORD16 i = 1; i < m_portSpeedList.size(); ++i) {
             if (i < AI_ECMP_MAX_PORT_NUM) {
-                if (m_sgConfig.ports[i].dwSpeed != dwFirstSpeed) {
+                if (m_portSpeedList[i] != dwFirstSpeed) {
                     bAllSameSpeed = false;
                     break;
                 }
@@ -721,34 +2035,134 @@ void EcmpInstance::recordAdjustmentResult(bool success) {
 
 // ===== 新增：实现方差稳定性检查方法 =====
 bool EcmpInstance::isCounterVarianceStable() {
-    if (m_counterHistory.size() < HISTORY_CYCLES_FOR_VARIANCE) {
+    if (m_wHistoryNum < HISTORY_CYCLES_FOR_VARIANCE) {
         return false;
     }
     
-    double varianceCoeff = utils::calculateCounterVarianceCoefficient(m_counterHistory, m_memberCounts);
-    bool isStable = varianceCoeff <= VARIANCE_THRESHOLD;
+    if (m_stabilityGate.getConfig().eMode == AI_ECMP_STABILITY_WEIGHTED) {
+        // 门限以SG配置为基准，按调优器当前参数组相对默认参数组的比例放宽或收紧
+        const T_AI_ECMP_STABILITY_RESULT& result = m_stabilityGate.evaluate(
+            m_stabilityGate.getConfig().errorThreshold * m_pCold->tuner.getStabilityScale());
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 方差稳定性检查 - 加权变异系数: %.6f, 估计相对误差: %.6f, 阈值: %.6f, 显著桶: %u（占负载 %.2f%%）, 结果: %s\n", 
+                      m_sgConfig.dwSgId, result.weightedCv, result.estimateError, result.threshold, result.dwMaterialBuckets,
+                      result.materialShare * 100.0, result.bStable ? "稳定" : "不稳定");
+        return result.bStable;
+    }
+    
+    double varianceThreshold = m_pCold->tuner.getActiveArm().varianceThreshold;
+    double varianceCoeff = utils::calculateCounterVarianceCoefficient(
+        m_counterHistory, m_wHistoryNum, m_rawCounters.size());
+    bool isStable = varianceCoeff <= varianceThreshold;
     
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 方差稳定性检查 - 变异系数: %.6f, 阈值: %.6f, 结果: %s\n", 
-                  m_sgConfig.dwSgId, varianceCoeff, VARIANCE_THRESHOLD, 
+                  m_sgConfig.dwSgId, varianceCoeff, varianceThreshold, 
                   isStable ? "稳定" : "不稳定");
     
     return isStable;
 }
 
+bool EcmpInstance::isCachedTableCompatible(const std::vector<WORD32>& cachedTable) const {
+    if (cachedTable.size() != m_ecmpMemberTable.size()) {
+        return false;
+    }
+    
+    for (WORD32 dwPortId : cachedTable) {
+        if (findPortIndex(dwPortId) == m_portIdList.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * @brief 评估优化效果是否达到最小改进阈值
  * @param beforeEval 优化前的评估结果
  * @param afterEval 优化后的评估结果
+ * @param candidateTable 候选成员表
  * @param minImprovementThreshold 最小改进阈值（百分比，默认1%）
- * @return true表示改进达到阈值，false表示改进不足
+ * @return true表示改进达到阈值（且在历史窗口上显著），false表示改进不足
  */
 bool EcmpInstance::isOptimizationEffective(
     const T_AI_ECMP_EVAL& beforeEval,
     const T_AI_ECMP_EVAL& afterEval,
+    const std::vector<WORD32>& candidateTable,
     double minImprovementThreshold) {
     
-    double improvementPercent = utils::calculateImprovementPercentage(beforeEval, afterEval);
-    return improvementPercent >= minImprovementThreshold;
+    const T_AI_ECMP_SIGNIFICANCE_RESULT& result = m_improvementTest.evaluate(
+        m_counterHistory, m_wHistoryHead, m_wHistoryNum, HISTORY_CYCLES_MAX,
+        m_ecmpMemberTable, candidateTable, m_portIdList, m_portSpeedList);
+    
+    // 未启用或历史样本不足时只比较最新一次负载估计
+    if (!result.bTested) {
+        double improvementPercent = utils::calculateImprovementPercentage(beforeEval, afterEval);
+        return improvementPercent >= minImprovementThreshold;
+    }
+    
+    bool bEffective = result.meanImprovement >= minImprovementThreshold && result.bSignificant;
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 显著性检验 - 样本: %u, 平均总偏差: %.6f -> %.6f (改进 %.2f%%), t: %.3f, 临界值: %.3f (置信度 %.2f), 结果: %s\n", 
+                  m_sgConfig.dwSgId, result.dwSamples, result.meanGapBefore, result.meanGapAfter,
+                  result.meanImprovement, result.tStat, result.tCritical, m_improvementTest.getConfig().confidence,
+                  bEffective ? "有效" : (result.bSignificant ? "改进不足" : "不显著"));
+    return bEffective;
+}
+
+void EcmpInstance::setLoadModel(const T_AI_ECMP_LOAD_MODEL_CFG& cfg) {
+    m_loadModel.configure(cfg);
+    m_loadModel.reset(m_rawCounters.size());
+    // 以当前累计值为基线重新积累估计
+    m_loadModel.update(m_rawCounters);
+    
+    const T_AI_ECMP_LOAD_MODEL_CFG& effectiveCfg = m_loadModel.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 负载模型切换为 %s（半衰期: %.1f 周期, 窗口: %u 周期）\n", 
+                  m_sgConfig.dwSgId, LoadModel::typeToString(effectiveCfg.eType),
+                  effectiveCfg.halfLifeCycles, effectiveCfg.dwWindowCycles);
+}
+
+void EcmpInstance::setElephantConfig(const T_AI_ECMP_ELEPHANT_CFG& cfg) {
+    m_elephantDetector.configure(cfg);
+    m_elephantDetector.reset(m_rawCounters.size());
+    
+    const T_AI_ECMP_ELEPHANT_CFG& effectiveCfg = m_elephantDetector.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 大流桶检测%s（进入门限: %.2f, 退出门限: %.2f 倍端口平均负载）\n", 
+                  m_sgConfig.dwSgId, effectiveCfg.bEnable ? "启用" : "禁用",
+                  effectiveCfg.enterShare, effectiveCfg.exitShare);
+}
+
+void EcmpInstance::setStabilityConfig(const T_AI_ECMP_STABILITY_CFG& cfg) {
+    m_stabilityGate.configure(cfg);
+    m_stabilityGate.reset(m_rawCounters.size());
+    
+    const T_AI_ECMP_STABILITY_CFG& effectiveCfg = m_stabilityGate.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 稳定性判定切换为 %s（门限: %.3f, 显著桶下限: %.2f 倍桶平均负载, 半衰期: %.1f 周期）\n", 
+                  m_sgConfig.dwSgId, StabilityGate::modeToString(effectiveCfg.eMode),
+                  effectiveCfg.errorThreshold, effectiveCfg.minBucketShare, effectiveCfg.halfLifeCycles);
+}
+
+void EcmpInstance::setInflightConfig(const T_AI_ECMP_INFLIGHT_CFG& cfg) {
+    m_pCold->inflight.configure(cfg);
+    
+    const T_AI_ECMP_INFLIGHT_CFG& effectiveCfg = m_pCold->inflight.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 修改确认超时 %u ms，最多重发 %u 次\n", 
+                  m_sgConfig.dwSgId, effectiveCfg.dwTimeoutMs, effectiveCfg.dwMaxRetries);
+}
+
+void EcmpInstance::setSignificanceConfig(const T_AI_ECMP_SIGNIFICANCE_CFG& cfg) {
+    m_improvementTest.configure(cfg);
+    
+    const T_AI_ECMP_SIGNIFICANCE_CFG& effectiveCfg = m_improvementTest.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 优化效果显著性检验%s（置信度: %.2f, 最少样本: %u）\n", 
+                  m_sgConfig.dwSgId, effectiveCfg.bEnable ? "启用" : "禁用",
+                  effectiveCfg.confidence, effectiveCfg.dwMinSamples);
+}
+
+void EcmpInstance::setForecaster(const T_AI_ECMP_FORECAST_CFG& cfg) {
+    m_forecaster.configure(cfg);
+    m_forecaster.reset(m_rawCounters.size());
+    
+    const T_AI_ECMP_FORECAST_CFG& effectiveCfg = m_forecaster.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 负载预测切换为 %s（alpha: %.2f, beta: %.2f, gamma: %.2f, 季节: %u 周期）\n", 
+                  m_sgConfig.dwSgId, LoadForecaster::typeToString(effectiveCfg.eType),
+                  effectiveCfg.alpha, effectiveCfg.beta, effectiveCfg.gamma, effectiveCfg.dwSeasonCycles);
 }
 
 // ===== 新增：优化控制方法实现 =====
@@ -7,7 +7,14 @@
 #include <string>
 #include "ai_ecmp_types.h"
 #include "ai_ecmp_algorithm_base.hpp"
-#include "ai_ecmp_printer.h"
+#include "ai_ecmp_tuner.hpp"
+#include "ai_ecmp_solution_cache.hpp"
+#include "ai_ecmp_load_model.hpp"
+#include "ai_ecmp_forecaster.hpp"
+#include "ai_ecmp_elephant.hpp"
+#include "ai_ecmp_stability.hpp"
+#include "ai_ecmp_significance.hpp"
+#include "ai_ecmp_inflight.hpp"
 
 
 namespace ai_ecmp {
@@ -26,6 +33,12 @@ public:
      * @param pAlgorithm 算法指针
      */
     void setAlgorithm(std::unique_ptr<AlgorithmBase>&& pAlgorithm);
+
+    /**
+     * @brief 获取当前使用的算法
+     * @return 算法指针，尚未创建时返回nullptr
+     */
+    AlgorithmBase* getAlgorithm() const { return m_pAlgorithm.get(); }
     
     /**
      * 构造函数
@@ -35,6 +48,9 @@ public:
     
     /**
      * 更新配置
+     * 仅逻辑成员映射或端口属性变化时增量更新并保留计数器历史；
+     * 仅有端口退出时只把故障端口上的桶重分配到存活端口，保留计数器历史；
+     * 逻辑成员数或端口集合其他变化时完全重置
      * @param sgCfg 新的SG配置
      */
     void updateConfig(const T_AI_ECMP_SG_CFG& sgCfg);
@@ -54,9 +70,10 @@ public:
     /**
      * 获取优化后的下一跳修改
      * @param nhopModify 输出参数，存储修改信息
+     * @param pDelta 输出参数（可为空），存储相对已下发成员表的增量；成员数不同时dwItemNum为0
      * @return 是否有修改
      */
-    bool getOptimizedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModify);
+    bool getOptimizedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModify, T_AI_ECMP_NHOP_DELTA* pDelta = nullptr);
     
     /**
      * 获取扩容后的下一跳修改
@@ -65,6 +82,80 @@ public:
      */
     bool getExpandedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModify);
     
+    /**
+     * 获取缩容后的下一跳修改（runOptimization规划的缩容成员表）
+     * @param nhopModify 输出参数，存储修改信息
+     * @return 是否有缩容配置
+     */
+    bool getCompactedNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModify);
+    
+    /**
+     * 端口故障事件：从端口集合中移除端口，并立即把其上的桶重分配到存活端口
+     * @param dwPortId 故障端口ID
+     * @return 是否产生了待下发的故障切换配置
+     */
+    bool onPortDown(WORD32 dwPortId);
+    
+    /**
+     * 获取故障切换后的下一跳修改（取走后清除待下发标志）
+     * @param nhopModify 输出参数，存储修改信息
+     * @param pDelta 输出参数（可为空），存储相对已下发成员表的增量
+     * @return 是否有待下发的故障切换配置
+     */
+    bool getFailoverNextHops(T_AI_ECMP_NHOP_MODIFY& nhopModify, T_AI_ECMP_NHOP_DELTA* pDelta = nullptr);
+    
+    /** 端口排空默认参数：每步迁移开始负载的25%，存活端口利用率不超过排空后平均值的1.2倍 */
+    static constexpr double DRAIN_DEFAULT_STEP_SHARE = 0.25;
+    static constexpr double DRAIN_DEFAULT_UTIL_CAP = 1.2;
+    /** 操作员允许超出利用率上限时，连续停滞达到该周期数后本步第一个桶忽略上限迁移 */
+    static constexpr WORD32 DRAIN_STALL_LIMIT = 3;
+    
+    /**
+     * 开始排空端口：此后每个优化周期下发一步迁移，直到端口上没有桶
+     * @param dwPortId 排空端口ID
+     * @param stepShare 每步迁移上限（开始时端口负载/桶数的比例），越界时收敛到有效范围
+     * @param utilCap 存活端口利用率上限（相对排空后平均利用率的倍数），不低于1
+     * @param bCapOverride 操作员是否允许停滞时超出利用率上限（默认不允许，上限为硬约束）
+     * @return 是否开始排空（端口不存在、是唯一端口或已有排空进行中时失败）
+     */
+    bool startDrain(WORD32 dwPortId, double stepShare, double utilCap, bool bCapOverride = false);
+    
+    /**
+     * 取消排空：已迁移的桶保持不变，恢复常规优化
+     */
+    void cancelDrain();
+    
+    /**
+     * 获取端口排空进度
+     */
+    const T_AI_ECMP_DRAIN_STATE& getDrainState() const { return m_pCold->drain; }
+    
+    /**
+     * 获取超出按速率公平分配份额的端口负载之和（即不均衡度 × 总流量），供周期调度器排序
+     * 基于最近一次计数器更新后的端口负载，O(端口数)
+     */
+    double getExcessLoad() const;
+    
+    /**
+     * 是否有必须在本周期下发的配置（故障切换、端口加入再均衡、排空进行中或待确认的修改已超时）
+     */
+    bool hasUrgentUpdate() const {
+        return m_bPendingFailover || m_bPendingRebalance || m_pCold->drain.bActive ||
+               m_pCold->inflight.isDue(InflightTracker::nowMicros());
+    }
+    
+    /**
+     * 是否有已下发、尚未被配置回显确认的修改（确认前暂停常规优化）
+     */
+    bool isAwaitingAck() const { return m_pCold->inflight.isActive(); }
+    
+    /**
+     * 检查待确认的修改是否超时：可重发时填写全量重发的修改，重发用尽时回滚到最近确认的成员表并填写其全量下发
+     * @param nhopModify 输出参数，动作为AI_ECMP_INFLIGHT_RETRY或AI_ECMP_INFLIGHT_ROLLBACK时存储要下发的修改
+     * @return 处理动作
+     */
+    T_AI_ECMP_INFLIGHT_ACTION pollInflight(T_AI_ECMP_NHOP_MODIFY& nhopModify);
+    
     /**
      * 评估当前负载均衡状态
      * @return 评估结果
@@ -118,10 +209,142 @@ public:
     WORD16 getCycle() const { return m_wCycle; }
     
     /**
-     * @brief 获取SG配置引用
-     * @return SG配置的常量引用
+     * @brief 获取最近一次平衡度评估结果
+     */
+    const T_AI_ECMP_EVAL& getLastEval() const { return m_lastEval; }
+    
+    /**
+     * @brief 获取连续调整失败次数
+     */
+    WORD32 getConsecutiveFailures() const { return m_consecutiveAdjustFailures; }
+    
+    /**
+     * @brief 获取最近一次优化算法的耗时（微秒）
+     */
+    WORD32 getLastOptimizeMicros() const { return m_pCold->dwLastOptimizeMicros; }
+    
+    /**
+     * @brief 获取SG配置头
+     * @return SG配置头的常量引用（成员数组不整体保存，见getMemberTable/getPortIds等）
+     */
+    const T_AI_ECMP_SG_HDR& getSgHeader() const { return m_sgConfig; }
+
+    /**
+     * @brief 获取逻辑成员表
+     * @return 成员表（下标为hash_index，值为portId）
+     */
+    const std::vector<WORD32>& getMemberTable() const { return m_ecmpMemberTable; }
+
+    /**
+     * @brief 获取端口数组（ID、速率、权重、负载按同一下标对应）
+     */
+    const std::vector<WORD32>& getPortIds() const { return m_portIdList; }
+    const std::vector<WORD32>& getPortSpeeds() const { return m_portSpeedList; }
+    const std::vector<WORD32>& getPortWeights() const { return m_portWeightList; }
+    const std::vector<WORD64>& getPortLoads() const { return m_portLoadList; }
+
+    /**
+     * @brief 获取在线参数调优器
+     * @return 调优器引用
+     */
+    ParameterTuner& getTuner() { return m_pCold->tuner; }
+
+    /**
+     * @brief 获取优化解缓存
+     * @return 解缓存常量引用
+     */
+    const SolutionCache& getSolutionCache() const { return m_pCold->solutionCache; }
+
+    /**
+     * @brief 设置负载模型（以当前累计计数为基线重新积累估计）
+     * @param cfg 负载模型配置
+     */
+    void setLoadModel(const T_AI_ECMP_LOAD_MODEL_CFG& cfg);
+
+    /**
+     * @brief 获取负载模型
+     * @return 负载模型常量引用
+     */
+    const LoadModel& getLoadModel() const { return m_loadModel; }
+
+    /**
+     * @brief 设置负载预测（清空已有预测状态，重新积累样本）
+     * @param cfg 负载预测配置
+     */
+    void setForecaster(const T_AI_ECMP_FORECAST_CFG& cfg);
+
+    /**
+     * @brief 获取负载预测器
+     * @return 负载预测器常量引用
+     */
+    const LoadForecaster& getForecaster() const { return m_forecaster; }
+
+    /**
+     * @brief 设置大流桶检测（清空已有大流集合，下个周期重新检测）
+     * @param cfg 大流桶检测配置
+     */
+    void setElephantConfig(const T_AI_ECMP_ELEPHANT_CFG& cfg);
+
+    /**
+     * @brief 获取大流桶检测器
+     * @return 大流桶检测器常量引用
+     */
+    const ElephantDetector& getElephantDetector() const { return m_elephantDetector; }
+
+    /**
+     * @brief 设置稳定性判定（清空已有统计，重新积累样本）
+     * @param cfg 稳定性判定配置
+     */
+    void setStabilityConfig(const T_AI_ECMP_STABILITY_CFG& cfg);
+
+    /**
+     * @brief 获取稳定性判定器
+     * @return 稳定性判定器常量引用
+     */
+    const StabilityGate& getStabilityGate() const { return m_stabilityGate; }
+
+    /**
+     * @brief 设置优化效果显著性检验
+     * @param cfg 显著性检验配置
      */
-    const T_AI_ECMP_SG_CFG& getSgConfig() const { return m_sgConfig; }
+    void setSignificanceConfig(const T_AI_ECMP_SIGNIFICANCE_CFG& cfg);
+
+    /**
+     * @brief 设置待确认修改跟踪（确认超时和重发次数）
+     * @param cfg 跟踪配置
+     */
+    void setInflightConfig(const T_AI_ECMP_INFLIGHT_CFG& cfg);
+
+    /**
+     * @brief 获取待确认修改跟踪器
+     * @return 跟踪器常量引用
+     */
+    const InflightTracker& getInflightTracker() const { return m_pCold->inflight; }
+
+    /**
+     * @brief 获取优化效果显著性检验器
+     * @return 显著性检验器常量引用
+     */
+    const ImprovementTest& getImprovementTest() const { return m_improvementTest; }
+
+    /**
+     * @brief 获取最近一次优化相对原成员表变化的表项
+     * @return 变化列表常量引用
+     */
+    const std::vector<T_AI_ECMP_MEMBER_CHANGE>& getLastMemberChanges() const { return m_pCold->memberChanges; }
+
+    /**
+     * @brief 启用或禁用优化报告（禁用时不分配打印器）
+     * @param bEnable true表示启用
+     */
+    void setReportEnabled(bool bEnable) { m_bReportEnabled = bEnable; }
+    bool isReportEnabled() const { return m_bReportEnabled; }
+
+    /**
+     * @brief 统计实例占用的内存字节数（含对象本身和各容器已分配容量，不含算法对象）
+     * @return 字节数
+     */
+    size_t getMemoryFootprint() const;
     
 private:
     // 扩容后等待调优的周期数
@@ -134,40 +357,78 @@ private:
     // 历史周期数量（用于方差计算）
     static constexpr WORD16 HISTORY_CYCLES_FOR_VARIANCE = 5;
     
-    // 方差稳定阈值（当方差小于此值时认为稳定）
-    static constexpr double VARIANCE_THRESHOLD = 0.05;  // 5%的变异系数阈值
+    // 方差稳定阈值、最小改进阈值及算法搜索参数由在线调优器 m_tuner 提供
+    // （调优器的方差门限仅用于旧稳定性判定方式，加权判定使用每SG的估计误差门限）
 
-    //选用算法
-    std::unique_ptr<AlgorithmBase> m_pAlgorithm;
-    // SG配置
-    T_AI_ECMP_SG_CFG m_sgConfig;
-    
-    // 逻辑成员映射表 (hash_index -> portId)
-    std::unordered_map<WORD32, WORD32> m_ecmpMemberTable;
-    
-    // 成员计数表 (hash_index -> count)
-    std::vector<WORD64> m_memberCounts;
-    
-    // 端口负载表 (portId -> load)
-    std::unordered_map<WORD32, WORD64> m_portLoads;
-    
-    // 端口速率表 (portId -> speed)
-    std::unordered_map<WORD32, WORD32> m_portSpeeds;
-    
-    // 多周期计数器历史
-    std::vector<std::vector<WORD64>> m_counterHistory;
-    
-    // 上一次评估结果
-    T_AI_ECMP_EVAL m_lastEval;
+    // 配置差异标志（updateConfig按差异类型决定增量更新或完全重置）
+    static constexpr WORD32 CFG_DIFF_NONE = 0x0;
+    static constexpr WORD32 CFG_DIFF_MEMBERS = 0x1;    // 逻辑成员端口映射变化
+    static constexpr WORD32 CFG_DIFF_PORT_ATTR = 0x2;  // 端口速率/权重变化
+    static constexpr WORD32 CFG_DIFF_PORT_SET = 0x4;   // 端口集合变化（结构变化）
+    static constexpr WORD32 CFG_DIFF_ITEM_NUM = 0x8;   // 逻辑成员数变化（结构变化）
+    static constexpr WORD32 CFG_DIFF_PORT_DOWN = 0x10; // 端口集合仅有端口退出（故障切换，保留历史）
+
+    // 缓存解校验时允许的得分回退（相对写入时的得分）
+    static constexpr double CACHE_SCORE_TOLERANCE = 0.02;
+
+    // 计数器历史保留的周期数
+    static constexpr WORD16 HISTORY_CYCLES_MAX = 10;
+
+    // 连续平衡多少个周期后尝试缩容
+    static constexpr WORD16 COMPACT_BALANCED_CYCLES = 20;
+
+    // 缩容后的平均偏差上限（与判定平衡的门限一致）
+    static constexpr double COMPACT_MAX_AVG_GAP = 0.05;
+
+    // 缩容后每端口至少保留的平均表项数，为后续交换留出调整空间
+    static constexpr WORD32 COMPACT_MIN_ITEMS_PER_PORT = 2;
+
+    // 扩容目标下各端口逻辑成员占比相对速率占比允许的最大相对偏差
+    static constexpr double EXPAND_SHARE_TOLERANCE = 0.1;
+
+    // 满足速率占比的旧成员数整数倍不超过最小满足数的该倍数时优先选用（计数器历史拆分精确）
+    static constexpr double EXPAND_MULTIPLE_SLACK = 1.5;
+
+    // 冷数据：只在优化流程和诊断中访问，单独分配以保持每周期访问的热数据紧凑
+    struct ColdState {
+        // 在线参数调优器（迭代次数、交换代价、方差门限、改进门限）
+        ParameterTuner tuner;
+        // 优化解缓存（按量化流量签名索引，配置变化时清空）
+        SolutionCache solutionCache;
+        // 算法输出缓冲区（跨周期复用）：优化后成员表及变化表项
+        std::vector<WORD32> optimizedTable;
+        std::vector<T_AI_ECMP_MEMBER_CHANGE> memberChanges;
+        // 大流桶预放置后的搜索起始成员表（跨周期复用）
+        std::vector<WORD32> placementTable;
+        // FTM侧的成员表：配置同步时取平台配置，每次生成下一跳修改后取下发的成员表，用于生成增量
+        std::vector<WORD32> deliveredTable;
+        // 已下发、待配置同步生效的扩容/缩容（逻辑成员数 from -> to，to为0表示无）
+        WORD32 dwResizeFromItemNum = 0;
+        WORD32 dwResizeToItemNum = 0;
+        // 端口排空进度（排空完成后保留，用于过滤平台配置中仍保留的已排空端口）
+        T_AI_ECMP_DRAIN_STATE drain = {};
+        // 已下发、待配置回显确认的修改
+        InflightTracker inflight;
+        // 最近一次优化算法的耗时（微秒）
+        WORD32 dwLastOptimizeMicros = 0;
+    };
+
+    // ===== 热数据：每个周期访问 =====
+    // SG配置头（逻辑成员映射保存在m_ecmpMemberTable，端口属性保存在端口数组）
+    T_AI_ECMP_SG_HDR m_sgConfig;
     
     // 当前状态
     T_AI_ECMP_STATUS m_status;
 
     // 监测周期数
     WORD16 m_wCycle;
-
-    // 优化结果打印器
-    std::unique_ptr<EcmpPrinter> m_pPrinter;
+    
+    // 连续处于平衡状态的周期数（用于缩容判定）
+    WORD16 m_wBalancedCycles;
+    
+    // 计数器历史环形缓冲的写位置和有效周期数
+    WORD16 m_wHistoryHead;
+    WORD16 m_wHistoryNum;
 
     // ===== 扩容控制相关变量 =====
     // 上次扩容的周期数
@@ -185,16 +446,136 @@ private:
     // ===== 新增：优化控制相关变量 =====
     // 优化算法启用标志（默认启用）
     bool m_bOptimizationEnabled;
+
+    // 端口加入后已调整成员表、待下发的标志
+    bool m_bPendingRebalance;
+
+    // 端口故障后已重分配故障端口的桶、待下发的标志
+    bool m_bPendingFailover;
+
+    // 优化报告启用标志（默认启用，打印器仅在报告时临时分配）
+    bool m_bReportEnabled;
     
     // 禁用期间的周期计数
     WORD32 m_dwDisabledCycles;
+    
+    // 逻辑成员表（下标为hash_index，值为portId）
+    std::vector<WORD32> m_ecmpMemberTable;
+    
+    // 原始累计计数 (hash_index -> counter)，首次收到计数时分配
+    std::vector<WORD64> m_rawCounters;
+    
+    // 多周期计数器历史：HISTORY_CYCLES_MAX个周期平铺存放的环形缓冲，首次收到计数时分配
+    std::vector<WORD64> m_counterHistory;
+    
+    // 负载模型：由原始累计计数得到平滑的每周期负载估计（即成员计数表，供优化器使用）
+    LoadModel m_loadModel;
+    
+    // 负载预测：由计数器历史预测下一周期每桶速率，就绪后替代负载模型估计供优化器使用
+    LoadForecaster m_forecaster;
+    
+    // 大流桶检测：在成员计数表上识别大流桶，优化时先固定放置大流桶再搜索其余桶
+    ElephantDetector m_elephantDetector;
+    
+    // 稳定性判定：增量维护每桶速率统计，按流量加权判定计数器数据是否足够稳定
+    StabilityGate m_stabilityGate;
+    
+    // 优化效果显著性检验：在计数器历史窗口上对候选成员表和当前成员表做配对检验
+    ImprovementTest m_improvementTest;
+    
+    // 端口ID、速率、权重及负载数组（按同一下标对应，供算法以视图方式访问）
+    std::vector<WORD32> m_portIdList;
+    std::vector<WORD32> m_portSpeedList;
+    std::vector<WORD32> m_portWeightList;
+    std::vector<WORD64> m_portLoadList;
+    
+    // 上一次评估结果
+    T_AI_ECMP_EVAL m_lastEval;
 
+    // ===== 冷数据 =====
+    //选用算法
+    std::unique_ptr<AlgorithmBase> m_pAlgorithm;
+    
+    std::unique_ptr<ColdState> m_pCold;
+    
+    // 成员计数表 (hash_index -> count)：预测就绪时为下一周期预测值，否则为负载模型的估计值
+    const std::vector<WORD64>& getMemberCounts() const {
+        return m_forecaster.isReady() ? m_forecaster.getForecast() : m_loadModel.getEstimate();
+    }
+    
+    // 应用已过滤的配置（updateConfig的实现）
+    void applyConfig(const T_AI_ECMP_SG_CFG& sgConfig);
+    
+    // 平台配置仍包含已排空端口时，返回去掉该端口后的配置副本；端口已移除或重新有桶指向时清除排空记录并返回空
+    std::unique_ptr<T_AI_ECMP_SG_CFG> excludeDrainedPort(const T_AI_ECMP_SG_CFG& sgConfig);
+    
+    // 执行一步排空迁移，返回是否产生了待下发的成员表
+    bool runDrainStep();
+    
+    // 排空停滞时用常规算法在存活端口间再均衡（排空端口上的桶不参与），返回是否产生了待下发的成员表
+    bool rebalanceForDrain(size_t drainIndex);
+    
+    // 从端口数组中移除端口
+    void removePort(size_t portIndex);
+    
+    // 保存SG配置头
+    void setSgHeader(const T_AI_ECMP_SG_CFG& sgConfig);
+    
+    // 按成员数分配计数器相关状态（首次收到计数时调用）
+    void allocCounterState();
+    
+    // 释放计数器相关状态
+    void releaseCounterState();
+    
+    // 扩容/缩容生效后，将旧成员数下的计数器历史拆分或合并到新表项并回放，重建负载模型和预测
+    void carryOverResizedHistory(const std::vector<WORD64>& oldHistory, WORD32 dwOldItemNum,
+                                 WORD16 wOldHead, WORD16 wOldNum);
+    
+    // 按端口速率选择扩容目标成员数，各端口逻辑成员数写入weights；无法扩容时返回0
+    WORD32 selectExpandTarget(const std::vector<WORD32>& portSpeeds, WORD32 dwCurrentItemNum,
+                              std::vector<WORD32>& weights);
+    
+    // 规划缩容：在成员数的约数中找最小的、合并后仍平衡的目标，结果写入m_pCold->optimizedTable
+    bool planCompaction();
+    
+    // 查找端口在端口数组中的下标，不存在时返回端口数
+    size_t findPortIndex(WORD32 dwPortId) const;
     
     // 计算负载分布指标
     void calculateLoadMetrics();
     
     // 将配置转换为内部数据结构
-    void convertConfig();
+    void convertConfig(const T_AI_ECMP_SG_CFG& sgConfig);
+    
+    // 按平台配置重置FTM侧成员表（增量下发的基准）
+    void syncDeliveredTable(const T_AI_ECMP_SG_CFG& sgConfig);
+    
+    // 记录已下发的成员表，开始等待确认
+    void recordDelivered(const T_AI_ECMP_NHOP_MODIFY& nhopModify);
+    
+    // 修改确认生效后丢弃首次下发后采集的计数器周期（跨越成员表切换），保留下发前的有效周期
+    void discardStaleWindows();
+    
+    // 按保留的计数器历史重建负载模型、预测、稳定性门限和大流集合
+    void replayHistory();
+    
+    // 将端口配置转换为端口数组
+    void convertPortConfig(const T_AI_ECMP_SG_CFG& sgConfig);
+    
+    // 比较新旧配置，返回CFG_DIFF_*标志组合
+    WORD32 diffConfig(const T_AI_ECMP_SG_CFG& sgConfig) const;
+    
+    // 新端口加入时，按旧负载估计从负载最高的端口迁移桶给新端口
+    void assignBucketsToNewPorts(const std::vector<WORD32>& oldPortIds, const std::vector<WORD64>& oldEstimate);
+    
+    // 端口退出后，把prevTable中指向已不存在端口的桶按负载降序逐个放到放入后归一化负载最小的存活端口
+    bool redistributeOrphanBuckets(const std::vector<WORD32>& prevTable);
+    
+    // 将大流桶按负载降序装箱到归一化负载最小的端口（同等条件下优先高速端口）
+    void placeElephants(std::vector<WORD32>& table, const std::vector<WORD64>& memberCounts) const;
+    
+    // 检查是否存在单个大流桶超过最快端口的公平份额（放置无法解决，需要扩容）
+    bool hasOversizedElephant(const std::vector<WORD64>& memberCounts) const;
     
     // 检查是否需要扩容
     bool needExpansion();
@@ -215,14 +596,22 @@ private:
     
     /**
      * @brief 检查计数器数据方差是否稳定
+     * 加权方式下以显著桶按流量占比加权的速率变异系数与门限比较；旧方式下为累计计数历史上各桶变异系数的平均
      * @return true表示方差稳定，可以进行优化；false表示需要继续等待
      */
     bool isCounterVarianceStable();
 
-    //评估优化效果是否达到最小改进阈值
+    // 检查缓存的成员表是否与当前配置匹配（表项集合和端口集合）
+    bool isCachedTableCompatible(const std::vector<WORD32>& cachedTable) const;
+
+    /**
+     * @brief 评估优化效果是否达到最小改进阈值
+     * 历史窗口样本足够时按窗口上的平均改进和配对检验的显著性判定，否则只比较最新一次负载估计
+     */
     bool isOptimizationEffective(
         const T_AI_ECMP_EVAL& beforeEval,
         const T_AI_ECMP_EVAL& afterEval,
+        const std::vector<WORD32>& candidateTable,
         double minImprovementThreshold = 1.0);
 
 };
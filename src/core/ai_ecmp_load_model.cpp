@@ -0,0 +1,138 @@
+#include "ai_ecmp_load_model.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ai_ecmp {
+
+LoadModel::LoadModel()
+    : m_alpha(1.0)
+    , m_decay(0.0)
+    , m_bHasBaseline(false)
+    , m_dwSamples(0)
+    , m_dwWindowPos(0) {
+    // 默认：半衰期3个周期的EWMA，几个周期内即可跟上真实的流量迁移
+    T_AI_ECMP_LOAD_MODEL_CFG cfg = {AI_ECMP_LOAD_MODEL_EWMA, 3.0, 8};
+    configure(cfg);
+}
+
+void LoadModel::configure(const T_AI_ECMP_LOAD_MODEL_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.halfLifeCycles = std::max(m_cfg.halfLifeCycles, 0.5);
+    m_cfg.dwWindowCycles = std::min(std::max(m_cfg.dwWindowCycles, static_cast<WORD32>(1)), MAX_WINDOW_CYCLES);
+
+    // 半衰期h：经过h个周期后旧样本的权重衰减为一半
+    m_decay = std::pow(0.5, 1.0 / m_cfg.halfLifeCycles);
+    m_alpha = 1.0 - m_decay;
+
+    reset(m_lastRaw.size());
+}
+
+void LoadModel::reset(size_t bucketNum) {
+    m_bHasBaseline = false;
+    m_dwSamples = 0;
+    m_dwWindowPos = 0;
+    m_lastRaw.assign(bucketNum, 0);
+    m_estimate.assign(bucketNum, 0);
+    // 只为当前模型分配内部状态，其余释放
+    if (m_cfg.eType == AI_ECMP_LOAD_MODEL_EWMA || m_cfg.eType == AI_ECMP_LOAD_MODEL_PEAK_HOLD) {
+        m_smoothed.assign(bucketNum, 0.0);
+    } else {
+        std::vector<double>().swap(m_smoothed);
+    }
+    if (m_cfg.eType == AI_ECMP_LOAD_MODEL_WINDOW) {
+        m_window.assign(bucketNum * m_cfg.dwWindowCycles, 0);
+        m_windowSum.assign(bucketNum, 0);
+    } else {
+        std::vector<WORD64>().swap(m_window);
+        std::vector<WORD64>().swap(m_windowSum);
+    }
+    if (bucketNum == 0) {
+        std::vector<WORD64>().swap(m_lastRaw);
+        std::vector<WORD64>().swap(m_estimate);
+    }
+}
+
+void LoadModel::update(const std::vector<WORD64>& rawCounters) {
+    if (rawCounters.size() != m_lastRaw.size()) {
+        reset(rawCounters.size());
+    }
+
+    const size_t bucketNum = rawCounters.size();
+
+    if (m_cfg.eType == AI_ECMP_LOAD_MODEL_RAW) {
+        m_estimate.assign(rawCounters.begin(), rawCounters.end());
+        m_lastRaw.assign(rawCounters.begin(), rawCounters.end());
+        m_bHasBaseline = true;
+        m_dwSamples++;
+        return;
+    }
+
+    // 首个周期只建立基线，避免把上电以来的累计值当作一个周期的速率
+    if (!m_bHasBaseline) {
+        m_lastRaw.assign(rawCounters.begin(), rawCounters.end());
+        m_bHasBaseline = true;
+        return;
+    }
+
+    const WORD32 dwWindow = m_cfg.dwWindowCycles;
+    const WORD32 dwFill = std::min(m_dwSamples + 1, dwWindow);
+
+    for (size_t i = 0; i < bucketNum; ++i) {
+        WORD64 qwRate = rawCounters[i] >= m_lastRaw[i] ? rawCounters[i] - m_lastRaw[i] : rawCounters[i];
+        m_lastRaw[i] = rawCounters[i];
+
+        switch (m_cfg.eType) {
+            case AI_ECMP_LOAD_MODEL_EWMA:
+                if (m_dwSamples == 0) {
+                    m_smoothed[i] = static_cast<double>(qwRate);
+                } else {
+                    m_smoothed[i] += m_alpha * (static_cast<double>(qwRate) - m_smoothed[i]);
+                }
+                m_estimate[i] = static_cast<WORD64>(m_smoothed[i] + 0.5);
+                break;
+
+            case AI_ECMP_LOAD_MODEL_WINDOW: {
+                WORD64& qwSlot = m_window[i * dwWindow + m_dwWindowPos];
+                m_windowSum[i] = m_windowSum[i] - qwSlot + qwRate;
+                qwSlot = qwRate;
+                m_estimate[i] = (m_windowSum[i] + dwFill / 2) / dwFill;
+                break;
+            }
+
+            case AI_ECMP_LOAD_MODEL_PEAK_HOLD:
+                m_smoothed[i] = std::max(static_cast<double>(qwRate), m_smoothed[i] * m_decay);
+                m_estimate[i] = static_cast<WORD64>(m_smoothed[i] + 0.5);
+                break;
+
+            default:
+                m_estimate[i] = qwRate;
+                break;
+        }
+    }
+
+    if (m_cfg.eType == AI_ECMP_LOAD_MODEL_WINDOW) {
+        m_dwWindowPos = (m_dwWindowPos + 1) % dwWindow;
+    }
+    m_dwSamples++;
+}
+
+size_t LoadModel::getMemoryFootprint() const {
+    return sizeof(*this)
+        + m_lastRaw.capacity() * sizeof(WORD64)
+        + m_smoothed.capacity() * sizeof(double)
+        + m_window.capacity() * sizeof(WORD64)
+        + m_windowSum.capacity() * sizeof(WORD64)
+        + m_estimate.capacity() * sizeof(WORD64);
+}
+
+const char* LoadModel::typeToString(T_AI_ECMP_LOAD_MODEL_TYPE eType) {
+    switch (eType) {
+        case AI_ECMP_LOAD_MODEL_RAW:       return "RAW";
+        case AI_ECMP_LOAD_MODEL_EWMA:      return "EWMA";
+        case AI_ECMP_LOAD_MODEL_WINDOW:    return "WINDOW";
+        case AI_ECMP_LOAD_MODEL_PEAK_HOLD: return "PEAK_HOLD";
+        default:                           return "UNKNOWN";
+    }
+}
+
+} // namespace ai_ecmp
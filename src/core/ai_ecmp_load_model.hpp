@@ -0,0 +1,101 @@
+#ifndef AI_ECMP_LOAD_MODEL_HPP
+#define AI_ECMP_LOAD_MODEL_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 负载模型类型
+ */
+typedef enum {
+    AI_ECMP_LOAD_MODEL_RAW = 0,     /* 原始累计计数（不做平滑，兼容旧行为） */
+    AI_ECMP_LOAD_MODEL_EWMA,        /* 指数加权移动平均（按半衰期） */
+    AI_ECMP_LOAD_MODEL_WINDOW,      /* 滑动窗口均值 */
+    AI_ECMP_LOAD_MODEL_PEAK_HOLD    /* 峰值保持（按半衰期衰减） */
+} T_AI_ECMP_LOAD_MODEL_TYPE;
+
+/**
+ * 负载模型配置
+ */
+typedef struct {
+    T_AI_ECMP_LOAD_MODEL_TYPE eType;    /* 模型类型 */
+    double halfLifeCycles;              /* EWMA/峰值保持的半衰期（周期数） */
+    WORD32 dwWindowCycles;              /* 滑动窗口长度（周期数） */
+} T_AI_ECMP_LOAD_MODEL_CFG;
+
+/**
+ * 每桶负载速率模型
+ * 输入为各桶的累计计数，按周期差分得到速率，再增量维护平滑估计；
+ * 优化器看到的是平滑后的每周期负载估计，而不是单调增长的累计值
+ */
+class LoadModel {
+public:
+    /** 最大窗口长度（周期数） */
+    static constexpr WORD32 MAX_WINDOW_CYCLES = 32;
+
+    LoadModel();
+
+    /**
+     * @brief 设置模型配置，参数越界时收敛到有效范围，并清空已有估计
+     * @param cfg 模型配置
+     */
+    void configure(const T_AI_ECMP_LOAD_MODEL_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_LOAD_MODEL_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 按桶数重置模型状态
+     * @param bucketNum 桶数
+     */
+    void reset(size_t bucketNum);
+
+    /**
+     * @brief 输入一个周期的累计计数，更新每桶估计
+     * @param rawCounters 各桶累计计数（计数回绕或清零时按新值计为本周期增量）
+     */
+    void update(const std::vector<WORD64>& rawCounters);
+
+    /**
+     * @brief 获取每桶负载估计
+     * @return 估计值数组（与桶数等长）
+     */
+    const std::vector<WORD64>& getEstimate() const { return m_estimate; }
+
+    /**
+     * @brief 获取已输入的速率样本数（首个周期只建立基线，不计入）
+     */
+    WORD32 getSampleCount() const { return m_dwSamples; }
+
+    /**
+     * @brief 获取模型占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @brief 获取模型类型名称
+     */
+    static const char* typeToString(T_AI_ECMP_LOAD_MODEL_TYPE eType);
+
+private:
+    T_AI_ECMP_LOAD_MODEL_CFG m_cfg;
+    double m_alpha;                     /* EWMA系数，由半衰期换算 */
+    double m_decay;                     /* 峰值保持每周期衰减系数，由半衰期换算 */
+
+    bool m_bHasBaseline;                /* 是否已有上一周期累计值 */
+    WORD32 m_dwSamples;                 /* 速率样本数 */
+    std::vector<WORD64> m_lastRaw;      /* 上一周期累计值 */
+    std::vector<double> m_smoothed;     /* EWMA / 峰值保持的内部估计（其他模型不分配） */
+    std::vector<WORD64> m_window;       /* 滑动窗口环形缓冲（桶 x 窗口，按桶连续存放，仅滑动窗口模型分配） */
+    std::vector<WORD64> m_windowSum;    /* 各桶窗口内速率之和 */
+    WORD32 m_dwWindowPos;               /* 环形缓冲写位置 */
+    std::vector<WORD64> m_estimate;     /* 对外的每桶估计 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_LOAD_MODEL_HPP */
@@ -2,8 +2,11 @@
 #include "ai_ecmp_error.h"
 #include "ai_ecmp_instance.hpp"
 #include "ai_ecmp_api.h"
+#include "ai_ecmp_main.hpp"
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 
 
@@ -19,29 +22,79 @@ WORD32 CAISlbManagerSingleton::handleSgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_
         return AI_ECMP_ERR_INVALID_PARAM; // 无效参数
     }
     
+    // 先处理已暂存的批量配置，保证配置按下发顺序生效
+    std::lock_guard<std::mutex> stageLock(m_stageMutex);
+    flushStagedSgConfigs();
+    
     WORD32 dwSgId = pSgCfg->dwSgId;
+    const WORD32 dwItemNum = pSgCfg->dwItemNum;
+    T_AI_ECMP_STATUS_UPDATE status;
     
     if (bSwitchFlag == 1) {
-        // 新增或更新SG配置
-        auto it = m_instances.find(dwSgId);
+        // 新增或更新SG配置：结构锁内只查找或在实例池中创建实例
+        T_AI_ECMP_INSTANCE_HANDLE handle;
+        bool bCreated = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_instances.find(dwSgId, handle)) {
+                if (!m_instances.create(*pSgCfg, handle)) {
+                    XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 实例池已满, SG ID: %u .\n", __FUNCTION__, dwSgId);
+                    return AI_ECMP_ERR_NO_MEMORY;
+                }
+                bCreated = true;
+            }
+        }
+        
+        // 相位规划属于优化路径，投递到邮箱由下个节拍执行
+        post([this, dwSgId, dwItemNum]() { m_phasePlanner.addSg(dwSgId, dwItemNum); });
+        
+        // 只锁本实例：优化路径正在处理其他实例时不受影响，正在处理本实例时等待其处理完成
+        InstanceRef pInstance = m_instances.acquire(handle);
+        if (!pInstance) {
+            return AI_ECMP_ERR_NOT_FOUND; // 并发删除
+        }
         
-        if (it == m_instances.end()) {
-            // 创建新实例
-            std::unique_ptr<EcmpInstance> pInstance(new EcmpInstance(*pSgCfg));
-            m_instances[dwSgId] = std::move(pInstance);
+        if (bCreated) {
             LogSgConfigDetails(pSgCfg);
             XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 创建了新的ECMP实例, SG ID: %u .\n", __FUNCTION__, dwSgId);
         } else {
             // 更新现有实例
-            it->second->updateConfig(*pSgCfg);
+            pInstance->updateConfig(*pSgCfg);
             LogSgConfigDetails(pSgCfg);
             XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 更新了ECMP实例配置, SG ID: %u .\n", __FUNCTION__, dwSgId);
+            
+            // 端口退出的故障切换结果立即下发，不等待下个优化周期
+            T_AI_ECMP_NHOP_MODIFY nhopModifyData = {};
+            T_AI_ECMP_NHOP_DELTA nhopDelta = {};
+            if (pInstance->getFailoverNextHops(nhopModifyData, &nhopDelta)) {
+                submitNhopModify(nhopModifyData, &nhopDelta);
+                flushNhopModify();
+                XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 故障切换配置已下发, SG ID: %u .\n", __FUNCTION__, dwSgId);
+            }
         }
+        
+        m_statusBoard.capture({dwSgId, handle}, *pInstance.get(), status);
+        m_statusBoard.publish(std::vector<T_AI_ECMP_STATUS_UPDATE>(1, status), std::vector<T_AI_ECMP_POOL_ENTRY>());
     } else if (bSwitchFlag == 0) {
-        // 删除SG配置
-        auto it = m_instances.find(dwSgId);
-        if (it != m_instances.end()) {
-            m_instances.erase(it);
+        // 删除SG配置：先从索引摘除，再释放实例，最后回收槽
+        T_AI_ECMP_INSTANCE_HANDLE handle;
+        bool bFound = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            bFound = m_instances.detach(dwSgId, handle);
+        }
+        if (bFound) {
+            m_instances.release(handle);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_instances.recycle(handle);
+            }
+            post([this, dwSgId]() {
+                m_phasePlanner.removeSg(dwSgId);
+                m_scheduler.removeSg(dwSgId);
+            });
+            m_statusBoard.publish(std::vector<T_AI_ECMP_STATUS_UPDATE>(),
+                                  std::vector<T_AI_ECMP_POOL_ENTRY>(1, T_AI_ECMP_POOL_ENTRY{dwSgId, handle}));
             XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 删除了ECMP实例, SG ID: %u .\n", __FUNCTION__, dwSgId);
         }
     } else {
@@ -51,9 +104,311 @@ WORD32 CAISlbManagerSingleton::handleSgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_
     return AI_SUCCESS; // 成功
 }
 
-WORD32 CAISlbManagerSingleton::runOptimizationCycle(T_AI_ECMP_COUNTER_STATS_MSG ecmpMsg) {
+// 批量创建时每个工作线程至少构造的实例数，实例较少时线程开销大于并行收益
+static const size_t BATCH_BUILD_MIN_PER_WORKER = 256;
+// 批量创建的最大工作线程数
+static const size_t BATCH_BUILD_MAX_WORKERS = 8;
+// 暂存的批量配置上限，超过后不等最后一条消息先处理已暂存的配置
+static const size_t BATCH_STAGE_MAX_CFGS = 16384;
+
+// 批量配置的基本校验：成员数不超过配置数组长度
+static bool isValidSgConfig(const T_AI_ECMP_SG_CFG& sgCfg) {
+    return sgCfg.dwItemNum <= FTM_TRUNK_MAX_HASH_NUM_15K && sgCfg.dwPortNum <= FTM_LAG_MAX_MEM_NUM_15K;
+}
+
+WORD32 CAISlbManagerSingleton::handleSgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags,
+                                                   T_AI_ECMP_SG_BATCH_RESULT* pResult) {
+    std::lock_guard<std::mutex> stageLock(m_stageMutex);
+    flushStagedSgConfigs();
+    return processSgConfigBatch(pSgCfgs, dwSgNum, dwFlags & ~AI_ECMP_SG_BATCH_MORE, pResult);
+}
+
+WORD32 CAISlbManagerSingleton::stageSgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags) {
+    if (!pSgCfgs && dwSgNum > 0) {
+        return AI_ECMP_ERR_INVALID_PARAM; // 无效参数
+    }
+    
+    std::lock_guard<std::mutex> stageLock(m_stageMutex);
+    const WORD32 dwBatchFlags = dwFlags & ~AI_ECMP_SG_BATCH_MORE;
+    
+    // 删除与新增不合并：方式变化时先处理已暂存的配置
+    if (!m_stagedCfgs.empty() && ((m_dwStagedFlags ^ dwBatchFlags) & AI_ECMP_SG_BATCH_DELETE) != 0) {
+        flushStagedSgConfigs();
+    }
+    m_stagedCfgs.insert(m_stagedCfgs.end(), pSgCfgs, pSgCfgs + dwSgNum);
+    m_dwStagedFlags |= dwBatchFlags;
+    m_dwStagedMsgNum++;
+    
+    if ((dwFlags & AI_ECMP_SG_BATCH_MORE) != 0 && m_stagedCfgs.size() < BATCH_STAGE_MAX_CFGS) {
+        return AI_SUCCESS;
+    }
+    return flushStagedSgConfigs();
+}
+
+WORD32 CAISlbManagerSingleton::flushStagedSgConfigs() {
+    if (m_stagedCfgs.empty()) {
+        m_dwStagedMsgNum = 0;
+        return AI_SUCCESS;
+    }
+    
+    XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 处理暂存的批量SG配置, 消息数: %u, 配置数: %zu .\n",
+               __FUNCTION__, m_dwStagedMsgNum, m_stagedCfgs.size());
+    WORD32 dwRet = processSgConfigBatch(m_stagedCfgs.data(), static_cast<WORD32>(m_stagedCfgs.size()),
+                                        m_dwStagedFlags, NULL);
+    
+    // 暂存区只在同步期间使用，处理后释放
+    std::vector<T_AI_ECMP_SG_CFG>().swap(m_stagedCfgs);
+    m_dwStagedFlags = 0;
+    m_dwStagedMsgNum = 0;
+    return dwRet;
+}
+
+WORD32 CAISlbManagerSingleton::processSgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags,
+                                                    T_AI_ECMP_SG_BATCH_RESULT* pResult) {
+    if (!pSgCfgs && dwSgNum > 0) {
+        return AI_ECMP_ERR_INVALID_PARAM; // 无效参数
+    }
+    
+    auto startTime = std::chrono::steady_clock::now();
+    T_AI_ECMP_SG_BATCH_RESULT result = {};
+    
+    // 校验后按SG ID排序去重，同一SG以批量中最后一个配置为准（删除只用到SG ID，不校验成员）
+    const bool bDelete = (dwFlags & AI_ECMP_SG_BATCH_DELETE) != 0;
+    std::vector<const T_AI_ECMP_SG_CFG*> configs;
+    configs.reserve(dwSgNum);
+    for (WORD32 i = 0; i < dwSgNum; ++i) {
+        if (bDelete || isValidSgConfig(pSgCfgs[i])) {
+            configs.push_back(&pSgCfgs[i]);
+        } else {
+            result.dwRejected++;
+        }
+    }
+    std::stable_sort(configs.begin(), configs.end(),
+                     [](const T_AI_ECMP_SG_CFG* pLeft, const T_AI_ECMP_SG_CFG* pRight) {
+                         return pLeft->dwSgId < pRight->dwSgId;
+                     });
+    size_t uniqueNum = 0;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        if (i + 1 < configs.size() && configs[i + 1]->dwSgId == configs[i]->dwSgId) {
+            result.dwDuplicated++;
+            continue;
+        }
+        configs[uniqueNum++] = configs[i];
+    }
+    configs.resize(uniqueNum);
+    
+    WORD32 dwRet = AI_SUCCESS;
+    if (bDelete) {
+        removeSgBatch(configs, result);
+    } else {
+        dwRet = applySgConfigBatch(configs, dwFlags, result);
+    }
+    if (dwRet == AI_SUCCESS && result.dwRejected > 0) {
+        dwRet = AI_ECMP_ERR_CONFIG_INVALID;
+    }
+    
+    WORD64 qwMicros = static_cast<WORD64>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+    XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 批量SG配置完成, 配置数: %u, 新建: %u, 更新: %u, 删除: %u, 重复: %u, 拒绝: %u, 耗时: %llu us .\n",
+               __FUNCTION__, dwSgNum, result.dwCreated, result.dwUpdated, result.dwRemoved,
+               result.dwDuplicated, result.dwRejected, qwMicros);
+    
+    if (pResult) {
+        *pResult = result;
+    }
+    return dwRet;
+}
+
+WORD32 CAISlbManagerSingleton::applySgConfigBatch(const std::vector<const T_AI_ECMP_SG_CFG*>& configs, WORD32 dwFlags,
+                                                  T_AI_ECMP_SG_BATCH_RESULT& result) {
+    WORD32 dwRet = AI_SUCCESS;
+    std::vector<BatchItem> creates;
+    std::vector<BatchItem> updates;
+    
+    // 结构锁内一次完成所有查找和取槽，索引按批量后的实例数预先扩容
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_instances.reserve(static_cast<WORD32>(m_instances.size() + configs.size()));
+        for (const T_AI_ECMP_SG_CFG* pSgCfg : configs) {
+            T_AI_ECMP_INSTANCE_HANDLE handle;
+            if (m_instances.find(pSgCfg->dwSgId, handle)) {
+                updates.push_back(BatchItem(pSgCfg, handle));
+            } else if (m_instances.allocate(handle)) {
+                creates.push_back(BatchItem(pSgCfg, handle));
+            } else {
+                result.dwRejected++;
+                dwRet = AI_ECMP_ERR_NO_MEMORY;
+            }
+        }
+    }
+    if (dwRet != AI_SUCCESS) {
+        XOS_SysLog(LOG_EMERGENCY, "[AI ECMP]  %s : 实例池已满, %u 个SG未创建 .\n", __FUNCTION__, result.dwRejected);
+    }
+    
+    // 新实例在锁外构造，构造完成后才加入索引，其他上下文不会看到未构造的实例
+    buildInstances(creates);
+    
+    std::vector<BatchItem> lost;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t createdNum = 0;
+        for (const BatchItem& item : creates) {
+            if (m_instances.insert(item.first->dwSgId, item.second)) {
+                creates[createdNum++] = item;
+            } else {
+                lost.push_back(item);
+            }
+        }
+        creates.resize(createdNum);
+    }
+    
+    // 构造期间其他上下文已创建了同一SG：释放本次构造的实例，改为更新已有实例
+    for (const BatchItem& item : lost) {
+        m_instances.release(item.second);
+    }
+    if (!lost.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const BatchItem& item : lost) {
+            m_instances.recycle(item.second);
+            T_AI_ECMP_INSTANCE_HANDLE handle;
+            if (m_instances.find(item.first->dwSgId, handle)) {
+                updates.push_back(BatchItem(item.first, handle));
+            }
+        }
+    }
+    
+    std::vector<T_AI_ECMP_STATUS_UPDATE> statusList;
+    std::vector<std::pair<WORD32, WORD32>> phaseSgs;
+    statusList.reserve(creates.size() + updates.size());
+    phaseSgs.reserve(creates.size() + updates.size());
+    
+    for (const BatchItem& item : creates) {
+        InstanceRef pInstance = m_instances.acquire(item.second);
+        if (!pInstance) {
+            continue; // 并发删除
+        }
+        statusList.emplace_back();
+        m_statusBoard.capture({item.first->dwSgId, item.second}, *pInstance.get(), statusList.back());
+        phaseSgs.push_back(std::make_pair(item.first->dwSgId, item.first->dwItemNum));
+        result.dwCreated++;
+    }
+    
+    // 更新逐个实例加锁进行，故障切换结果收集后一次下发
+    T_AI_ECMP_NHOP_MODIFY nhopModifyData = {};
+    T_AI_ECMP_NHOP_DELTA nhopDelta = {};
+    bool bFailover = false;
+    for (const BatchItem& item : updates) {
+        InstanceRef pInstance = m_instances.acquire(item.second);
+        if (!pInstance) {
+            continue; // 并发删除
+        }
+        pInstance->updateConfig(*item.first);
+        if (pInstance->getFailoverNextHops(nhopModifyData, &nhopDelta)) {
+            submitNhopModify(nhopModifyData, &nhopDelta);
+            bFailover = true;
+        }
+        statusList.emplace_back();
+        m_statusBoard.capture({item.first->dwSgId, item.second}, *pInstance.get(), statusList.back());
+        phaseSgs.push_back(std::make_pair(item.first->dwSgId, item.first->dwItemNum));
+        result.dwUpdated++;
+    }
+    if (bFailover) {
+        flushNhopModify();
+    }
+    
+    if (dwFlags & AI_ECMP_SG_BATCH_VERBOSE) {
+        for (const BatchItem& item : creates) {
+            LogSgConfigDetails(item.first);
+        }
+        for (const BatchItem& item : updates) {
+            LogSgConfigDetails(item.first);
+        }
+    }
+    
+    if (!phaseSgs.empty()) {
+        post([this, phaseSgs]() {
+            for (const auto& sg : phaseSgs) {
+                m_phasePlanner.addSg(sg.first, sg.second);
+            }
+        });
+        m_statusBoard.publish(statusList, std::vector<T_AI_ECMP_POOL_ENTRY>());
+    }
+    return dwRet;
+}
+
+void CAISlbManagerSingleton::removeSgBatch(const std::vector<const T_AI_ECMP_SG_CFG*>& configs,
+                                           T_AI_ECMP_SG_BATCH_RESULT& result) {
+    // 与单个删除相同：先从索引摘除，再释放实例，最后回收槽
+    std::vector<T_AI_ECMP_POOL_ENTRY> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const T_AI_ECMP_SG_CFG* pSgCfg : configs) {
+            T_AI_ECMP_INSTANCE_HANDLE handle;
+            if (m_instances.detach(pSgCfg->dwSgId, handle)) {
+                removed.push_back({pSgCfg->dwSgId, handle});
+            }
+        }
+    }
+    if (removed.empty()) {
+        return;
+    }
+    
+    for (const T_AI_ECMP_POOL_ENTRY& entry : removed) {
+        m_instances.release(entry.handle);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const T_AI_ECMP_POOL_ENTRY& entry : removed) {
+            m_instances.recycle(entry.handle);
+        }
+    }
+    
+    post([this, removed]() {
+        for (const T_AI_ECMP_POOL_ENTRY& entry : removed) {
+            m_phasePlanner.removeSg(entry.dwSgId);
+            m_scheduler.removeSg(entry.dwSgId);
+        }
+    });
+    m_statusBoard.publish(std::vector<T_AI_ECMP_STATUS_UPDATE>(), removed);
+    result.dwRemoved = static_cast<WORD32>(removed.size());
+}
+
+void CAISlbManagerSingleton::buildInstances(const std::vector<BatchItem>& creates) {
+    size_t workerNum = std::min(BATCH_BUILD_MAX_WORKERS, creates.size() / BATCH_BUILD_MIN_PER_WORKER);
+    const unsigned int hwThreads = std::thread::hardware_concurrency();
+    if (hwThreads > 0) {
+        workerNum = std::min<size_t>(workerNum, hwThreads);
+    }
+    workerNum = std::max<size_t>(workerNum, 1);
+    
+    // 按连续区间分给各工作线程，相邻的槽在同一线程构造
+    const size_t rangeSize = (creates.size() + workerNum - 1) / workerNum;
+    auto buildRange = [this, &creates, rangeSize](size_t worker) {
+        const size_t begin = worker * rangeSize;
+        const size_t end = std::min(creates.size(), begin + rangeSize);
+        for (size_t i = begin; i < end; ++i) {
+            m_instances.construct(creates[i].second, *creates[i].first);
+        }
+    };
+    
+    // 第一个区间在当前线程构造，其余各占一个工作线程
+    std::vector<std::thread> workers;
+    workers.reserve(workerNum - 1);
+    for (size_t worker = 1; worker < workerNum; ++worker) {
+        workers.emplace_back(buildRange, worker);
+    }
+    buildRange(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+WORD32 CAISlbManagerSingleton::runOptimizationCycle(T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg) {
     XOS_SysLog(LOG_EMERGENCY, "[ECMP] =====开始优化周期=====\n");
-    WORD32 dwResult = AI_SUCCESS;
+    
+    // 与定时器节拍互斥，等待进行中的节拍完成
+    std::lock_guard<std::mutex> cycleLock(m_cycleMutex);
+    drainMailbox();
 
     // 获取所有实例
     WORD32 dwInstanceCount = getInstanceCount();
@@ -64,64 +419,328 @@ WORD32 CAISlbManagerSingleton::runOptimizationCycle(T_AI_ECMP_COUNTER_STATS_MSG
         return AI_ECMP_ERR_NO_INSTANCE;
     }
     
-    // 遍历所有实例
-    for (auto& instanceEntry : m_instances) {
-        WORD32 dwSgId = instanceEntry.first;
-        auto& pInstance = instanceEntry.second;
+    WORD32 dwResult = processInstances(ecmpMsg, nullptr);
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] =====优化周期结束，结果: 0x%x=====\n", dwResult);
+    return dwResult;
+}
+
+WORD32 CAISlbManagerSingleton::handleCounterMessage(const T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg) {
+    // 只保存最新计数，由定时器节拍按相位分批处理
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counterMsg = ecmpMsg;
+    m_bCounterReady = true;
+    return AI_SUCCESS;
+}
+
+WORD32 CAISlbManagerSingleton::runTick() {
+    // 诊断命令持有周期锁时跳过本节拍，优化路径不等待诊断
+    std::unique_lock<std::mutex> cycleLock(m_cycleMutex, std::try_to_lock);
+    if (!cycleLock.owns_lock()) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] 周期锁被占用，跳过本节拍\n");
+        return AI_SUCCESS;
+    }
+    drainMailbox();
+    
+    // 复制最新计数，处理期间计数器回调可以继续写入
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_bCounterReady || m_instances.empty()) {
+            return AI_SUCCESS;
+        }
+        m_cycleCounterMsg = m_counterMsg;
+    }
+    
+    auto startTime = std::chrono::steady_clock::now();
+    WORD32 dwPhase = m_phasePlanner.nextPhase();
+    const std::vector<WORD32>& phaseSgs = m_phasePlanner.getPhaseSgs(dwPhase);
+    
+    WORD32 dwResult = AI_SUCCESS;
+    if (!phaseSgs.empty()) {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] =====节拍 %llu：处理相位 %u/%u，实例数量: %zu=====\n", 
+                      m_phasePlanner.getTickCount(), dwPhase, m_phasePlanner.getPhaseNum(), phaseSgs.size());
+        dwResult = processInstances(m_cycleCounterMsg, &phaseSgs);
+    }
+    
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    m_phasePlanner.recordTick(dwPhase, static_cast<WORD64>(elapsed.count()));
+    return dwResult;
+}
 
+WORD32 CAISlbManagerSingleton::processInstances(T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg, const std::vector<WORD32>* pSgIds) {
+    WORD32 dwResult = AI_SUCCESS;
+    
+    // 在结构锁内取得本周期要处理的实例槽，之后逐个实例加锁处理
+    m_cycleEntries.clear();
+    m_cycleStatus.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (pSgIds) {
+            T_AI_ECMP_INSTANCE_HANDLE handle;
+            for (WORD32 dwSgId : *pSgIds) {
+                if (m_instances.find(dwSgId, handle)) {
+                    m_cycleEntries.push_back({dwSgId, handle});
+                }
+            }
+        } else {
+            const std::vector<T_AI_ECMP_POOL_ENTRY>& entries = m_instances.getEntries();
+            m_cycleEntries.assign(entries.begin(), entries.end());
+        }
+    }
+    // 按SG ID排序，供调度阶段按SG ID查找句柄
+    std::sort(m_cycleEntries.begin(), m_cycleEntries.end(),
+              [](const T_AI_ECMP_POOL_ENTRY& a, const T_AI_ECMP_POOL_ENTRY& b) { return a.dwSgId < b.dwSgId; });
+    auto bySgId = [](const T_AI_ECMP_POOL_ENTRY& entry, WORD32 dwSgId) { return entry.dwSgId < dwSgId; };
+    
+    // 先更新计数器（保持历史连续），同时刷新调度优先级
+    auto refreshInstance = [this, &ecmpMsg, &dwResult](WORD32 dwSgId, EcmpInstance* pInstance) {
         // 更新计数器
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] 更新实例 %u 的计数器\n", dwSgId);
         if (!pInstance->updateCounters(ecmpMsg)) {
             XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 计数器更新失败\n", dwSgId);
             dwResult = AI_ECMP_ERR_COUNTER_READ;
-            continue;
+            return;
         }
         XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 计数器更新成功\n", dwSgId);
+        // 等待修改确认的SG本周期不会优化，不占用调度预算（超时待重发时按必须执行处理）
+        m_scheduler.updateBenefit(dwSgId, pInstance->isAwaitingAck() ? 0.0 : pInstance->getExcessLoad(),
+                                  pInstance->hasUrgentUpdate());
+    };
+    for (const T_AI_ECMP_POOL_ENTRY& poolEntry : m_cycleEntries) {
+        InstanceRef pInstance = m_instances.acquire(poolEntry.handle);
+        if (pInstance) {
+            refreshInstance(poolEntry.dwSgId, pInstance.get());
+        }
+    }
+    
+    // 再按期望收益从高到低在CPU预算内执行优化，预算不足的实例推迟到后续周期
+    const size_t entryNum = m_scheduler.beginCycle();
+    for (size_t i = 0; i < entryNum; ++i) {
+        const T_AI_ECMP_SCHED_ENTRY& entry = m_scheduler.getEntry(i);
+        WORD32 dwSgId = entry.dwSgId;
+        auto it = std::lower_bound(m_cycleEntries.begin(), m_cycleEntries.end(), dwSgId, bySgId);
+        if (it == m_cycleEntries.end() || it->dwSgId != dwSgId || !m_scheduler.admit(i)) {
+            continue;
+        }
         
-        // 执行优化
-        XOS_SysLog(LOG_EMERGENCY, "[ECMP] 开始执行实例 %u 的优化\n", dwSgId);
-        if (pInstance->runOptimization()) {
-            T_AI_ECMP_NHOP_MODIFY nhopModifyData = {0};
-            T_AI_ECMP_STATUS status = pInstance->getStatus();
-            
-            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 优化完成，状态: %d\n", dwSgId, status);
-            
-            // 根据状态执行不同操作
-            if (status == AI_ECMP_EXPAND) {
-                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 需要扩容操作\n", dwSgId);
-                if (pInstance->getExpandedNextHops(nhopModifyData)) {
-                    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 扩容配置生成成功，逻辑成员数: %u\n", 
-                                 dwSgId, nhopModifyData.dwItemNum);
-                    // 调用统一的下一跳修改接口
-                    aiEcmpSendNhopModify(nhopModifyData);
-                    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 扩容操作下发完成\n", dwSgId);
-                } else {
-                    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 扩容配置生成失败\n", dwSgId);
-                    dwResult = AI_ECMP_ERR_EXPAND_FAILED;
-                }
-            } else if (status == AI_ECMP_ADJUST) {
-                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 需要调整下一跳\n", dwSgId);
-                if (pInstance->getOptimizedNextHops(nhopModifyData)) {
-                    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 优化配置生成成功，项目数: %u\n", 
-                                 dwSgId, nhopModifyData.dwItemNum);
-                    // 调用统一的下一跳修改接口
-                    aiEcmpSendNhopModify(nhopModifyData);
-                    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 下一跳调整执行完成\n", dwSgId);
-                } else {
-                    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 优化配置生成失败\n", dwSgId);
-                    dwResult = AI_ECMP_ERR_ADJUST_FAILED;
-                }
+        auto startTime = std::chrono::steady_clock::now();
+        InstanceRef pInstance = m_instances.acquire(it->handle);
+        if (!pInstance) {
+            continue; // 本周期内已被删除
+        }
+        WORD32 dwInstanceResult = runInstanceOptimization(dwSgId, pInstance.get());
+        if (dwInstanceResult != AI_SUCCESS) {
+            dwResult = dwInstanceResult;
+        }
+        m_cycleStatus.emplace_back();
+        m_statusBoard.capture(*it, *pInstance.get(), m_cycleStatus.back());
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        m_scheduler.complete(i, static_cast<WORD64>(elapsed.count()));
+    }
+    m_scheduler.endCycle();
+    
+    // 本周期所有实例的下一跳修改合并为一条或少数几条消息下发
+    flushNhopModify();
+    
+    // 发布本周期执行过优化的实例状态（期间已删除的实例按句柄代数丢弃，不会重新加入）
+    m_statusBoard.publish(m_cycleStatus, std::vector<T_AI_ECMP_POOL_ENTRY>());
+    
+    const T_AI_ECMP_SCHED_STATS& schedStats = m_scheduler.getStats();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 周期调度 - 执行: %u, 推迟: %u（最长连续推迟 %u 周期）, 耗时: %llu us, 预算: %u us\n", 
+                  schedStats.dwScheduled, schedStats.dwDeferred, schedStats.dwMaxDeferredCycles,
+                  schedStats.qwSpentMicros, m_scheduler.getConfig().dwBudgetMicros);
+    return dwResult;
+}
+
+WORD32 CAISlbManagerSingleton::runInstanceOptimization(WORD32 dwSgId, EcmpInstance* pInstance) {
+    T_AI_ECMP_NHOP_MODIFY nhopModifyData = {};
+    
+    // 待确认的修改超时：全量重发，或回滚后全量下发回滚的成员表，本周期不再优化
+    const T_AI_ECMP_INFLIGHT_ACTION inflightAction = pInstance->pollInflight(nhopModifyData);
+    if (inflightAction == AI_ECMP_INFLIGHT_RETRY || inflightAction == AI_ECMP_INFLIGHT_ROLLBACK) {
+        submitNhopModify(nhopModifyData, nullptr);
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 待确认修改已加入批量下发%s\n", dwSgId,
+                      inflightAction == AI_ECMP_INFLIGHT_RETRY ? "重发" : "（回滚）");
+        return AI_SUCCESS;
+    }
+    
+    // 执行优化
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 开始执行实例 %u 的优化\n", dwSgId);
+    if (pInstance->runOptimization()) {
+        T_AI_ECMP_STATUS status = pInstance->getStatus();
+        
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 优化完成，状态: %d\n", dwSgId, status);
+        
+        // 根据状态执行不同操作
+        if (status == AI_ECMP_EXPAND) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 需要扩容操作\n", dwSgId);
+            if (pInstance->getExpandedNextHops(nhopModifyData)) {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 扩容配置生成成功，逻辑成员数: %u\n", 
+                             dwSgId, nhopModifyData.dwItemNum);
+                // 加入本周期的批量下发，周期结束时统一下发
+                submitNhopModify(nhopModifyData, nullptr);
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 扩容配置已加入批量下发\n", dwSgId);
+            } else {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 扩容配置生成失败\n", dwSgId);
+                return AI_ECMP_ERR_EXPAND_FAILED;
             }
+        } else if (status == AI_ECMP_SHRINK) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 需要缩容操作\n", dwSgId);
+            if (pInstance->getCompactedNextHops(nhopModifyData)) {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 缩容配置生成成功，逻辑成员数: %u\n", 
+                             dwSgId, nhopModifyData.dwItemNum);
+                // 加入本周期的批量下发，周期结束时统一下发
+                submitNhopModify(nhopModifyData, nullptr);
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 缩容配置已加入批量下发\n", dwSgId);
+            } else {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 缩容配置生成失败\n", dwSgId);
+                return AI_ECMP_ERR_SHRINK_FAILED;
+            }
+        } else if (status == AI_ECMP_ADJUST) {
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 需要调整下一跳\n", dwSgId);
+            T_AI_ECMP_NHOP_DELTA nhopDelta = {};
+            if (pInstance->getOptimizedNextHops(nhopModifyData, &nhopDelta)) {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 优化配置生成成功，项目数: %u\n", 
+                             dwSgId, nhopModifyData.dwItemNum);
+                // 加入本周期的批量下发，周期结束时统一下发（少量表项变化时按增量下发）
+                submitNhopModify(nhopModifyData, &nhopDelta);
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 下一跳调整已加入批量下发\n", dwSgId);
+            } else {
+                XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 优化配置生成失败\n", dwSgId);
+                return AI_ECMP_ERR_ADJUST_FAILED;
+            }
+        }
+    } else {
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 不需要优化或优化失败\n", dwSgId);
+    }
+    
+    return AI_SUCCESS;
+}
+
+WORD32 CAISlbManagerSingleton::setFtmCapability(WORD32 dwCapability) {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_dwFtmCapability = dwCapability;
+    
+    T_AI_ECMP_BATCH_CFG batchCfg = m_nhopBatcher.getConfig();
+    batchCfg.bBatch = (dwCapability & AI_ECMP_FTM_CAP_NHOP_BATCH) != 0;
+    batchCfg.bDelta = (dwCapability & AI_ECMP_FTM_CAP_NHOP_DELTA) != 0;
+    m_nhopBatcher.configure(batchCfg);
+    
+    const T_AI_ECMP_BATCH_CFG& effectiveCfg = m_nhopBatcher.getConfig();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] FTM能力: 0x%x，下一跳修改%s\n", dwCapability,
+                  !effectiveCfg.bBatch ? "逐个SG全量下发" :
+                  (effectiveCfg.bDelta ? "合并为批量消息，少量表项变化时按增量下发" : "合并为批量消息全量下发"));
+    return AI_SUCCESS;
+}
+
+void CAISlbManagerSingleton::post(std::function<void()> op) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mailbox.push_back(std::move(op));
+}
+
+void CAISlbManagerSingleton::drainMailbox() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mailbox.swap(m_cycleMailbox);
+    }
+    for (auto& op : m_cycleMailbox) {
+        op();
+    }
+    m_cycleMailbox.clear();
+}
+
+std::vector<T_AI_ECMP_POOL_ENTRY> CAISlbManagerSingleton::collectEntries() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_instances.getEntries();
+}
+
+void CAISlbManagerSingleton::submitNhopModify(const T_AI_ECMP_NHOP_MODIFY& nhopModify, const T_AI_ECMP_NHOP_DELTA* pDelta) {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_nhopBatcher.add(nhopModify, pDelta);
+}
+
+void CAISlbManagerSingleton::flushNhopModify() {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (m_nhopBatcher.empty()) {
+        return;
+    }
+    
+    WORD32 dwMessages = m_nhopBatcher.flush(aiEcmpSendNhopBatch, aiEcmpSendNhopModify);
+    const T_AI_ECMP_BATCH_STATS& batchStats = m_nhopBatcher.getStats();
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 下一跳修改批量下发 %u 条消息（累计: 提交 %llu, 合并 %llu, 记录 %llu, 消息 %llu）\n", 
+                  dwMessages, batchStats.qwSubmitted, batchStats.qwCoalesced, batchStats.qwRecords, batchStats.qwMessages);
+}
+
+WORD32 CAISlbManagerSingleton::handlePortDown(WORD32 dwPortId) {
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 端口 %u 故障，开始故障快速切换\n", dwPortId);
+    WORD32 dwResult = AI_SUCCESS;
+    WORD32 dwSwitched = 0;
+    
+    for (const T_AI_ECMP_POOL_ENTRY& poolEntry : collectEntries()) {
+        WORD32 dwSgId = poolEntry.dwSgId;
+        InstanceRef pInstance = m_instances.acquire(poolEntry.handle);
+        if (!pInstance || !pInstance->onPortDown(dwPortId)) {
+            continue;
+        }
+        
+        T_AI_ECMP_NHOP_MODIFY nhopModifyData = {};
+        T_AI_ECMP_NHOP_DELTA nhopDelta = {};
+        if (pInstance->getFailoverNextHops(nhopModifyData, &nhopDelta)) {
+            submitNhopModify(nhopModifyData, &nhopDelta);
+            dwSwitched++;
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 故障切换配置生成完成\n", dwSgId);
         } else {
-            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 不需要优化或优化失败\n", dwSgId);
+            XOS_SysLog(LOG_EMERGENCY, "[ECMP] 实例 %u 故障切换配置生成失败\n", dwSgId);
+            dwResult = AI_ECMP_ERR_ADJUST_FAILED;
         }
     }
     
-    XOS_SysLog(LOG_EMERGENCY, "[ECMP] =====优化周期结束，结果: 0x%x=====\n", dwResult);
+    // 受影响的所有实例合并下发，一次端口故障只产生一条或少数几条消息
+    flushNhopModify();
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 端口 %u 故障切换结束，下发 %u 个实例，结果: 0x%x\n", dwPortId, dwSwitched, dwResult);
     return dwResult;
 }
 
+WORD32 CAISlbManagerSingleton::startPortDrain(WORD32 dwPortId, DOUBLE stepShare, DOUBLE utilCap, bool bCapOverride) {
+    WORD32 dwStarted = 0;
+    for (const T_AI_ECMP_POOL_ENTRY& poolEntry : collectEntries()) {
+        InstanceRef pInstance = m_instances.acquire(poolEntry.handle);
+        if (pInstance && pInstance->startDrain(dwPortId, stepShare, utilCap, bCapOverride)) {
+            dwStarted++;
+        }
+    }
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 端口 %u 开始排空，涉及 %u 个实例%s\n", dwPortId, dwStarted,
+               bCapOverride ? "，停滞时允许超出利用率上限" : "");
+    if (dwStarted == 0) {
+        return AI_ECMP_ERR_NOT_FOUND;
+    }
+    return AI_SUCCESS;
+}
 
+WORD32 CAISlbManagerSingleton::stopPortDrain(WORD32 dwPortId) {
+    WORD32 dwStopped = 0;
+    for (const T_AI_ECMP_POOL_ENTRY& poolEntry : collectEntries()) {
+        InstanceRef pInstance = m_instances.acquire(poolEntry.handle);
+        if (!pInstance) {
+            continue;
+        }
+        const T_AI_ECMP_DRAIN_STATE& drain = pInstance->getDrainState();
+        if (drain.bActive && drain.dwPortId == dwPortId) {
+            pInstance->cancelDrain();
+            dwStopped++;
+        }
+    }
+    
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] 端口 %u 取消排空，涉及 %u 个实例\n", dwPortId, dwStopped);
+    if (dwStopped == 0) {
+        return AI_ECMP_ERR_NOT_FOUND;
+    }
+    return AI_SUCCESS;
+}
 
 /**
  * @brief 打印 T_AI_ECMP_SG_CFG 结构体的详细内容
@@ -170,32 +789,39 @@ void CAISlbManagerSingleton::LogSgConfigDetails(const T_AI_ECMP_SG_CFG* pSgCfg)
 
 
 WORD32 CAISlbManagerSingleton::getInstanceStatus(WORD32 dwSgId, void* pStatusInfo) {
-    auto it = m_instances.find(dwSgId);
-    if (it == m_instances.end()) {
+    T_AI_ECMP_INSTANCE_STATUS status;
+    if (!m_statusBoard.find(dwSgId, status)) {
         return AI_ECMP_ERR_NOT_FOUND;
     }
-    
-    // TODO: 实现状态信息填充逻辑
-    
+    if (pStatusInfo) {
+        *static_cast<T_AI_ECMP_INSTANCE_STATUS*>(pStatusInfo) = status;
+    }
     return AI_SUCCESS;
 }
 
 WORD32 CAISlbManagerSingleton::getInstanceCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return static_cast<WORD32>(m_instances.size());
 }
 
 // ===== 新增：实例访问方法实现 =====
-EcmpInstance* CAISlbManagerSingleton::getInstance(WORD32 dwSgId) {
-    auto it = m_instances.find(dwSgId);
-    if (it != m_instances.end()) {
-        return it->second.get();
+InstanceRef CAISlbManagerSingleton::getInstance(WORD32 dwSgId) {
+    T_AI_ECMP_INSTANCE_HANDLE handle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_instances.find(dwSgId, handle)) {
+            return InstanceRef();
+        }
     }
-    return nullptr;
+    return m_instances.acquire(handle);
 }
 
 void CAISlbManagerSingleton::forEachInstance(std::function<void(WORD32, EcmpInstance*)> func) {
-    for (auto& pair : m_instances) {
-        func(pair.first, pair.second.get());
+    for (const T_AI_ECMP_POOL_ENTRY& poolEntry : collectEntries()) {
+        InstanceRef pInstance = m_instances.acquire(poolEntry.handle);
+        if (pInstance) {
+            func(poolEntry.dwSgId, pInstance.get());
+        }
     }
 }
 
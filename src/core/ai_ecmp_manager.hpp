@@ -4,13 +4,48 @@
 #include <unordered_map>
 #include <memory>
 #include <functional> 
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <utility>
 #include "ai_ecmp_instance.hpp"
+#include "ai_ecmp_scheduler.hpp"
+#include "ai_ecmp_phase.hpp"
+#include "ai_ecmp_batch.hpp"
+#include "ai_ecmp_snapshot.hpp"
+#include "ai_ecmp_pool.hpp"
 
 
 namespace ai_ecmp {
 
+/**
+ * 加锁的对象引用：持有期间独占访问对象，析构时释放锁
+ */
+template <typename T>
+class LockedRef {
+public:
+    LockedRef(T& object, std::mutex& mutex) : m_pObject(&object), m_lock(mutex) {}
+
+    T& operator*() const { return *m_pObject; }
+    T* operator->() const { return m_pObject; }
+
+private:
+    T* m_pObject;
+    std::unique_lock<std::mutex> m_lock;
+};
+
 /**
  * ECMP管理器类，负责管理所有ECMP实例
+ *
+ * 并发模型（配置回调、计数器回调、定时器节拍和诊断命令可能运行在不同的上下文）：
+ * - 结构锁：保护实例池的索引、邮箱和最新计数消息，只做查找、插入、删除和复制，持有期间不获取其他锁
+ * - 实例锁：每个实例一把。优化路径逐个实例加锁处理，配置回调和诊断命令只锁涉及的实例，
+ *   配置变化在两个实例的处理之间生效，不会改动正在优化的实例
+ * - 周期锁：调度器和相位规划只由优化路径访问，配置回调对它们的修改投递到邮箱，由下个节拍开始时执行；
+ *   定时器节拍只尝试加锁，诊断命令持有周期锁时跳过本节拍而不等待
+ * - 下发锁：保护批量下发器，可在持有实例锁时获取
+ * - 状态发布板：状态查询和概览类诊断读取双缓冲的状态记录，不获取任何锁，不会阻塞优化路径
+ * 加锁顺序：周期锁 -> 实例锁 -> 下发锁
  */
 class CAISlbManagerSingleton {
 public:
@@ -28,17 +63,79 @@ public:
      */
     WORD32 handleSgConfigCtrl(WORD16 bSwitchFlag, T_AI_ECMP_SG_CFG* pSgCfg);
     
+    /**
+     * 批量处理SG配置（启动或换板后一次下发大量SG）
+     * 结构锁内一次完成所有查找和取槽，新实例在锁外并行构造，状态快照只发布一次，只打印一行汇总日志
+     * @param pSgCfgs SG配置数组
+     * @param dwSgNum SG配置数
+     * @param dwFlags 批量SG配置标志（AI_ECMP_SG_BATCH_*）
+     * @param pResult 处理结果输出指针，可为空
+     * @return 操作结果码（部分配置被拒绝时仍处理其余配置）
+     */
+    WORD32 handleSgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags,
+                               T_AI_ECMP_SG_BATCH_RESULT* pResult);
+    
+    /**
+     * 暂存批量SG配置消息（消息长度有限，一次同步分多条消息下发）
+     * 带AI_ECMP_SG_BATCH_MORE的消息只复制配置，收到不带该标志的消息后整批处理，
+     * 使并行构造和汇总日志作用于整次同步；删除与新增不合并，任何其他SG配置处理前先处理已暂存的配置
+     * @param pSgCfgs SG配置数组（处理后不再引用）
+     * @param dwSgNum SG配置数
+     * @param dwFlags 批量SG配置标志（AI_ECMP_SG_BATCH_*）
+     * @return 操作结果码（只暂存时返回成功）
+     */
+    WORD32 stageSgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags);
+    
     /**
      * 执行优化和调整过程
+     * 先更新所有实例的计数器，再由周期调度器按期望收益排序，在CPU预算内依次执行优化
      * @param ecmpMsg 计数器统计消息
      * @return 总的操作结果码
      */
     WORD32 runOptimizationCycle(T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg);
     
     /**
-     * 获取实例状态信息
+     * 保存最新的计数器统计消息，由定时器节拍按相位分批处理
+     * @param ecmpMsg 计数器统计消息
+     * @return 操作结果码
+     */
+    WORD32 handleCounterMessage(const T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg);
+    
+    /**
+     * 定时器节拍：只处理当前相位的实例（更新计数器并在CPU预算内执行优化）
+     * 每个实例每 相位数 个节拍处理一次，处理负荷均匀分散到各节拍
+     * @return 操作结果码
+     */
+    WORD32 runTick();
+    
+    /**
+     * 处理端口故障事件：所有包含该端口的实例立即重分配其上的桶并下发
+     * @param dwPortId 故障端口ID
+     * @return 操作结果码
+     */
+    WORD32 handlePortDown(WORD32 dwPortId);
+    
+    /**
+     * 开始排空端口：所有包含该端口的实例在后续优化周期中分步迁移其上的桶
+     * @param dwPortId 排空端口ID
+     * @param stepShare 每步迁移上限（开始时端口负载的比例）
+     * @param utilCap 存活端口利用率上限（相对排空后平均利用率的倍数）
+     * @param bCapOverride 是否允许停滞时超出利用率上限（操作员显式设置，默认不允许）
+     * @return 操作结果码
+     */
+    WORD32 startPortDrain(WORD32 dwPortId, DOUBLE stepShare, DOUBLE utilCap, bool bCapOverride = false);
+    
+    /**
+     * 取消端口排空（已迁移的桶保持不变）
+     * @param dwPortId 排空端口ID
+     * @return 操作结果码
+     */
+    WORD32 stopPortDrain(WORD32 dwPortId);
+    
+    /**
+     * 获取实例状态信息（读取状态发布板，不阻塞优化路径）
      * @param dwSgId SG ID
-     * @param pStatusInfo 状态信息输出指针
+     * @param pStatusInfo 状态信息输出指针（T_AI_ECMP_INSTANCE_STATUS），可为空
      * @return 操作结果码
      */
     WORD32 getInstanceStatus(WORD32 dwSgId, void* pStatusInfo);
@@ -51,25 +148,53 @@ public:
     
     // ===== 新增：实例访问方法 =====
     /**
-     * @brief 获取指定SG ID的实例指针
+     * @brief 获取指定SG ID的实例（持有返回值期间持有实例锁）
      * @param dwSgId SG ID
-     * @return 实例指针，如果不存在则返回nullptr
+     * @return 加锁的实例引用，如果不存在则为空
      */
-    EcmpInstance* getInstance(WORD32 dwSgId);
+    InstanceRef getInstance(WORD32 dwSgId);
     
     /**
-     * @brief 获取所有实例的引用（用于遍历）
-     * @return 实例映射表的引用
+     * @brief 对所有实例执行操作（逐个实例加锁后执行）
+     * @param func 要执行的函数
      */
-    const std::unordered_map<WORD32, std::unique_ptr<EcmpInstance>>& getAllInstances() const {
-        return m_instances;
-    }
+    void forEachInstance(std::function<void(WORD32, EcmpInstance*)> func);
     
     /**
-     * @brief 对所有实例执行操作
-     * @param func 要执行的函数
+     * @brief 获取实例状态发布板（读取无锁，不阻塞优化路径）
+     * @return 状态发布板常量引用
      */
-    void forEachInstance(std::function<void(WORD32, EcmpInstance*)> func);
+    const StatusBoard& getStatusBoard() const { return m_statusBoard; }
+    
+    /**
+     * @brief 获取优化周期调度器（持有返回值期间持有周期锁，定时器节拍将被跳过）
+     * @return 加锁的调度器引用
+     */
+    LockedRef<CycleScheduler> getScheduler() { return LockedRef<CycleScheduler>(m_scheduler, m_cycleMutex); }
+    
+    /**
+     * @brief 获取实例处理相位规划（持有返回值期间持有周期锁，定时器节拍将被跳过）
+     * @return 加锁的相位规划引用
+     */
+    LockedRef<PhasePlanner> getPhasePlanner() { return LockedRef<PhasePlanner>(m_phasePlanner, m_cycleMutex); }
+    
+    /**
+     * @brief 获取下一跳修改批量下发器（持有返回值期间持有下发锁）
+     * @return 加锁的批量下发器引用
+     */
+    LockedRef<NhopBatcher> getNhopBatcher() { return LockedRef<NhopBatcher>(m_nhopBatcher, m_sendMutex); }
+    
+    /**
+     * @brief 设置FTM声明的能力（AI_ECMP_FTM_CAP_*），支持批量消息时下一跳修改合并下发，同时支持增量时按增量下发
+     * @param dwCapability 能力位
+     * @return 操作结果码
+     */
+    WORD32 setFtmCapability(WORD32 dwCapability);
+    
+    /**
+     * @brief 获取FTM声明的能力
+     */
+    WORD32 getFtmCapability() const { return m_dwFtmCapability.load(); }
     
     /*
      * 记录SG配置详细信息
@@ -79,13 +204,98 @@ public:
     
 private:
     // 单例模式，禁止外部创建实例
-    CAISlbManagerSingleton() = default;
+    CAISlbManagerSingleton() : m_dwStagedFlags(0), m_dwStagedMsgNum(0), m_counterMsg(), m_bCounterReady(false),
+                               m_dwFtmCapability(0), m_cycleCounterMsg() {}
     ~CAISlbManagerSingleton() = default;
     CAISlbManagerSingleton(const CAISlbManagerSingleton&) = delete;
     CAISlbManagerSingleton& operator=(const CAISlbManagerSingleton&) = delete;
     
-    // ECMP实例映射表
-    std::unordered_map<WORD32, std::unique_ptr<EcmpInstance>> m_instances;
+    // 结构锁：保护实例池的索引、邮箱和最新计数消息
+    std::mutex m_mutex;
+    
+    // 周期锁：保护调度器和相位规划，由优化路径持有
+    std::mutex m_cycleMutex;
+    
+    // 下发锁：保护批量下发器
+    std::mutex m_sendMutex;
+    
+    // 暂存锁：保护分多条消息下发的批量配置，串行化SG配置处理，先于结构锁获取
+    std::mutex m_stageMutex;
+    std::vector<T_AI_ECMP_SG_CFG> m_stagedCfgs;
+    WORD32 m_dwStagedFlags;
+    WORD32 m_dwStagedMsgNum;
+    
+    // ECMP实例池：连续存放实例，以带代数的句柄访问
+    InstancePool m_instances;
+    
+    // 邮箱：配置回调对调度器和相位规划的修改，由优化路径在节拍开始时按投递顺序执行
+    std::vector<std::function<void()>> m_mailbox;
+    
+    // 实例状态发布板
+    StatusBoard m_statusBoard;
+    
+    // 优化周期调度器：按期望收益排序并限制每周期的优化耗时
+    CycleScheduler m_scheduler;
+    
+    // 实例处理相位规划：定时器节拍每次只处理一个相位的实例
+    PhasePlanner m_phasePlanner;
+    
+    // 下一跳修改批量下发：收集一个处理周期内的修改后合并下发
+    NhopBatcher m_nhopBatcher;
+    
+    // 最新的计数器统计消息
+    T_AI_ECMP_COUNTER_STATS_MSG m_counterMsg;
+    bool m_bCounterReady;
+    
+    // FTM声明的能力（AI_ECMP_FTM_CAP_*），未声明时只使用全量下发
+    std::atomic<WORD32> m_dwFtmCapability;
+    
+    // 优化路径的工作数据（持有周期锁时访问，跨周期复用）
+    T_AI_ECMP_COUNTER_STATS_MSG m_cycleCounterMsg;
+    std::vector<T_AI_ECMP_POOL_ENTRY> m_cycleEntries;
+    std::vector<T_AI_ECMP_STATUS_UPDATE> m_cycleStatus;
+    std::vector<std::function<void()>> m_cycleMailbox;
+    
+    // 更新实例计数器并按调度器顺序执行优化（pSgIds为空时处理所有实例，调用方须持有周期锁）
+    WORD32 processInstances(T_AI_ECMP_COUNTER_STATS_MSG& ecmpMsg, const std::vector<WORD32>* pSgIds);
+    
+    // 向邮箱投递对调度器或相位规划的修改
+    void post(std::function<void()> op);
+    
+    // 执行邮箱中的修改（调用方须持有周期锁）
+    void drainMailbox();
+    
+    // 批量配置中的一项：配置及其实例句柄
+    typedef std::pair<const T_AI_ECMP_SG_CFG*, T_AI_ECMP_INSTANCE_HANDLE> BatchItem;
+    
+    // 校验、去重后批量新增、更新或删除SG（调用方须持有暂存锁）
+    WORD32 processSgConfigBatch(const T_AI_ECMP_SG_CFG* pSgCfgs, WORD32 dwSgNum, WORD32 dwFlags,
+                                T_AI_ECMP_SG_BATCH_RESULT* pResult);
+    
+    // 处理已暂存的批量配置并释放暂存区（调用方须持有暂存锁）
+    WORD32 flushStagedSgConfigs();
+    
+    // 批量新增或更新SG（配置已校验并按SG ID去重）
+    WORD32 applySgConfigBatch(const std::vector<const T_AI_ECMP_SG_CFG*>& configs, WORD32 dwFlags,
+                              T_AI_ECMP_SG_BATCH_RESULT& result);
+    
+    // 批量删除SG
+    void removeSgBatch(const std::vector<const T_AI_ECMP_SG_CFG*>& configs, T_AI_ECMP_SG_BATCH_RESULT& result);
+    
+    // 在已取得的槽中并行构造实例（不持有结构锁）
+    void buildInstances(const std::vector<BatchItem>& creates);
+    
+    // 在结构锁内复制所有实例的句柄
+    std::vector<T_AI_ECMP_POOL_ENTRY> collectEntries();
+    
+    // 加入一个下一跳修改
+    void submitNhopModify(const T_AI_ECMP_NHOP_MODIFY& nhopModify, const T_AI_ECMP_NHOP_DELTA* pDelta);
+    
+    // 下发已收集的下一跳修改
+    void flushNhopModify();
+    
+    // 执行单个实例的优化并加入批量下发
+    WORD32 runInstanceOptimization(WORD32 dwSgId, EcmpInstance* pInstance);
     
     // 调用SG权重修改接口
     WORD32 callSgWeightModifyCtrl(T_AI_ECMP_WEIGHT_MODIFY* pOpParam, T_AI_ECMP_SG_CFG* pSgCfg);
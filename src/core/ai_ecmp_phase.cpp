@@ -0,0 +1,159 @@
+#include "ai_ecmp_phase.hpp"
+#include <algorithm>
+
+namespace ai_ecmp {
+
+constexpr WORD32 PhasePlanner::DEFAULT_PHASE_NUM;
+constexpr WORD32 PhasePlanner::MAX_PHASE_NUM;
+
+PhasePlanner::PhasePlanner()
+    : m_qwTicks(0) {
+    clearTickLatency();
+    configure(DEFAULT_PHASE_NUM);
+}
+
+void PhasePlanner::configure(WORD32 dwPhaseNum) {
+    dwPhaseNum = std::min(std::max(dwPhaseNum, static_cast<WORD32>(1)), MAX_PHASE_NUM);
+
+    // 保留已有SG，按新相位数从头分配（按SG ID顺序，保证结果与加入顺序无关）
+    std::vector<std::pair<WORD32, WORD32>> sgs;
+    sgs.reserve(m_slots.size());
+    for (const auto& entry : m_slots) {
+        sgs.emplace_back(entry.first, entry.second.dwWeight);
+    }
+    std::sort(sgs.begin(), sgs.end());
+
+    m_phaseSgs.assign(dwPhaseNum, std::vector<WORD32>());
+    m_phaseWeights.assign(dwPhaseNum, 0);
+    m_phaseLastMicros.assign(dwPhaseNum, 0);
+    m_slots.clear();
+    for (const auto& sg : sgs) {
+        place(sg.first, sg.second);
+    }
+    rebalance();
+}
+
+WORD32 PhasePlanner::hashPhase(WORD32 dwSgId, WORD32 dwPhaseNum) {
+    // 乘法散列打散连续分配的SG ID
+    return static_cast<WORD32>((static_cast<WORD64>(dwSgId) * 2654435761ULL >> 16) % dwPhaseNum);
+}
+
+void PhasePlanner::place(WORD32 dwSgId, WORD32 dwWeight) {
+    const WORD32 dwPhaseNum = getPhaseNum();
+    WORD32 dwPhase = hashPhase(dwSgId, dwPhaseNum);
+    WORD32 dwLightest = static_cast<WORD32>(
+        std::min_element(m_phaseWeights.begin(), m_phaseWeights.end()) - m_phaseWeights.begin());
+
+    // 散列相位比最轻相位重出一个SG以上时改放到最轻相位
+    if (m_phaseWeights[dwPhase] > m_phaseWeights[dwLightest] + dwWeight) {
+        dwPhase = dwLightest;
+    }
+
+    m_phaseSgs[dwPhase].push_back(dwSgId);
+    m_phaseWeights[dwPhase] += dwWeight;
+    m_slots[dwSgId] = {dwPhase, dwWeight};
+}
+
+void PhasePlanner::detach(WORD32 dwSgId, const T_PHASE_SLOT& slot) {
+    std::vector<WORD32>& phaseSgs = m_phaseSgs[slot.dwPhase];
+    phaseSgs.erase(std::remove(phaseSgs.begin(), phaseSgs.end(), dwSgId), phaseSgs.end());
+    m_phaseWeights[slot.dwPhase] -= slot.dwWeight;
+}
+
+void PhasePlanner::addSg(WORD32 dwSgId, WORD32 dwWeight) {
+    dwWeight = std::max(dwWeight, static_cast<WORD32>(1));
+
+    auto it = m_slots.find(dwSgId);
+    if (it != m_slots.end()) {
+        m_phaseWeights[it->second.dwPhase] += dwWeight;
+        m_phaseWeights[it->second.dwPhase] -= it->second.dwWeight;
+        it->second.dwWeight = dwWeight;
+        return;
+    }
+
+    place(dwSgId, dwWeight);
+    XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 分配到处理相位 %u/%u（相位权重: %llu）\n",
+                  dwSgId, m_slots[dwSgId].dwPhase, getPhaseNum(), m_phaseWeights[m_slots[dwSgId].dwPhase]);
+    rebalance();
+}
+
+void PhasePlanner::removeSg(WORD32 dwSgId) {
+    auto it = m_slots.find(dwSgId);
+    if (it == m_slots.end()) {
+        return;
+    }
+
+    detach(dwSgId, it->second);
+    m_slots.erase(it);
+    rebalance();
+}
+
+void PhasePlanner::rebalance() {
+    WORD32 dwMaxWeight = 0;
+    for (const auto& entry : m_slots) {
+        dwMaxWeight = std::max(dwMaxWeight, entry.second.dwWeight);
+    }
+
+    // 每次只移动一个SG，最多移动相位数次，避免大范围改变各SG的处理时刻
+    for (WORD32 n = 0; n < getPhaseNum(); ++n) {
+        WORD32 dwHeaviest = static_cast<WORD32>(
+            std::max_element(m_phaseWeights.begin(), m_phaseWeights.end()) - m_phaseWeights.begin());
+        WORD32 dwLightest = static_cast<WORD32>(
+            std::min_element(m_phaseWeights.begin(), m_phaseWeights.end()) - m_phaseWeights.begin());
+        WORD64 qwSpread = m_phaseWeights[dwHeaviest] - m_phaseWeights[dwLightest];
+        if (qwSpread <= dwMaxWeight) {
+            break;
+        }
+
+        // 选权重最接近差距一半的SG，移动后两个相位最接近
+        WORD32 dwMoveSg = 0;
+        WORD64 qwBestDistance = qwSpread;
+        bool bFound = false;
+        for (WORD32 dwSgId : m_phaseSgs[dwHeaviest]) {
+            WORD64 qwDoubled = static_cast<WORD64>(m_slots[dwSgId].dwWeight) * 2;
+            WORD64 qwDistance = qwDoubled > qwSpread ? qwDoubled - qwSpread : qwSpread - qwDoubled;
+            if (qwDistance < qwBestDistance) {
+                qwBestDistance = qwDistance;
+                dwMoveSg = dwSgId;
+                bFound = true;
+            }
+        }
+        if (!bFound) {
+            break;
+        }
+
+        T_PHASE_SLOT& slot = m_slots[dwMoveSg];
+        detach(dwMoveSg, slot);
+        slot.dwPhase = dwLightest;
+        m_phaseSgs[dwLightest].push_back(dwMoveSg);
+        m_phaseWeights[dwLightest] += slot.dwWeight;
+        XOS_SysLog(LOG_EMERGENCY, "[ECMP] SG %u: 处理相位重新均衡 %u -> %u\n", dwMoveSg, dwHeaviest, dwLightest);
+    }
+}
+
+WORD32 PhasePlanner::nextPhase() {
+    WORD32 dwPhase = static_cast<WORD32>(m_qwTicks % getPhaseNum());
+    m_qwTicks++;
+    return dwPhase;
+}
+
+void PhasePlanner::recordTick(WORD32 dwPhase, WORD64 qwMicros) {
+    if (dwPhase < m_phaseLastMicros.size()) {
+        m_phaseLastMicros[dwPhase] = qwMicros;
+    }
+
+    WORD32 dwBucket = 0;
+    while (dwBucket + 1 < AI_ECMP_LATENCY_BUCKET_NUM && (qwMicros >> dwBucket) > 0) {
+        dwBucket++;
+    }
+    m_tickLatency.adwBuckets[dwBucket]++;
+    m_tickLatency.qwSamples++;
+    m_tickLatency.qwTotalMicros += qwMicros;
+    m_tickLatency.qwMaxMicros = std::max(m_tickLatency.qwMaxMicros, qwMicros);
+}
+
+void PhasePlanner::clearTickLatency() {
+    m_tickLatency = {};
+}
+
+} // namespace ai_ecmp
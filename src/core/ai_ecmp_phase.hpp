@@ -0,0 +1,135 @@
+#ifndef AI_ECMP_PHASE_HPP
+#define AI_ECMP_PHASE_HPP
+
+#include <vector>
+#include <unordered_map>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/** 延迟直方图桶数：第0桶 <1us，第k桶 [2^(k-1), 2^k) us，最后一桶收纳更大的值 */
+const WORD32 AI_ECMP_LATENCY_BUCKET_NUM = 20;
+
+/**
+ * 延迟直方图（按2的幂分桶，单位微秒）
+ */
+typedef struct {
+    WORD32 adwBuckets[AI_ECMP_LATENCY_BUCKET_NUM];  /* 各桶样本数 */
+    WORD64 qwSamples;                               /* 样本总数 */
+    WORD64 qwTotalMicros;                           /* 累计耗时 */
+    WORD64 qwMaxMicros;                             /* 最大耗时 */
+} T_AI_ECMP_LATENCY_HIST;
+
+/**
+ * SG相位规划
+ * 把优化周期划分为N个定时器节拍（相位），每个SG按ID散列到其中一个相位，每个节拍只处理该相位的SG，
+ * 各SG仍然每N个节拍处理一次，但处理负荷分散到各节拍上而不是在同一时刻集中爆发。
+ * 各相位按SG的逻辑成员数（处理耗时的近似）计权：散列相位明显偏重时改放到最轻的相位，
+ * SG加入或删除后相位之间的差距超过单个SG的最大权重时，从最重的相位移动少量SG到最轻的相位
+ */
+class PhasePlanner {
+public:
+    /** 默认相位数：100ms节拍下每个SG每秒处理一次 */
+    static constexpr WORD32 DEFAULT_PHASE_NUM = 10;
+    static constexpr WORD32 MAX_PHASE_NUM = 64;
+
+    PhasePlanner();
+
+    /**
+     * @brief 设置相位数（越界时收敛到 [1, MAX_PHASE_NUM]），按新相位数重新分配所有SG
+     * @param dwPhaseNum 相位数
+     */
+    void configure(WORD32 dwPhaseNum);
+
+    /**
+     * @brief 获取相位数
+     */
+    WORD32 getPhaseNum() const { return static_cast<WORD32>(m_phaseSgs.size()); }
+
+    /**
+     * @brief 加入SG，并在相位间差距过大时重新均衡（已存在时只更新权重并保持原相位）
+     * @param dwSgId SG ID
+     * @param dwWeight 权重（逻辑成员数），0按1计
+     */
+    void addSg(WORD32 dwSgId, WORD32 dwWeight);
+
+    /**
+     * @brief 移除SG，并在相位间差距过大时重新均衡
+     * @param dwSgId SG ID
+     */
+    void removeSg(WORD32 dwSgId);
+
+    /**
+     * @brief 推进一个节拍，返回本节拍要处理的相位
+     */
+    WORD32 nextPhase();
+
+    /**
+     * @brief 获取相位内的SG列表
+     */
+    const std::vector<WORD32>& getPhaseSgs(WORD32 dwPhase) const { return m_phaseSgs[dwPhase]; }
+
+    /**
+     * @brief 获取相位的总权重
+     */
+    WORD64 getPhaseWeight(WORD32 dwPhase) const { return m_phaseWeights[dwPhase]; }
+
+    /**
+     * @brief 获取相位最近一个节拍的处理耗时（微秒）
+     */
+    WORD64 getPhaseLastMicros(WORD32 dwPhase) const { return m_phaseLastMicros[dwPhase]; }
+
+    /**
+     * @brief 获取已推进的节拍数
+     */
+    WORD64 getTickCount() const { return m_qwTicks; }
+
+    /**
+     * @brief 记录一个节拍的处理耗时
+     * @param dwPhase 节拍处理的相位
+     * @param qwMicros 耗时（微秒）
+     */
+    void recordTick(WORD32 dwPhase, WORD64 qwMicros);
+
+    /**
+     * @brief 获取节拍耗时直方图
+     */
+    const T_AI_ECMP_LATENCY_HIST& getTickLatency() const { return m_tickLatency; }
+
+    /**
+     * @brief 清空节拍耗时统计
+     */
+    void clearTickLatency();
+
+    /**
+     * @brief 由SG ID散列得到的首选相位
+     */
+    static WORD32 hashPhase(WORD32 dwSgId, WORD32 dwPhaseNum);
+
+private:
+    typedef struct {
+        WORD32 dwPhase;                 /* 所在相位 */
+        WORD32 dwWeight;                /* 权重 */
+    } T_PHASE_SLOT;
+
+    // 把SG放入相位
+    void place(WORD32 dwSgId, WORD32 dwWeight);
+
+    // 从相位列表中摘除SG
+    void detach(WORD32 dwSgId, const T_PHASE_SLOT& slot);
+
+    // 最重相位与最轻相位的差距超过单个SG的最大权重时移动SG
+    void rebalance();
+
+    std::vector<std::vector<WORD32>> m_phaseSgs;        /* 各相位的SG列表 */
+    std::vector<WORD64> m_phaseWeights;                 /* 各相位的总权重 */
+    std::vector<WORD64> m_phaseLastMicros;              /* 各相位最近一个节拍的耗时 */
+    std::unordered_map<WORD32, T_PHASE_SLOT> m_slots;   /* SG ID -> 相位及权重 */
+
+    WORD64 m_qwTicks;                                   /* 已推进的节拍数 */
+    T_AI_ECMP_LATENCY_HIST m_tickLatency;               /* 节拍耗时直方图 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_PHASE_HPP */
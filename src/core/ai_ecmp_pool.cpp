@@ -0,0 +1,180 @@
+#include "ai_ecmp_pool.hpp"
+#include <new>
+
+namespace ai_ecmp {
+
+constexpr WORD32 InstancePool::CHUNK_SLOT_NUM;
+constexpr WORD32 InstancePool::MAX_CHUNK_NUM;
+constexpr WORD32 InstancePool::INVALID_INDEX;
+
+// 索引初始桶数（2的幂）
+static const WORD32 INITIAL_INDEX_CAPACITY = 64;
+
+// SG ID的首选桶（乘法散列打散连续分配的SG ID）
+static WORD32 indexHome(WORD32 dwSgId, WORD32 dwMask) {
+    return static_cast<WORD32>(static_cast<WORD64>(dwSgId) * 2654435761ULL >> 16) & dwMask;
+}
+
+InstancePool::InstancePool()
+    : m_dwChunkNum(0)
+    , m_index(INITIAL_INDEX_CAPACITY, T_INDEX_CELL{0, INVALID_INDEX}) {
+}
+
+InstancePool::~InstancePool() {
+    for (const T_AI_ECMP_POOL_ENTRY& entry : m_entries) {
+        destroy(slotAt(entry.handle.dwIndex));
+    }
+}
+
+bool InstancePool::find(WORD32 dwSgId, T_AI_ECMP_INSTANCE_HANDLE& handle) const {
+    const T_INDEX_CELL& cell = m_index[probe(dwSgId)];
+    if (cell.dwIndex == INVALID_INDEX) {
+        return false;
+    }
+    handle = m_entries[slotAt(cell.dwIndex).dwEntryPos].handle;
+    return true;
+}
+
+bool InstancePool::allocSlot(WORD32& dwIndex) {
+    if (m_freeSlots.empty()) {
+        if (m_dwChunkNum == MAX_CHUNK_NUM) {
+            return false;
+        }
+        // 值初始化：代数从0开始，槽均为空
+        m_chunks[m_dwChunkNum].reset(new T_AI_ECMP_INSTANCE_SLOT[CHUNK_SLOT_NUM]());
+        // 逆序压入，先使用块内靠前的槽，使实例在内存中按创建顺序排列
+        for (WORD32 i = CHUNK_SLOT_NUM; i > 0; --i) {
+            m_freeSlots.push_back(m_dwChunkNum * CHUNK_SLOT_NUM + i - 1);
+        }
+        m_dwChunkNum++;
+    }
+    dwIndex = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return true;
+}
+
+bool InstancePool::create(const T_AI_ECMP_SG_CFG& sgCfg, T_AI_ECMP_INSTANCE_HANDLE& handle) {
+    if (!allocate(handle)) {
+        return false;
+    }
+    construct(handle, sgCfg);
+    return insert(sgCfg.dwSgId, handle);
+}
+
+bool InstancePool::allocate(T_AI_ECMP_INSTANCE_HANDLE& handle) {
+    WORD32 dwIndex = INVALID_INDEX;
+    if (!allocSlot(dwIndex)) {
+        return false;
+    }
+    handle = {dwIndex, slotAt(dwIndex).dwGeneration};
+    return true;
+}
+
+void InstancePool::construct(const T_AI_ECMP_INSTANCE_HANDLE& handle, const T_AI_ECMP_SG_CFG& sgCfg) const {
+    // 持有旧句柄的一方可能正在检查该槽，构造在实例锁内进行
+    T_AI_ECMP_INSTANCE_SLOT& slot = slotAt(handle.dwIndex);
+    std::lock_guard<std::mutex> lock(slot.lock);
+    new (&slot.storage) EcmpInstance(sgCfg);
+    slot.bLive = true;
+}
+
+bool InstancePool::insert(WORD32 dwSgId, const T_AI_ECMP_INSTANCE_HANDLE& handle) {
+    if (m_index[probe(dwSgId)].dwIndex != INVALID_INDEX) {
+        return false;
+    }
+    slotAt(handle.dwIndex).dwEntryPos = static_cast<WORD32>(m_entries.size());
+    m_entries.push_back({dwSgId, handle});
+    indexInsert(dwSgId, handle.dwIndex);
+    return true;
+}
+
+void InstancePool::reserve(WORD32 dwCount) {
+    m_entries.reserve(dwCount);
+    while (static_cast<size_t>(dwCount) * 2 > m_index.size()) {
+        indexGrow();
+    }
+}
+
+bool InstancePool::detach(WORD32 dwSgId, T_AI_ECMP_INSTANCE_HANDLE& handle) {
+    WORD32 dwPos = probe(dwSgId);
+    if (m_index[dwPos].dwIndex == INVALID_INDEX) {
+        return false;
+    }
+
+    // 与末尾条目交换后删除，保持列表紧凑
+    WORD32 dwEntryPos = slotAt(m_index[dwPos].dwIndex).dwEntryPos;
+    handle = m_entries[dwEntryPos].handle;
+    if (dwEntryPos + 1 != m_entries.size()) {
+        m_entries[dwEntryPos] = m_entries.back();
+        slotAt(m_entries[dwEntryPos].handle.dwIndex).dwEntryPos = dwEntryPos;
+    }
+    m_entries.pop_back();
+    indexErase(dwPos);
+    return true;
+}
+
+void InstancePool::release(const T_AI_ECMP_INSTANCE_HANDLE& handle) const {
+    T_AI_ECMP_INSTANCE_SLOT& slot = slotAt(handle.dwIndex);
+    std::lock_guard<std::mutex> lock(slot.lock);
+    if (slot.dwGeneration == handle.dwGeneration) {
+        destroy(slot);
+    }
+}
+
+void InstancePool::destroy(T_AI_ECMP_INSTANCE_SLOT& slot) {
+    if (!slot.bLive) {
+        return;
+    }
+    instanceOf(slot)->~EcmpInstance();
+    slot.bLive = false;
+    slot.dwGeneration++;
+}
+
+void InstancePool::recycle(const T_AI_ECMP_INSTANCE_HANDLE& handle) {
+    m_freeSlots.push_back(handle.dwIndex);
+}
+
+WORD32 InstancePool::probe(WORD32 dwSgId) const {
+    const WORD32 dwMask = static_cast<WORD32>(m_index.size()) - 1;
+    WORD32 dwPos = indexHome(dwSgId, dwMask);
+    while (m_index[dwPos].dwIndex != INVALID_INDEX && m_index[dwPos].dwSgId != dwSgId) {
+        dwPos = (dwPos + 1) & dwMask;
+    }
+    return dwPos;
+}
+
+void InstancePool::indexInsert(WORD32 dwSgId, WORD32 dwIndex) {
+    if (m_entries.size() * 2 > m_index.size()) {
+        indexGrow();
+    }
+    m_index[probe(dwSgId)] = {dwSgId, dwIndex};
+}
+
+void InstancePool::indexErase(WORD32 dwPos) {
+    const WORD32 dwMask = static_cast<WORD32>(m_index.size()) - 1;
+    m_index[dwPos].dwIndex = INVALID_INDEX;
+
+    // 后移回填：后续条目的首选桶不在 (空桶, 当前桶] 循环区间内时，移到空桶
+    WORD32 dwNext = (dwPos + 1) & dwMask;
+    while (m_index[dwNext].dwIndex != INVALID_INDEX) {
+        WORD32 dwHome = indexHome(m_index[dwNext].dwSgId, dwMask);
+        if (((dwNext - dwHome) & dwMask) >= ((dwNext - dwPos) & dwMask)) {
+            m_index[dwPos] = m_index[dwNext];
+            m_index[dwNext].dwIndex = INVALID_INDEX;
+            dwPos = dwNext;
+        }
+        dwNext = (dwNext + 1) & dwMask;
+    }
+}
+
+void InstancePool::indexGrow() {
+    std::vector<T_INDEX_CELL> oldIndex(m_index.size() * 2, T_INDEX_CELL{0, INVALID_INDEX});
+    oldIndex.swap(m_index);
+    for (const T_INDEX_CELL& cell : oldIndex) {
+        if (cell.dwIndex != INVALID_INDEX) {
+            m_index[probe(cell.dwSgId)] = cell;
+        }
+    }
+}
+
+} // namespace ai_ecmp
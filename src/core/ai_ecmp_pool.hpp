@@ -0,0 +1,232 @@
+#ifndef AI_ECMP_POOL_HPP
+#define AI_ECMP_POOL_HPP
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include "ai_ecmp_instance.hpp"
+
+namespace ai_ecmp {
+
+/**
+ * 实例句柄：槽下标 + 代数
+ * 槽中的实例释放时代数加一，之后旧句柄的代数不再匹配，不会误用复用该槽的新实例
+ */
+typedef struct {
+    WORD32 dwIndex;                     /* 槽下标 */
+    WORD32 dwGeneration;                /* 取得句柄时槽的代数 */
+} T_AI_ECMP_INSTANCE_HANDLE;
+
+/**
+ * 实例池条目（紧凑列表中的一项）
+ */
+typedef struct {
+    WORD32 dwSgId;                      /* SG ID */
+    T_AI_ECMP_INSTANCE_HANDLE handle;   /* 实例句柄 */
+} T_AI_ECMP_POOL_ENTRY;
+
+/**
+ * 实例槽：实例就地构造在槽内，槽按块连续分配，块分配后地址不变直到实例池析构
+ * 实例锁保护实例本身以及bLive、dwGeneration的变化
+ */
+typedef struct {
+    std::mutex lock;                    /* 实例锁 */
+    WORD32 dwGeneration;                /* 代数，实例释放时加一 */
+    WORD32 dwEntryPos;                  /* 在紧凑列表中的下标 */
+    bool bLive;                         /* 是否构造了实例 */
+    std::aligned_storage<sizeof(EcmpInstance), alignof(EcmpInstance)>::type storage;   /* 实例存储 */
+} T_AI_ECMP_INSTANCE_SLOT;
+
+class InstanceRef;
+
+/**
+ * ECMP实例池
+ * 实例按块连续存放在槽中，空闲槽以空闲链表复用，SG频繁删除重建时不再逐个分配释放实例对象；
+ * SG ID到槽的索引为线性探测的开放寻址散列表（删除时后移回填，不留墓碑）；
+ * 存活实例另有一个紧凑列表，遍历时线性访问，删除时与末尾条目交换，创建和删除均为O(1)。
+ * 实例池本身不加锁，结构性修改（创建、摘除、回收）和查找由调用方在结构锁内进行；
+ * 取得句柄后访问实例只需实例锁
+ */
+class InstancePool {
+public:
+    /** 每块的槽数 */
+    static constexpr WORD32 CHUNK_SLOT_NUM = 64;
+    /** 最大块数（块目录定长，已分配块的地址在无锁读取时保持有效） */
+    static constexpr WORD32 MAX_CHUNK_NUM = 1024;
+    /** 无效槽下标 */
+    static constexpr WORD32 INVALID_INDEX = 0xFFFFFFFF;
+
+    InstancePool();
+    ~InstancePool();
+
+    InstancePool(const InstancePool&) = delete;
+    InstancePool& operator=(const InstancePool&) = delete;
+
+    /**
+     * @brief 按SG ID查找实例句柄
+     * @param dwSgId SG ID
+     * @param handle 输出参数，实例句柄
+     * @return 是否找到
+     */
+    bool find(WORD32 dwSgId, T_AI_ECMP_INSTANCE_HANDLE& handle) const;
+
+    /**
+     * @brief 在空闲槽中创建实例（调用方保证SG ID不存在）
+     * @param sgCfg SG配置
+     * @param handle 输出参数，新实例的句柄
+     * @return 是否成功（槽已用尽时失败）
+     */
+    bool create(const T_AI_ECMP_SG_CFG& sgCfg, T_AI_ECMP_INSTANCE_HANDLE& handle);
+
+    /**
+     * @brief 取得一个空闲槽，实例未构造、未加入索引（批量创建时先在结构锁内取槽，再在锁外构造）
+     * @param handle 输出参数，槽的句柄
+     * @return 是否成功（槽已用尽时失败）
+     */
+    bool allocate(T_AI_ECMP_INSTANCE_HANDLE& handle);
+
+    /**
+     * @brief 在实例锁内于已取得的槽中构造实例（不需要结构锁，不同槽可并行构造）
+     * @param handle allocate取得的句柄
+     * @param sgCfg SG配置
+     */
+    void construct(const T_AI_ECMP_INSTANCE_HANDLE& handle, const T_AI_ECMP_SG_CFG& sgCfg) const;
+
+    /**
+     * @brief 把已构造的实例加入索引和紧凑列表
+     * @param dwSgId SG ID
+     * @param handle 实例句柄
+     * @return 是否成功（SG ID已存在时失败，由调用方释放并回收该槽）
+     */
+    bool insert(WORD32 dwSgId, const T_AI_ECMP_INSTANCE_HANDLE& handle);
+
+    /**
+     * @brief 预留存活实例数，避免批量创建过程中多次扩容索引
+     * @param dwCount 预计的存活实例数
+     */
+    void reserve(WORD32 dwCount);
+
+    /**
+     * @brief 从索引和紧凑列表中摘除实例，实例本身保留在槽中，由调用方释放后回收槽
+     * @param dwSgId SG ID
+     * @param handle 输出参数，被摘除实例的句柄
+     * @return 是否找到
+     */
+    bool detach(WORD32 dwSgId, T_AI_ECMP_INSTANCE_HANDLE& handle);
+
+    /**
+     * @brief 在实例锁内释放句柄指向的实例并使旧句柄失效（不需要结构锁，正在访问该实例的一方访问完成后才释放）
+     * @param handle 被摘除实例的句柄
+     */
+    void release(const T_AI_ECMP_INSTANCE_HANDLE& handle) const;
+
+    /**
+     * @brief 把已释放实例的槽放回空闲链表
+     * @param handle 被摘除实例的句柄
+     */
+    void recycle(const T_AI_ECMP_INSTANCE_HANDLE& handle);
+
+    /**
+     * @brief 对句柄指向的实例加锁（不需要结构锁；实例已释放时返回空引用）
+     * @param handle 实例句柄
+     */
+    InstanceRef acquire(const T_AI_ECMP_INSTANCE_HANDLE& handle) const;
+
+    /**
+     * @brief 存活实例的紧凑列表
+     */
+    const std::vector<T_AI_ECMP_POOL_ENTRY>& getEntries() const { return m_entries; }
+
+    /**
+     * @brief 存活实例数
+     */
+    size_t size() const { return m_entries.size(); }
+
+    /**
+     * @brief 是否没有存活实例
+     */
+    bool empty() const { return m_entries.empty(); }
+
+    /**
+     * @brief 已分配的槽数
+     */
+    size_t getSlotCount() const { return static_cast<size_t>(m_dwChunkNum) * CHUNK_SLOT_NUM; }
+
+    /**
+     * @brief 索引散列表的桶数
+     */
+    size_t getIndexCapacity() const { return m_index.size(); }
+
+    /**
+     * @brief 槽中的实例
+     */
+    static EcmpInstance* instanceOf(T_AI_ECMP_INSTANCE_SLOT& slot) {
+        return reinterpret_cast<EcmpInstance*>(&slot.storage);
+    }
+
+private:
+    typedef struct {
+        WORD32 dwSgId;                  /* SG ID */
+        WORD32 dwIndex;                 /* 槽下标，INVALID_INDEX表示空桶 */
+    } T_INDEX_CELL;
+
+    T_AI_ECMP_INSTANCE_SLOT& slotAt(WORD32 dwIndex) const {
+        return m_chunks[dwIndex / CHUNK_SLOT_NUM][dwIndex % CHUNK_SLOT_NUM];
+    }
+
+    // 释放槽中的实例，代数加一
+    static void destroy(T_AI_ECMP_INSTANCE_SLOT& slot);
+
+    // 取得一个空闲槽，必要时分配新块
+    bool allocSlot(WORD32& dwIndex);
+
+    // 查找SG ID所在的桶，不存在时返回应插入的空桶
+    WORD32 probe(WORD32 dwSgId) const;
+
+    // 加入索引（装载率超过一半时扩容）
+    void indexInsert(WORD32 dwSgId, WORD32 dwIndex);
+
+    // 删除桶并把后续探测链上的条目后移回填
+    void indexErase(WORD32 dwPos);
+
+    // 扩容并重新散列
+    void indexGrow();
+
+    std::unique_ptr<T_AI_ECMP_INSTANCE_SLOT[]> m_chunks[MAX_CHUNK_NUM];    /* 块目录 */
+    WORD32 m_dwChunkNum;                                /* 已分配的块数 */
+    std::vector<WORD32> m_freeSlots;                    /* 空闲槽下标（后进先出，复用最近释放的槽） */
+    std::vector<T_AI_ECMP_POOL_ENTRY> m_entries;        /* 存活实例的紧凑列表 */
+    std::vector<T_INDEX_CELL> m_index;                  /* SG ID索引（桶数为2的幂） */
+};
+
+/**
+ * 加锁的实例引用：持有期间持有实例锁，独占访问实例，析构时释放
+ * 实例不存在、已释放或槽已被复用时为空
+ */
+class InstanceRef {
+public:
+    InstanceRef() : m_pSlot(nullptr), m_dwGeneration(0) {}
+    InstanceRef(T_AI_ECMP_INSTANCE_SLOT& slot, WORD32 dwGeneration)
+        : m_pSlot(&slot), m_dwGeneration(dwGeneration), m_lock(slot.lock) {}
+
+    EcmpInstance* get() const {
+        return m_pSlot && m_pSlot->bLive && m_pSlot->dwGeneration == m_dwGeneration
+            ? InstancePool::instanceOf(*m_pSlot) : nullptr;
+    }
+    EcmpInstance* operator->() const { return get(); }
+    explicit operator bool() const { return get() != nullptr; }
+
+private:
+    T_AI_ECMP_INSTANCE_SLOT* m_pSlot;
+    WORD32 m_dwGeneration;
+    std::unique_lock<std::mutex> m_lock;
+};
+
+inline InstanceRef InstancePool::acquire(const T_AI_ECMP_INSTANCE_HANDLE& handle) const {
+    return InstanceRef(slotAt(handle.dwIndex), handle.dwGeneration);
+}
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_POOL_HPP */
@@ -0,0 +1,129 @@
+#include "ai_ecmp_scheduler.hpp"
+#include <algorithm>
+
+namespace ai_ecmp {
+
+constexpr double CycleScheduler::COST_ALPHA;
+
+CycleScheduler::CycleScheduler()
+    : m_dwCycle(0)
+    , m_qwSpentMicros(0)
+    , m_dwAdmitted(0)
+    , m_avgCostMicros(0.0) {
+    m_stats = {0, 0, 0, 0, 0, 0};
+    // 默认：每周期优化耗时不超过50ms，每推迟一个周期优先级提高50%
+    T_AI_ECMP_SCHED_CFG cfg = {50000, 0.5};
+    configure(cfg);
+}
+
+void CycleScheduler::configure(const T_AI_ECMP_SCHED_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.agingFactor = std::max(m_cfg.agingFactor, 0.0);
+}
+
+void CycleScheduler::removeSg(WORD32 dwSgId) {
+    auto it = m_positions.find(dwSgId);
+    if (it == m_positions.end()) {
+        return;
+    }
+
+    // 与末尾条目交换后删除，只需更新被移动条目的下标
+    const size_t pos = it->second;
+    m_positions.erase(it);
+    if (pos + 1 != m_entries.size()) {
+        m_entries[pos] = m_entries.back();
+        m_positions[m_entries[pos].dwSgId] = pos;
+    }
+    m_entries.pop_back();
+    // 本周期的顺序引用了移动前的下标，作废后由下个周期重建
+    m_order.clear();
+}
+
+void CycleScheduler::updateBenefit(WORD32 dwSgId, double benefit, bool bUrgent) {
+    auto it = m_positions.find(dwSgId);
+    if (it == m_positions.end()) {
+        T_AI_ECMP_SCHED_ENTRY entry = {dwSgId, 0.0, 0.0, 0.0, 0, 0, false, false};
+        it = m_positions.emplace(dwSgId, m_entries.size()).first;
+        m_entries.push_back(entry);
+    }
+
+    T_AI_ECMP_SCHED_ENTRY& entry = m_entries[it->second];
+    entry.benefit = std::max(benefit, 0.0);
+    entry.priority = entry.benefit * (1.0 + m_cfg.agingFactor * entry.dwDeferredCycles);
+    entry.bUrgent = bUrgent;
+    entry.dwSeenCycle = m_dwCycle + 1;
+}
+
+bool CycleScheduler::isBefore(const T_AI_ECMP_SCHED_ENTRY& a, const T_AI_ECMP_SCHED_ENTRY& b) {
+    if (a.bUrgent != b.bUrgent) {
+        return a.bUrgent;
+    }
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.dwSgId < b.dwSgId;
+}
+
+size_t CycleScheduler::beginCycle() {
+    m_dwCycle++;
+    m_qwSpentMicros = 0;
+    m_dwAdmitted = 0;
+
+    // 只排序本周期更新过收益的条目，其余条目不移动，SG ID到下标的映射保持不变
+    m_order.clear();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        m_entries[i].bScheduled = false;
+        if (m_entries[i].dwSeenCycle == m_dwCycle) {
+            m_order.push_back(i);
+        }
+    }
+    std::sort(m_order.begin(), m_order.end(), [this](size_t a, size_t b) {
+        return isBefore(m_entries[a], m_entries[b]);
+    });
+    return m_order.size();
+}
+
+bool CycleScheduler::admit(size_t index) const {
+    const T_AI_ECMP_SCHED_ENTRY& entry = m_entries[m_order[index]];
+    if (entry.bUrgent || m_dwAdmitted == 0 || m_cfg.dwBudgetMicros == 0) {
+        return true;
+    }
+    // 尚未执行过的SG按所有SG的平均耗时估计
+    double costMicros = entry.costMicros > 0.0 ? entry.costMicros : m_avgCostMicros;
+    return static_cast<double>(m_qwSpentMicros) + costMicros <= m_cfg.dwBudgetMicros;
+}
+
+void CycleScheduler::complete(size_t index, WORD64 qwMicros) {
+    T_AI_ECMP_SCHED_ENTRY& entry = m_entries[m_order[index]];
+    const double micros = static_cast<double>(qwMicros);
+    entry.costMicros = entry.costMicros <= 0.0 ? micros : entry.costMicros + COST_ALPHA * (micros - entry.costMicros);
+    m_avgCostMicros = m_avgCostMicros <= 0.0 ? micros : m_avgCostMicros + COST_ALPHA * (micros - m_avgCostMicros);
+    entry.bScheduled = true;
+    entry.dwDeferredCycles = 0;
+
+    m_qwSpentMicros += qwMicros;
+    m_dwAdmitted++;
+}
+
+void CycleScheduler::endCycle() {
+    m_stats.dwCycles++;
+    m_stats.dwScheduled = m_dwAdmitted;
+    m_stats.dwDeferred = 0;
+    m_stats.qwSpentMicros = m_qwSpentMicros;
+    m_stats.dwMaxDeferredCycles = 0;
+
+    for (size_t index : m_order) {
+        T_AI_ECMP_SCHED_ENTRY& entry = m_entries[index];
+        if (!entry.bScheduled) {
+            entry.dwDeferredCycles++;
+            m_stats.dwDeferred++;
+            m_stats.dwMaxDeferredCycles = std::max(m_stats.dwMaxDeferredCycles, entry.dwDeferredCycles);
+        }
+    }
+
+    if (m_cfg.dwBudgetMicros > 0 && m_qwSpentMicros > m_cfg.dwBudgetMicros) {
+        m_stats.dwOverruns++;
+    }
+}
+
+} // namespace ai_ecmp
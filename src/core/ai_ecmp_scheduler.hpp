@@ -0,0 +1,148 @@
+#ifndef AI_ECMP_SCHEDULER_HPP
+#define AI_ECMP_SCHEDULER_HPP
+
+#include <vector>
+#include <unordered_map>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 优化周期调度配置
+ */
+typedef struct {
+    WORD32 dwBudgetMicros;              /* 每个优化周期的CPU预算（微秒），0表示不限制 */
+    double agingFactor;                 /* 每推迟一个周期优先级增加的比例 */
+} T_AI_ECMP_SCHED_CFG;
+
+/**
+ * SG调度条目
+ */
+typedef struct {
+    WORD32 dwSgId;                      /* SG ID */
+    double benefit;                     /* 期望收益：超出公平份额的负载量（不均衡度 × 流量） */
+    double priority;                    /* 调度优先级 = benefit * (1 + agingFactor * 推迟周期数) */
+    double costMicros;                  /* 优化耗时估计（微秒，指数加权平均） */
+    WORD32 dwDeferredCycles;            /* 连续被推迟的周期数 */
+    WORD32 dwSeenCycle;                 /* 最近一次更新收益的调度周期（按相位处理时每周期只有部分SG参与） */
+    bool bUrgent;                       /* 有必须本周期下发的配置（故障切换、排空、再均衡），不受预算限制 */
+    bool bScheduled;                    /* 本周期是否已执行 */
+} T_AI_ECMP_SCHED_ENTRY;
+
+/**
+ * 调度统计（最近一个周期及累计）
+ */
+typedef struct {
+    WORD32 dwCycles;                    /* 调度周期数 */
+    WORD32 dwScheduled;                 /* 最近一个周期执行的SG数 */
+    WORD32 dwDeferred;                  /* 最近一个周期推迟的SG数 */
+    WORD64 qwSpentMicros;               /* 最近一个周期的优化耗时（微秒） */
+    WORD32 dwMaxDeferredCycles;         /* 最近一个周期中最长的连续推迟周期数 */
+    WORD32 dwOverruns;                  /* 累计超出预算的周期数（必须执行的SG或单个SG耗时超出预算时可能发生） */
+} T_AI_ECMP_SCHED_STATS;
+
+/**
+ * 优化周期调度器
+ * 按期望收益（不均衡度 × 流量）维护SG优先级索引，每个周期按优先级顺序在全局CPU预算内执行优化，
+ * 预算不足的SG推迟到后续周期，推迟期间优先级随周期数老化上升，避免长期饥饿。
+ * 条目紧凑存放、不保持顺序（删除时与末尾条目交换），每周期只对参与本周期调度的条目排序，
+ * 按相位处理时排序开销与每周期处理的SG数成正比，而不是与SG总数成正比
+ */
+class CycleScheduler {
+public:
+    /** 优化耗时估计的指数加权系数 */
+    static constexpr double COST_ALPHA = 0.3;
+
+    CycleScheduler();
+
+    /**
+     * @brief 设置调度配置，参数越界时收敛到有效范围
+     * @param cfg 调度配置
+     */
+    void configure(const T_AI_ECMP_SCHED_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_SCHED_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 更新SG的期望收益（计数器更新后调用，新SG自动加入索引）
+     * @param dwSgId SG ID
+     * @param benefit 期望收益
+     * @param bUrgent 是否有必须本周期下发的配置
+     */
+    void updateBenefit(WORD32 dwSgId, double benefit, bool bUrgent);
+
+    /**
+     * @brief 移除SG（SG删除时调用）
+     * @param dwSgId SG ID
+     */
+    void removeSg(WORD32 dwSgId);
+
+    /**
+     * @brief 开始一个调度周期：按优先级排序参与本周期调度的条目（本周期更新过收益的SG）
+     * @return 参与本周期调度的条目数
+     */
+    size_t beginCycle();
+
+    /**
+     * @brief 获取参与本周期调度的条目数（SG删除后本周期的顺序失效，下个周期重建前为0）
+     */
+    size_t getActiveCount() const { return m_order.size(); }
+
+    /**
+     * @brief 获取参与本周期调度、按优先级排序的第index个条目
+     */
+    const T_AI_ECMP_SCHED_ENTRY& getEntry(size_t index) const { return m_entries[m_order[index]]; }
+
+    /**
+     * @brief 判断第index个条目能否在剩余预算内执行
+     * 必须执行的SG以及本周期的第一个SG总是允许执行，其余SG的耗时估计超出剩余预算时推迟
+     * （尚未执行过的SG按平均耗时估计）
+     * @param index 条目下标（按优先级顺序）
+     */
+    bool admit(size_t index) const;
+
+    /**
+     * @brief 记录第index个条目的执行耗时
+     * @param index 条目下标
+     * @param qwMicros 执行耗时（微秒）
+     */
+    void complete(size_t index, WORD64 qwMicros);
+
+    /**
+     * @brief 结束调度周期：更新参与本周期但未执行的SG的推迟计数和统计
+     */
+    void endCycle();
+
+    /**
+     * @brief 获取索引中的SG数
+     */
+    size_t getEntryCount() const { return m_entries.size(); }
+
+    /**
+     * @brief 获取调度统计
+     */
+    const T_AI_ECMP_SCHED_STATS& getStats() const { return m_stats; }
+
+private:
+    // 优先级比较：必须执行的SG在前，其次按优先级降序，相同时按SG ID保证顺序稳定
+    static bool isBefore(const T_AI_ECMP_SCHED_ENTRY& a, const T_AI_ECMP_SCHED_ENTRY& b);
+
+    T_AI_ECMP_SCHED_CFG m_cfg;
+    T_AI_ECMP_SCHED_STATS m_stats;
+
+    WORD32 m_dwCycle;                   /* 当前调度周期编号 */
+    WORD64 m_qwSpentMicros;             /* 本周期已用耗时 */
+    WORD32 m_dwAdmitted;                /* 本周期已执行的SG数 */
+    double m_avgCostMicros;             /* 所有SG优化耗时的指数加权平均，用于估计尚未执行过的SG */
+
+    std::vector<T_AI_ECMP_SCHED_ENTRY> m_entries;       /* 调度条目（紧凑存放，不保持顺序） */
+    std::unordered_map<WORD32, size_t> m_positions;     /* SG ID -> 条目下标 */
+    std::vector<size_t> m_order;                        /* 参与本周期调度的条目下标，按优先级排序 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_SCHEDULER_HPP */
@@ -0,0 +1,201 @@
+#include "ai_ecmp_significance.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ai_ecmp {
+
+constexpr WORD32 ImprovementTest::MAX_SAMPLES;
+
+namespace {
+
+// 单侧t分布临界值表：行为置信度档位，列为自由度 1..9
+const double CONFIDENCE_LEVELS[] = {0.80, 0.90, 0.95, 0.975, 0.99};
+const WORD32 CONFIDENCE_LEVEL_NUM = sizeof(CONFIDENCE_LEVELS) / sizeof(CONFIDENCE_LEVELS[0]);
+const WORD32 MAX_DEGREES = 9;
+const double T_CRITICAL_TABLE[CONFIDENCE_LEVEL_NUM][MAX_DEGREES] = {
+    {1.376, 1.061, 0.978, 0.941, 0.920, 0.906, 0.896, 0.889, 0.883},
+    {3.078, 1.886, 1.638, 1.533, 1.476, 1.440, 1.415, 1.397, 1.383},
+    {6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833},
+    {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262},
+    {31.821, 6.965, 4.541, 3.747, 3.365, 3.143, 2.998, 2.896, 2.821}
+};
+
+} // namespace
+
+ImprovementTest::ImprovementTest() {
+    // 默认：窗口内至少3个速率样本，候选表的改进在90%单侧置信度下显著才下发
+    T_AI_ECMP_SIGNIFICANCE_CFG cfg = {true, 0.90, 3};
+    configure(cfg);
+}
+
+void ImprovementTest::configure(const T_AI_ECMP_SIGNIFICANCE_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.confidence = std::min(std::max(m_cfg.confidence, CONFIDENCE_LEVELS[0]),
+                                CONFIDENCE_LEVELS[CONFIDENCE_LEVEL_NUM - 1]);
+    // 至少2个样本才能估计差值的方差
+    m_cfg.dwMinSamples = std::min(std::max(m_cfg.dwMinSamples, static_cast<WORD32>(2)), MAX_SAMPLES);
+    m_result = {0, 0.0, 0.0, 0.0, 0.0, 0.0, false, false};
+}
+
+double ImprovementTest::getCriticalValue(WORD32 dwDegrees, double confidence) {
+    const WORD32 dwColumn = std::min(std::max(dwDegrees, static_cast<WORD32>(1)), MAX_DEGREES) - 1;
+
+    if (confidence <= CONFIDENCE_LEVELS[0]) {
+        return T_CRITICAL_TABLE[0][dwColumn];
+    }
+    for (WORD32 i = 1; i < CONFIDENCE_LEVEL_NUM; ++i) {
+        if (confidence <= CONFIDENCE_LEVELS[i]) {
+            double ratio = (confidence - CONFIDENCE_LEVELS[i - 1]) / (CONFIDENCE_LEVELS[i] - CONFIDENCE_LEVELS[i - 1]);
+            return T_CRITICAL_TABLE[i - 1][dwColumn]
+                + ratio * (T_CRITICAL_TABLE[i][dwColumn] - T_CRITICAL_TABLE[i - 1][dwColumn]);
+        }
+    }
+    return T_CRITICAL_TABLE[CONFIDENCE_LEVEL_NUM - 1][dwColumn];
+}
+
+const T_AI_ECMP_SIGNIFICANCE_RESULT& ImprovementTest::evaluate(
+    const std::vector<WORD64>& history, WORD16 wHead, WORD16 wNum, WORD16 wSlots,
+    const std::vector<WORD32>& currentTable,
+    const std::vector<WORD32>& candidateTable,
+    const std::vector<WORD32>& portIds,
+    const std::vector<WORD32>& portSpeeds) {
+
+    m_result = {0, 0.0, 0.0, 0.0, 0.0, 0.0, false, false};
+
+    const size_t itemNum = currentTable.size();
+    const size_t portNum = std::min(portIds.size(), portSpeeds.size());
+    if (!m_cfg.bEnable || wSlots == 0 || itemNum == 0 || portNum == 0 ||
+        candidateTable.size() != itemNum || history.size() != itemNum * wSlots) {
+        return m_result;
+    }
+
+    // wNum个周期的累计计数给出 wNum-1 个速率样本，只取最近的 MAX_SAMPLES 个
+    const WORD32 dwSamples = std::min(static_cast<WORD32>(std::min(wNum, wSlots)), MAX_SAMPLES + 1) - 1;
+    if (wNum < 2 || dwSamples < m_cfg.dwMinSamples) {
+        m_result.dwSamples = wNum >= 2 ? dwSamples : 0;
+        return m_result;
+    }
+
+    // 按时间从旧到新排列参与检验的周期
+    const WORD64* slots[MAX_SAMPLES + 1];
+    for (WORD32 n = 0; n <= dwSamples; ++n) {
+        size_t slot = (wHead + wSlots - (dwSamples + 1) + n) % wSlots;
+        slots[n] = &history[slot * itemNum];
+    }
+
+    m_loadsBefore.assign(portNum * dwSamples, 0.0);
+    m_loadsAfter.assign(portNum * dwSamples, 0.0);
+    m_usedBefore.assign(portNum, 0);
+    m_usedAfter.assign(portNum, 0);
+
+    // 一次遍历桶，将每个桶在各样本上的速率同时累加到两张成员表各自的端口上
+    double rates[MAX_SAMPLES];
+    size_t lastBefore = 0;
+    size_t lastAfter = 0;
+    for (size_t i = 0; i < itemNum; ++i) {
+        // 相邻桶常映射到同一端口，先比较上一次找到的下标
+        if (lastBefore >= portNum || portIds[lastBefore] != currentTable[i]) {
+            lastBefore = std::find(portIds.begin(), portIds.begin() + portNum, currentTable[i]) - portIds.begin();
+        }
+        if (lastAfter >= portNum || portIds[lastAfter] != candidateTable[i]) {
+            lastAfter = std::find(portIds.begin(), portIds.begin() + portNum, candidateTable[i]) - portIds.begin();
+        }
+
+        for (WORD32 s = 0; s < dwSamples; ++s) {
+            WORD64 qwCur = slots[s + 1][i];
+            WORD64 qwPrev = slots[s][i];
+            rates[s] = static_cast<double>(qwCur >= qwPrev ? qwCur - qwPrev : qwCur);
+        }
+
+        if (lastBefore < portNum) {
+            double* pLoads = &m_loadsBefore[lastBefore * dwSamples];
+            for (WORD32 s = 0; s < dwSamples; ++s) {
+                pLoads[s] += rates[s];
+            }
+            m_usedBefore[lastBefore] = 1;
+        }
+        if (lastAfter < portNum) {
+            double* pLoads = &m_loadsAfter[lastAfter * dwSamples];
+            for (WORD32 s = 0; s < dwSamples; ++s) {
+                pLoads[s] += rates[s];
+            }
+            m_usedAfter[lastAfter] = 1;
+        }
+    }
+
+    double gapsBefore[MAX_SAMPLES];
+    double gapsAfter[MAX_SAMPLES];
+    calculateGaps(m_loadsBefore, m_usedBefore, portSpeeds, dwSamples, gapsBefore);
+    calculateGaps(m_loadsAfter, m_usedAfter, portSpeeds, dwSamples, gapsAfter);
+
+    // 配对差值（正值表示候选表在该样本上更均衡）的均值和样本标准差
+    double sumBefore = 0.0;
+    double sumAfter = 0.0;
+    for (WORD32 s = 0; s < dwSamples; ++s) {
+        sumBefore += gapsBefore[s];
+        sumAfter += gapsAfter[s];
+    }
+    const double meanDiff = (sumBefore - sumAfter) / dwSamples;
+    double sumSq = 0.0;
+    for (WORD32 s = 0; s < dwSamples; ++s) {
+        double dev = gapsBefore[s] - gapsAfter[s] - meanDiff;
+        sumSq += dev * dev;
+    }
+    const double stdDiff = std::sqrt(sumSq / (dwSamples - 1));
+
+    m_result.dwSamples = dwSamples;
+    m_result.bTested = true;
+    m_result.meanGapBefore = sumBefore / dwSamples;
+    m_result.meanGapAfter = sumAfter / dwSamples;
+    m_result.meanImprovement = m_result.meanGapBefore > 0.0
+        ? (m_result.meanGapBefore - m_result.meanGapAfter) / m_result.meanGapBefore * 100.0 : 0.0;
+    m_result.tCritical = getCriticalValue(dwSamples - 1, m_cfg.confidence);
+
+    // 差值完全一致时没有噪声，只要有改进即为显著
+    if (stdDiff > 0.0) {
+        m_result.tStat = meanDiff / (stdDiff / std::sqrt(static_cast<double>(dwSamples)));
+        m_result.bSignificant = m_result.tStat >= m_result.tCritical;
+    } else {
+        m_result.bSignificant = meanDiff > 0.0;
+    }
+    return m_result;
+}
+
+void ImprovementTest::calculateGaps(const std::vector<double>& loads, const std::vector<BYTE>& used,
+                                    const std::vector<WORD32>& portSpeeds, WORD32 dwSamples, double* pGaps) const {
+    for (WORD32 s = 0; s < dwSamples; ++s) {
+        double sum = 0.0;
+        double minLoad = 0.0;
+        double maxLoad = 0.0;
+        WORD32 dwPorts = 0;
+        for (size_t p = 0; p < used.size(); ++p) {
+            if (!used[p] || portSpeeds[p] == 0) {
+                continue;
+            }
+            double normalized = loads[p * dwSamples + s] / portSpeeds[p];
+            sum += normalized;
+            minLoad = dwPorts == 0 ? normalized : std::min(minLoad, normalized);
+            maxLoad = dwPorts == 0 ? normalized : std::max(maxLoad, normalized);
+            dwPorts++;
+        }
+        // 与calculateLoadBalanceMetrics的总偏差一致：(max-avg)/avg + (avg-min)/avg
+        double avg = dwPorts > 0 ? sum / dwPorts : 0.0;
+        pGaps[s] = avg > 0.0 ? (maxLoad - minLoad) / avg : 0.0;
+    }
+}
+
+void ImprovementTest::release() {
+    std::vector<double>().swap(m_loadsBefore);
+    std::vector<double>().swap(m_loadsAfter);
+    std::vector<BYTE>().swap(m_usedBefore);
+    std::vector<BYTE>().swap(m_usedAfter);
+    m_result = {0, 0.0, 0.0, 0.0, 0.0, 0.0, false, false};
+}
+
+size_t ImprovementTest::getMemoryFootprint() const {
+    return sizeof(*this)
+        + (m_loadsBefore.capacity() + m_loadsAfter.capacity()) * sizeof(double)
+        + (m_usedBefore.capacity() + m_usedAfter.capacity()) * sizeof(BYTE);
+}
+
+} // namespace ai_ecmp
@@ -0,0 +1,114 @@
+#ifndef AI_ECMP_SIGNIFICANCE_HPP
+#define AI_ECMP_SIGNIFICANCE_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 优化效果显著性检验配置
+ */
+typedef struct {
+    bool bEnable;                       /* 是否启用（禁用时只按最新一次负载估计比较） */
+    double confidence;                  /* 单侧置信度，有效范围 [0.80, 0.99] */
+    WORD32 dwMinSamples;                /* 检验所需的最少速率样本数，不足时退回单样本比较 */
+} T_AI_ECMP_SIGNIFICANCE_CFG;
+
+/**
+ * 优化效果显著性检验结果
+ */
+typedef struct {
+    WORD32 dwSamples;                   /* 参与检验的速率样本数 */
+    double meanGapBefore;               /* 当前成员表在各样本上的总偏差均值 */
+    double meanGapAfter;                /* 候选成员表在各样本上的总偏差均值 */
+    double meanImprovement;             /* 平均改进百分比 = (前-后)/前 * 100 */
+    double tStat;                       /* 配对差值的t统计量（差值无波动时为0） */
+    double tCritical;                   /* 按自由度和置信度查得的临界值 */
+    bool bTested;                       /* 样本是否足够完成检验 */
+    bool bSignificant;                  /* 候选成员表的改进是否显著 */
+} T_AI_ECMP_SIGNIFICANCE_RESULT;
+
+/**
+ * 优化效果显著性检验
+ * 在计数器历史窗口的每个速率样本上分别计算当前成员表和候选成员表的总偏差，
+ * 对逐样本的偏差差值做单侧配对t检验：只有候选表在整个窗口上稳定地优于当前表时才判定为显著，
+ * 避免仅在最新一个噪声样本上占优的候选表被下发。
+ * 各样本的端口负载在一次遍历桶时同时累加（样本维连续存放），缓冲区跨周期复用
+ */
+class ImprovementTest {
+public:
+    /** 参与检验的速率样本数上限 */
+    static constexpr WORD32 MAX_SAMPLES = 16;
+
+    ImprovementTest();
+
+    /**
+     * @brief 设置检验配置，参数越界时收敛到有效范围
+     * @param cfg 检验配置
+     */
+    void configure(const T_AI_ECMP_SIGNIFICANCE_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_SIGNIFICANCE_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 在计数器历史窗口上检验候选成员表相对当前成员表的改进
+     * @param history 计数器历史环形缓冲（wSlots个周期 × itemNum 平铺存放的累计计数）
+     * @param wHead 下一个写入位置
+     * @param wNum 已有的周期数
+     * @param wSlots 环形缓冲的周期数
+     * @param currentTable 当前成员表 (hash_index -> portId)
+     * @param candidateTable 候选成员表，长度需与当前成员表一致
+     * @param portIds 端口ID数组
+     * @param portSpeeds 端口速率数组（与端口ID按下标对应）
+     * @return 检验结果（未启用、样本不足或输入不一致时 bTested 为false）
+     */
+    const T_AI_ECMP_SIGNIFICANCE_RESULT& evaluate(
+        const std::vector<WORD64>& history, WORD16 wHead, WORD16 wNum, WORD16 wSlots,
+        const std::vector<WORD32>& currentTable,
+        const std::vector<WORD32>& candidateTable,
+        const std::vector<WORD32>& portIds,
+        const std::vector<WORD32>& portSpeeds);
+
+    /**
+     * @brief 获取最近一次检验结果
+     */
+    const T_AI_ECMP_SIGNIFICANCE_RESULT& getLastResult() const { return m_result; }
+
+    /**
+     * @brief 释放检验缓冲区
+     */
+    void release();
+
+    /**
+     * @brief 获取检验器占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @brief 查询单侧t分布临界值（置信度在表内各档之间线性插值）
+     * @param dwDegrees 自由度，超出表范围时取最大自由度
+     * @param confidence 单侧置信度
+     */
+    static double getCriticalValue(WORD32 dwDegrees, double confidence);
+
+private:
+    // 按端口负载逐样本计算总偏差 (max-min)/avg，只统计成员表中出现的端口
+    void calculateGaps(const std::vector<double>& loads, const std::vector<BYTE>& used,
+                       const std::vector<WORD32>& portSpeeds, WORD32 dwSamples, double* pGaps) const;
+
+    T_AI_ECMP_SIGNIFICANCE_CFG m_cfg;
+    T_AI_ECMP_SIGNIFICANCE_RESULT m_result;
+
+    std::vector<double> m_loadsBefore;  /* 当前成员表的端口负载（端口 × 样本） */
+    std::vector<double> m_loadsAfter;   /* 候选成员表的端口负载（端口 × 样本） */
+    std::vector<BYTE> m_usedBefore;     /* 端口是否出现在当前成员表中 */
+    std::vector<BYTE> m_usedAfter;      /* 端口是否出现在候选成员表中 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_SIGNIFICANCE_HPP */
@@ -0,0 +1,192 @@
+#include "ai_ecmp_snapshot.hpp"
+#include "ai_ecmp_instance.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace ai_ecmp {
+
+// 对外记录格式固定，字段调整须同步修改版本号
+static_assert(sizeof(T_AI_ECMP_INSTANCE_STATUS) == 72, "T_AI_ECMP_INSTANCE_STATUS layout changed");
+
+StatusBoard::StatusBoard()
+    : m_dwActive(0)
+    , m_qwNextStamp(1) {
+    for (WORD32 i = 0; i < 2; ++i) {
+        m_buffers[i].qwVersion = 0;
+        m_adwReaders[i].store(0);
+    }
+}
+
+WORD32 StatusBoard::enter() const {
+    for (;;) {
+        WORD32 dwIndex = m_dwActive.load();
+        m_adwReaders[dwIndex].fetch_add(1);
+        // 登记后再确认缓冲区未切换：写者切换后会等待登记在旧缓冲区上的读者离开
+        if (m_dwActive.load() == dwIndex) {
+            return dwIndex;
+        }
+        m_adwReaders[dwIndex].fetch_sub(1);
+    }
+}
+
+void StatusBoard::leave(WORD32 dwIndex) const {
+    m_adwReaders[dwIndex].fetch_sub(1);
+}
+
+void StatusBoard::waitReaders(WORD32 dwIndex) const {
+    while (m_adwReaders[dwIndex].load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void StatusBoard::publish(const std::vector<T_AI_ECMP_STATUS_UPDATE>& updates,
+                          const std::vector<T_AI_ECMP_POOL_ENTRY>& removed) {
+    if (updates.empty() && removed.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+    filter(updates, removed);
+    if (m_applyUpdates.empty() && m_applyRemoved.empty()) {
+        return;
+    }
+
+    const WORD32 dwActive = m_dwActive.load();
+    const WORD32 dwStandby = 1 - dwActive;
+
+    // 先修改备用缓冲区并切换，读者随即看到新状态
+    waitReaders(dwStandby);
+    apply(m_buffers[dwStandby]);
+    m_buffers[dwStandby].qwVersion = m_buffers[dwActive].qwVersion + 1;
+    m_dwActive.store(dwStandby);
+
+    // 旧缓冲区的读者离开后补上同样的修改，两份缓冲区重新一致
+    waitReaders(dwActive);
+    apply(m_buffers[dwActive]);
+    m_buffers[dwActive].qwVersion = m_buffers[dwStandby].qwVersion;
+}
+
+void StatusBoard::filter(const std::vector<T_AI_ECMP_STATUS_UPDATE>& updates,
+                         const std::vector<T_AI_ECMP_POOL_ENTRY>& removed) {
+    m_applyUpdates.clear();
+    m_applyRemoved.clear();
+
+    // 先处理删除：记录释放的代数，只删除属于该句柄的记录（同一SG已重建时保留新实例的记录）
+    for (const T_AI_ECMP_POOL_ENTRY& entry : removed) {
+        WORD32& dwReleasedGen = m_releasedGen[entry.handle.dwIndex];
+        dwReleasedGen = std::max(dwReleasedGen, entry.handle.dwGeneration + 1);
+        auto it = m_owners.find(entry.dwSgId);
+        if (it != m_owners.end() && it->second.handle.dwIndex == entry.handle.dwIndex &&
+            it->second.handle.dwGeneration == entry.handle.dwGeneration) {
+            m_owners.erase(it);
+            m_applyRemoved.push_back(entry.dwSgId);
+        }
+    }
+
+    for (const T_AI_ECMP_STATUS_UPDATE& update : updates) {
+        // 实例已释放：采集在删除之前，发布在删除之后，丢弃
+        auto released = m_releasedGen.find(update.handle.dwIndex);
+        if (released != m_releasedGen.end() && update.handle.dwGeneration < released->second) {
+            continue;
+        }
+        // 已发布更晚的采集：丢弃过时的采集
+        T_OWNER& owner = m_owners[update.status.dwSgId];
+        if (owner.qwStamp > update.qwStamp) {
+            continue;
+        }
+        owner.handle = update.handle;
+        owner.qwStamp = update.qwStamp;
+        m_applyUpdates.push_back(update.status);
+    }
+}
+
+void StatusBoard::apply(T_BUFFER& buffer) const {
+    for (const T_AI_ECMP_INSTANCE_STATUS& status : m_applyUpdates) {
+        auto it = buffer.positions.find(status.dwSgId);
+        if (it != buffer.positions.end()) {
+            buffer.records[it->second] = status;
+        } else {
+            buffer.positions.emplace(status.dwSgId, static_cast<WORD32>(buffer.records.size()));
+            buffer.records.push_back(status);
+        }
+    }
+    for (WORD32 dwSgId : m_applyRemoved) {
+        auto it = buffer.positions.find(dwSgId);
+        if (it == buffer.positions.end()) {
+            continue;
+        }
+        // 与末尾记录交换后删除，保持数组紧凑
+        const WORD32 dwPos = it->second;
+        buffer.positions.erase(it);
+        if (dwPos + 1 != buffer.records.size()) {
+            buffer.records[dwPos] = buffer.records.back();
+            buffer.positions[buffer.records[dwPos].dwSgId] = dwPos;
+        }
+        buffer.records.pop_back();
+    }
+}
+
+WORD32 StatusBoard::exportTo(void* pBuffer, WORD32 dwBufferSize) const {
+    const WORD32 dwIndex = enter();
+    const std::vector<T_AI_ECMP_INSTANCE_STATUS>& records = m_buffers[dwIndex].records;
+    WORD32 dwCount = static_cast<WORD32>(records.size());
+    if (pBuffer != nullptr) {
+        dwCount = std::min(dwCount, static_cast<WORD32>(dwBufferSize / sizeof(T_AI_ECMP_INSTANCE_STATUS)));
+        if (dwCount > 0) {
+            memcpy(pBuffer, records.data(), dwCount * sizeof(T_AI_ECMP_INSTANCE_STATUS));
+        }
+    }
+    leave(dwIndex);
+    return dwCount;
+}
+
+WORD64 StatusBoard::copyTo(std::vector<T_AI_ECMP_INSTANCE_STATUS>& instances) const {
+    const WORD32 dwIndex = enter();
+    instances = m_buffers[dwIndex].records;
+    const WORD64 qwVersion = m_buffers[dwIndex].qwVersion;
+    leave(dwIndex);
+    return qwVersion;
+}
+
+bool StatusBoard::find(WORD32 dwSgId, T_AI_ECMP_INSTANCE_STATUS& status) const {
+    const WORD32 dwIndex = enter();
+    const T_BUFFER& buffer = m_buffers[dwIndex];
+    auto it = buffer.positions.find(dwSgId);
+    const bool bFound = it != buffer.positions.end();
+    if (bFound) {
+        status = buffer.records[it->second];
+    }
+    leave(dwIndex);
+    return bFound;
+}
+
+void StatusBoard::capture(const T_AI_ECMP_POOL_ENTRY& entry, const EcmpInstance& instance,
+                          T_AI_ECMP_STATUS_UPDATE& update) const {
+    const WORD32 dwSgId = entry.dwSgId;
+    T_AI_ECMP_INSTANCE_STATUS& status = update.status;
+    update.handle = entry.handle;
+    update.qwStamp = m_qwNextStamp.fetch_add(1);
+    const T_AI_ECMP_SG_HDR& hdr = instance.getSgHeader();
+    const T_AI_ECMP_EVAL& eval = instance.getLastEval();
+    const T_AI_ECMP_INFLIGHT_STATE& inflight = instance.getInflightTracker().getState();
+    status = {};
+    status.wVersion = AI_ECMP_STATUS_VERSION;
+    status.wLength = static_cast<WORD16>(sizeof(T_AI_ECMP_INSTANCE_STATUS));
+    status.dwSgId = dwSgId;
+    status.dwStatus = static_cast<WORD32>(instance.getStatus());
+    status.dwItemNum = hdr.dwItemNum;
+    status.dwPortNum = hdr.dwPortNum;
+    status.dwCycle = instance.getCycle();
+    status.dwOptEnabled = instance.isOptimizationEnabled() ? 1 : 0;
+    status.dwDisabledCycles = instance.isOptimizationEnabled() ? 0 : instance.getDisabledCycles();
+    status.dwFailures = instance.getConsecutiveFailures();
+    status.dwLastOptMicros = instance.getLastOptimizeMicros();
+    status.dwPending = inflight.bActive ? 1 : 0;
+    status.dwPendingSeqId = inflight.bActive ? inflight.dwSeqId : 0;
+    status.avgGap = eval.avgGap;
+    status.totalGap = eval.totalGap;
+    status.balanceScore = eval.balanceScore;
+}
+
+} // namespace ai_ecmp
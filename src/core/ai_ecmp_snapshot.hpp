@@ -0,0 +1,118 @@
+#ifndef AI_ECMP_SNAPSHOT_HPP
+#define AI_ECMP_SNAPSHOT_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "ai_ecmp_types.h"
+#include "ai_ecmp_pool.hpp"
+
+namespace ai_ecmp {
+
+/**
+ * 一次状态采集：状态记录及采集时的实例句柄和采集序号
+ */
+typedef struct {
+    T_AI_ECMP_INSTANCE_STATUS status;   /* 实例状态 */
+    T_AI_ECMP_INSTANCE_HANDLE handle;   /* 采集时的实例句柄 */
+    WORD64 qwStamp;                     /* 采集序号（实例锁内取得，同一实例的采集按序号先后） */
+} T_AI_ECMP_STATUS_UPDATE;
+
+/**
+ * 实例状态发布板（双缓冲）
+ * 两份状态记录数组内容相同，读者只读当前缓冲区，写者先修改另一份再切换，等旧缓冲区的读者离开后把同样的修改补到旧缓冲区。
+ * 写者只改动有变化的记录（删除时与末尾记录交换），发布开销与变化的实例数成正比，与实例总数无关；
+ * 读者不获取任何锁、不等待写者，导出全部状态只是一次有界的memcpy，高频轮询也不会阻塞优化路径。
+ * 记录在数组中的顺序为插入顺序（删除后由末尾记录填补），不按SG ID排序。
+ * 采集和发布之间实例可能已被删除：发布时按句柄代数丢弃已释放实例的状态，并丢弃比已发布记录更早的采集，
+ * 已删除的SG不会被迟到的发布重新加入
+ */
+class StatusBoard {
+public:
+    StatusBoard();
+
+    StatusBoard(const StatusBoard&) = delete;
+    StatusBoard& operator=(const StatusBoard&) = delete;
+
+    /**
+     * @brief 发布状态变化：更新或加入updates中的实例，删除removed中的实例
+     * @param updates 状态采集（已释放实例的采集和过时的采集被丢弃）
+     * @param removed 已释放的实例（SG ID及句柄，须在实例释放后发布）
+     */
+    void publish(const std::vector<T_AI_ECMP_STATUS_UPDATE>& updates, const std::vector<T_AI_ECMP_POOL_ENTRY>& removed);
+
+    /**
+     * @brief 把所有实例状态复制到调用方缓冲区（无锁，一次memcpy）
+     * @param pBuffer 输出缓冲区，为空时只返回实例数
+     * @param dwBufferSize 缓冲区大小（字节），不足时只复制能放下的记录
+     * @return 复制的记录数（pBuffer为空时为实例数）
+     */
+    WORD32 exportTo(void* pBuffer, WORD32 dwBufferSize) const;
+
+    /**
+     * @brief 复制所有实例状态（无锁）
+     * @param instances 输出参数，实例状态
+     * @return 发布版本号
+     */
+    WORD64 copyTo(std::vector<T_AI_ECMP_INSTANCE_STATUS>& instances) const;
+
+    /**
+     * @brief 查找单个实例的状态（无锁）
+     * @param dwSgId SG ID
+     * @param status 输出参数，实例状态
+     * @return 是否找到
+     */
+    bool find(WORD32 dwSgId, T_AI_ECMP_INSTANCE_STATUS& status) const;
+
+    /**
+     * @brief 采集实例状态（调用方须持有实例锁）
+     * @param entry 实例的SG ID及句柄
+     * @param instance 实例
+     * @param update 输出参数，状态采集
+     */
+    void capture(const T_AI_ECMP_POOL_ENTRY& entry, const EcmpInstance& instance, T_AI_ECMP_STATUS_UPDATE& update) const;
+
+private:
+    typedef struct {
+        std::vector<T_AI_ECMP_INSTANCE_STATUS> records;     /* 状态记录（紧凑排列） */
+        std::unordered_map<WORD32, WORD32> positions;       /* SG ID -> 记录下标 */
+        WORD64 qwVersion;                                   /* 发布版本号 */
+    } T_BUFFER;
+
+    // 读者进入当前缓冲区，返回缓冲区下标
+    WORD32 enter() const;
+
+    // 读者离开缓冲区
+    void leave(WORD32 dwIndex) const;
+
+    // 等待缓冲区上的读者全部离开
+    void waitReaders(WORD32 dwIndex) const;
+
+    typedef struct {
+        T_AI_ECMP_INSTANCE_HANDLE handle;                   /* 已发布记录的实例句柄 */
+        WORD64 qwStamp;                                     /* 已发布记录的采集序号 */
+    } T_OWNER;
+
+    // 按句柄代数和采集序号筛选出要应用的变化（调用方须持有发布锁）
+    void filter(const std::vector<T_AI_ECMP_STATUS_UPDATE>& updates, const std::vector<T_AI_ECMP_POOL_ENTRY>& removed);
+
+    // 把筛选后的变化应用到一份缓冲区
+    void apply(T_BUFFER& buffer) const;
+
+    std::mutex m_publishMutex;                          /* 串行化写者，读者不使用 */
+    T_BUFFER m_buffers[2];
+    std::atomic<WORD32> m_dwActive;                     /* 读者当前使用的缓冲区 */
+    mutable std::atomic<WORD32> m_adwReaders[2];        /* 各缓冲区上的读者数 */
+    mutable std::atomic<WORD64> m_qwNextStamp;          /* 下一个采集序号 */
+
+    // 以下只由写者在发布锁内访问
+    std::unordered_map<WORD32, T_OWNER> m_owners;       /* SG ID -> 已发布记录的句柄及采集序号 */
+    std::unordered_map<WORD32, WORD32> m_releasedGen;   /* 槽下标 -> 已释放的最大代数 */
+    std::vector<T_AI_ECMP_INSTANCE_STATUS> m_applyUpdates;  /* 筛选后的更新（跨发布复用） */
+    std::vector<WORD32> m_applyRemoved;                 /* 筛选后的删除（跨发布复用） */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_SNAPSHOT_HPP */
@@ -0,0 +1,137 @@
+#include "ai_ecmp_solution_cache.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ai_ecmp {
+
+SolutionCache::SolutionCache(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1)
+    , m_dwTick(0)
+    , m_dwHits(0)
+    , m_dwMisses(0) {
+}
+
+const T_AI_ECMP_CACHED_SOLUTION* SolutionCache::lookup(const std::vector<WORD64>& memberCounts) {
+    if (m_entries.empty() || memberCounts.empty()) {
+        m_dwMisses++;
+        return nullptr;
+    }
+
+    std::vector<BYTE> signature;
+    WORD64 qwHash = 0;
+    buildSignature(memberCounts, signature, qwHash);
+
+    const WORD32 dwMaxDistance = static_cast<WORD32>(MAX_AVG_LEVEL_DISTANCE * signature.size());
+    T_AI_ECMP_CACHED_SOLUTION* pBest = nullptr;
+    WORD32 dwBestDistance = 0;
+
+    for (auto& entry : m_entries) {
+        if (entry.signature.size() != signature.size()) {
+            continue;
+        }
+        // 哈希精确命中直接返回，否则按L1距离选最近邻
+        WORD32 dwDistance = (entry.qwSignatureHash == qwHash) ? 0 : signatureDistance(entry.signature, signature);
+        if (dwDistance <= dwMaxDistance && (!pBest || dwDistance < dwBestDistance)) {
+            pBest = &entry;
+            dwBestDistance = dwDistance;
+            if (dwDistance == 0) {
+                break;
+            }
+        }
+    }
+
+    if (!pBest) {
+        m_dwMisses++;
+        return nullptr;
+    }
+
+    pBest->dwLastUsedTick = ++m_dwTick;
+    pBest->dwHits++;
+    m_dwHits++;
+    return pBest;
+}
+
+void SolutionCache::store(const std::vector<WORD64>& memberCounts,
+                          const std::vector<WORD32>& memberTable,
+                          const T_AI_ECMP_EVAL& eval) {
+    if (memberCounts.empty()) {
+        return;
+    }
+
+    std::vector<BYTE> signature;
+    WORD64 qwHash = 0;
+    buildSignature(memberCounts, signature, qwHash);
+
+    T_AI_ECMP_CACHED_SOLUTION* pSlot = nullptr;
+    for (auto& entry : m_entries) {
+        if (entry.qwSignatureHash == qwHash && entry.signature == signature) {
+            pSlot = &entry;
+            break;
+        }
+    }
+
+    if (!pSlot) {
+        if (m_entries.size() < m_capacity) {
+            m_entries.push_back(T_AI_ECMP_CACHED_SOLUTION());
+            pSlot = &m_entries.back();
+        } else {
+            pSlot = &*std::min_element(m_entries.begin(), m_entries.end(),
+                [](const T_AI_ECMP_CACHED_SOLUTION& a, const T_AI_ECMP_CACHED_SOLUTION& b) {
+                    return a.dwLastUsedTick < b.dwLastUsedTick;
+                });
+        }
+        pSlot->dwHits = 0;
+    }
+
+    pSlot->signature = std::move(signature);
+    pSlot->qwSignatureHash = qwHash;
+    pSlot->memberTable = memberTable;
+    pSlot->eval = eval;
+    pSlot->dwLastUsedTick = ++m_dwTick;
+}
+
+void SolutionCache::clear() {
+    std::vector<T_AI_ECMP_CACHED_SOLUTION>().swap(m_entries);
+}
+
+size_t SolutionCache::getMemoryFootprint() const {
+    size_t bytes = sizeof(*this) + m_entries.capacity() * sizeof(T_AI_ECMP_CACHED_SOLUTION);
+    for (const auto& entry : m_entries) {
+        bytes += entry.signature.capacity() * sizeof(BYTE) + entry.memberTable.capacity() * sizeof(WORD32);
+    }
+    return bytes;
+}
+
+void SolutionCache::buildSignature(const std::vector<WORD64>& memberCounts,
+                                   std::vector<BYTE>& signature, WORD64& qwHash) {
+    WORD64 total = 0;
+    for (WORD64 count : memberCounts) {
+        total += count;
+    }
+
+    signature.assign(memberCounts.size(), 0);
+
+    // 每桶占比乘以桶数即为相对公平份额的倍数，再量化为档位
+    const double scale = total > 0
+        ? LEVELS_PER_FAIR_SHARE * memberCounts.size() / static_cast<double>(total)
+        : 0.0;
+
+    // FNV-1a 哈希
+    qwHash = 14695981039346656037ULL;
+    for (size_t i = 0; i < memberCounts.size(); ++i) {
+        double level = std::floor(memberCounts[i] * scale + 0.5);
+        signature[i] = static_cast<BYTE>(std::min(level, 255.0));
+        qwHash ^= signature[i];
+        qwHash *= 1099511628211ULL;
+    }
+}
+
+WORD32 SolutionCache::signatureDistance(const std::vector<BYTE>& lhs, const std::vector<BYTE>& rhs) {
+    WORD32 dwDistance = 0;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        dwDistance += (lhs[i] > rhs[i]) ? (lhs[i] - rhs[i]) : (rhs[i] - lhs[i]);
+    }
+    return dwDistance;
+}
+
+} // namespace ai_ecmp
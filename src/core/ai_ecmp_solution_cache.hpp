@@ -0,0 +1,88 @@
+#ifndef AI_ECMP_SOLUTION_CACHE_HPP
+#define AI_ECMP_SOLUTION_CACHE_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 缓存的优化解
+ */
+typedef struct {
+    std::vector<BYTE> signature;                    /* 量化后的归一化流量签名 */
+    WORD64 qwSignatureHash;                         /* 签名哈希（快速匹配） */
+    std::vector<WORD32> memberTable;                /* 优化后的成员表（下标为hash_index） */
+    T_AI_ECMP_EVAL eval;                            /* 该成员表在写入时达到的评估结果 */
+    WORD32 dwLastUsedTick;                          /* 最近使用时间戳（LRU） */
+    WORD32 dwHits;                                  /* 命中次数 */
+} T_AI_ECMP_CACHED_SOLUTION;
+
+/**
+ * 按量化流量签名索引的小容量LRU解缓存
+ * 签名：将成员计数归一化为流量占比，再按“公平份额”量化为若干档位。
+ * 相近的流量模式落在相同或相邻档位，查找时先按哈希精确匹配，
+ * 未命中再按档位L1距离在容差内做近邻匹配（局部敏感）
+ */
+class SolutionCache {
+public:
+    /**
+     * 构造函数
+     * @param capacity 缓存容量
+     */
+    explicit SolutionCache(size_t capacity = 8);
+
+    /**
+     * @brief 按当前流量查找缓存解
+     * @param memberCounts 成员计数表
+     * @return 匹配的缓存解，未命中返回nullptr（指针在下一次store/clear前有效）
+     */
+    const T_AI_ECMP_CACHED_SOLUTION* lookup(const std::vector<WORD64>& memberCounts);
+
+    /**
+     * @brief 写入优化解，签名相同则覆盖，容量满时淘汰最久未使用的条目
+     * @param memberCounts 成员计数表
+     * @param memberTable 优化后的成员表
+     * @param eval 该成员表的评估结果
+     */
+    void store(const std::vector<WORD64>& memberCounts,
+               const std::vector<WORD32>& memberTable,
+               const T_AI_ECMP_EVAL& eval);
+
+    /**
+     * @brief 清空缓存（配置变化后缓存的成员表不再适用）
+     */
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+    WORD32 getHits() const { return m_dwHits; }
+    WORD32 getMisses() const { return m_dwMisses; }
+
+    /**
+     * @brief 获取缓存占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+private:
+    // 公平份额对应的量化档位数
+    static constexpr double LEVELS_PER_FAIR_SHARE = 4.0;
+    // 近邻匹配允许的平均每桶档位差
+    static constexpr double MAX_AVG_LEVEL_DISTANCE = 0.5;
+
+    size_t m_capacity;
+    WORD32 m_dwTick;
+    WORD32 m_dwHits;
+    WORD32 m_dwMisses;
+    std::vector<T_AI_ECMP_CACHED_SOLUTION> m_entries;
+
+    // 计算量化签名及其哈希
+    static void buildSignature(const std::vector<WORD64>& memberCounts,
+                               std::vector<BYTE>& signature, WORD64& qwHash);
+
+    // 计算两个签名的L1距离
+    static WORD32 signatureDistance(const std::vector<BYTE>& lhs, const std::vector<BYTE>& rhs);
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_SOLUTION_CACHE_HPP */
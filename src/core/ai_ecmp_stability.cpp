@@ -0,0 +1,122 @@
+#include "ai_ecmp_stability.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ai_ecmp {
+
+constexpr WORD32 StabilityGate::MIN_SAMPLES;
+
+StabilityGate::StabilityGate()
+    : m_alpha(1.0)
+    , m_decayPow(1.0)
+    , m_dwSamples(0) {
+    // 默认：显著桶负载估计的相对误差在15%以内即视为稳定，低于桶平均负载10%的桶不参与判定
+    T_AI_ECMP_STABILITY_CFG cfg = {AI_ECMP_STABILITY_WEIGHTED, 0.15, 0.1, 8.0};
+    configure(cfg);
+}
+
+void StabilityGate::configure(const T_AI_ECMP_STABILITY_CFG& cfg) {
+    m_cfg = cfg;
+    m_cfg.errorThreshold = std::max(m_cfg.errorThreshold, 0.0);
+    m_cfg.minBucketShare = std::min(std::max(m_cfg.minBucketShare, 0.0), 1.0);
+    m_cfg.halfLifeCycles = std::max(m_cfg.halfLifeCycles, 1.0);
+
+    // 半衰期h：经过h个周期后旧样本的权重衰减为一半
+    m_alpha = 1.0 - std::pow(0.5, 1.0 / m_cfg.halfLifeCycles);
+
+    reset(m_mean.size());
+}
+
+void StabilityGate::reset(size_t bucketNum) {
+    m_dwSamples = 0;
+    m_decayPow = 1.0;
+    m_result = {0.0, 0.0, 0.0, 0.0, 0, false};
+
+    if (m_cfg.eMode != AI_ECMP_STABILITY_WEIGHTED || bucketNum == 0) {
+        std::vector<double>().swap(m_mean);
+        std::vector<double>().swap(m_var);
+        return;
+    }
+
+    m_mean.assign(bucketNum, 0.0);
+    m_var.assign(bucketNum, 0.0);
+}
+
+void StabilityGate::update(const WORD64* pCurrent, const WORD64* pPrevious, size_t bucketNum) {
+    if (m_cfg.eMode != AI_ECMP_STABILITY_WEIGHTED || bucketNum == 0 || bucketNum != m_mean.size()) {
+        return;
+    }
+
+    for (size_t i = 0; i < bucketNum; ++i) {
+        WORD64 qwRate = pCurrent[i] >= pPrevious[i] ? pCurrent[i] - pPrevious[i] : pCurrent[i];
+        double x = static_cast<double>(qwRate);
+
+        if (m_dwSamples == 0) {
+            m_mean[i] = x;
+            m_var[i] = 0.0;
+        } else {
+            // 指数加权的均值和方差增量更新
+            double diff = x - m_mean[i];
+            double incr = m_alpha * diff;
+            m_mean[i] += incr;
+            m_var[i] = (1.0 - m_alpha) * (m_var[i] + diff * incr);
+        }
+    }
+
+    if (m_dwSamples > 0) {
+        m_decayPow *= 1.0 - m_alpha;
+    }
+    m_dwSamples++;
+}
+
+const T_AI_ECMP_STABILITY_RESULT& StabilityGate::evaluate(double threshold) {
+    m_result = {0.0, 0.0, threshold, 0.0, 0, false};
+    if (m_dwSamples < MIN_SAMPLES || m_mean.empty()) {
+        return m_result;
+    }
+
+    double total = 0.0;
+    for (double mean : m_mean) {
+        total += mean;
+    }
+    // 没有流量时无从均衡，视为不稳定
+    if (total <= 0.0) {
+        return m_result;
+    }
+
+    const double floor = m_cfg.minBucketShare * total / m_mean.size();
+    double sumStd = 0.0;
+    double sumMean = 0.0;
+    for (size_t i = 0; i < m_mean.size(); ++i) {
+        if (m_mean[i] > 0.0 && m_mean[i] >= floor) {
+            sumStd += std::sqrt(m_var[i]);
+            sumMean += m_mean[i];
+            m_result.dwMaterialBuckets++;
+        }
+    }
+
+    // 以流量占比 mean_i/sumMean 加权各桶变异系数 std_i/mean_i，即标准差之和除以均值之和；
+    // 方差从0开始累积，样本较少时按已累积的权重 1-(1-a)^(n-1) 修正低估
+    const double varCorrection = 1.0 / std::sqrt(1.0 - m_decayPow);
+    m_result.weightedCv = sumMean > 0.0 ? sumStd * varCorrection / sumMean : 0.0;
+    // 指数加权均值的方差约为速率方差的 a/(2-a) 倍
+    m_result.estimateError = m_result.weightedCv * std::sqrt(m_alpha / (2.0 - m_alpha));
+    m_result.materialShare = sumMean / total;
+    m_result.bStable = m_result.dwMaterialBuckets > 0 && m_result.estimateError <= threshold;
+    return m_result;
+}
+
+size_t StabilityGate::getMemoryFootprint() const {
+    return sizeof(*this)
+        + (m_mean.capacity() + m_var.capacity()) * sizeof(double);
+}
+
+const char* StabilityGate::modeToString(T_AI_ECMP_STABILITY_MODE eMode) {
+    switch (eMode) {
+        case AI_ECMP_STABILITY_LEGACY:   return "LEGACY";
+        case AI_ECMP_STABILITY_WEIGHTED: return "WEIGHTED";
+        default:                         return "UNKNOWN";
+    }
+}
+
+} // namespace ai_ecmp
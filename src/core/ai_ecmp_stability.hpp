@@ -0,0 +1,119 @@
+#ifndef AI_ECMP_STABILITY_HPP
+#define AI_ECMP_STABILITY_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 稳定性判定方式
+ */
+typedef enum {
+    AI_ECMP_STABILITY_LEGACY = 0,       /* 累计计数历史上各桶变异系数的算术平均（旧行为） */
+    AI_ECMP_STABILITY_WEIGHTED          /* 按流量占比加权的每桶速率变异系数，仅统计显著桶 */
+} T_AI_ECMP_STABILITY_MODE;
+
+/**
+ * 稳定性判定配置
+ */
+typedef struct {
+    T_AI_ECMP_STABILITY_MODE eMode;     /* 判定方式 */
+    double errorThreshold;              /* 负载估计相对误差门限（每SG配置） */
+    double minBucketShare;              /* 显著桶下限：平滑负载 >= minBucketShare * 桶平均负载 */
+    double halfLifeCycles;              /* 每桶速率均值/方差统计的半衰期（周期数） */
+} T_AI_ECMP_STABILITY_CFG;
+
+/**
+ * 稳定性判定结果
+ */
+typedef struct {
+    double weightedCv;                  /* 加权速率变异系数 = 显著桶标准差之和 / 显著桶均值之和 */
+    double estimateError;               /* 负载估计相对误差 = 加权变异系数 * sqrt(a/(2-a))，a为统计的加权系数 */
+    double threshold;                   /* 本次使用的门限 */
+    double materialShare;               /* 显著桶负载占总负载的比例 */
+    WORD32 dwMaterialBuckets;           /* 参与判定的显著桶数 */
+    bool bStable;                       /* 是否稳定 */
+} T_AI_ECMP_STABILITY_RESULT;
+
+/**
+ * 按流量加权的每桶稳定性判定
+ * 增量维护每桶速率的指数加权均值和方差，判定时只统计对端口负载有实质影响的桶，
+ * 以各桶流量占比加权其变异系数（等价于标准差之和除以均值之和），再换算为平滑后负载估计的相对误差与门限比较：
+ * 低流量桶的抖动不会阻塞整个SG，高流量桶的波动也不会被大量平稳小桶平均掉；
+ * 流量大、相对波动小的SG更早通过判定。
+ * 状态按桶数一次性分配，更新和判定均为 O(桶数) 且不分配内存
+ */
+class StabilityGate {
+public:
+    /** 判定前至少需要的速率样本数 */
+    static constexpr WORD32 MIN_SAMPLES = 4;
+
+    StabilityGate();
+
+    /**
+     * @brief 设置判定配置，参数越界时收敛到有效范围，并清空已有统计
+     * @param cfg 判定配置
+     */
+    void configure(const T_AI_ECMP_STABILITY_CFG& cfg);
+
+    /**
+     * @brief 获取当前配置
+     */
+    const T_AI_ECMP_STABILITY_CFG& getConfig() const { return m_cfg; }
+
+    /**
+     * @brief 按桶数重置统计状态（旧判定方式下不分配）
+     * @param bucketNum 桶数
+     */
+    void reset(size_t bucketNum);
+
+    /**
+     * @brief 输入相邻两个周期的累计计数，更新每桶速率统计
+     * @param pCurrent 本周期各桶累计计数
+     * @param pPrevious 上一周期各桶累计计数（计数回绕或清零时按新值计为本周期增量）
+     * @param bucketNum 桶数，与reset时不一致时忽略本次输入
+     */
+    void update(const WORD64* pCurrent, const WORD64* pPrevious, size_t bucketNum);
+
+    /**
+     * @brief 按当前统计做一次判定
+     * @param threshold 负载估计相对误差门限
+     * @return 判定结果（样本不足或没有流量时为不稳定）
+     */
+    const T_AI_ECMP_STABILITY_RESULT& evaluate(double threshold);
+
+    /**
+     * @brief 获取最近一次判定结果
+     */
+    const T_AI_ECMP_STABILITY_RESULT& getLastResult() const { return m_result; }
+
+    /**
+     * @brief 获取已输入的速率样本数
+     */
+    WORD32 getSampleCount() const { return m_dwSamples; }
+
+    /**
+     * @brief 获取判定器占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @brief 获取判定方式名称
+     */
+    static const char* modeToString(T_AI_ECMP_STABILITY_MODE eMode);
+
+private:
+    T_AI_ECMP_STABILITY_CFG m_cfg;
+    T_AI_ECMP_STABILITY_RESULT m_result;
+    double m_alpha;                     /* 指数加权系数，由半衰期换算 */
+    double m_decayPow;                  /* (1-a)^(样本数-1)，用于修正样本较少时方差的低估 */
+
+    WORD32 m_dwSamples;                 /* 速率样本数 */
+    std::vector<double> m_mean;         /* 每桶速率的指数加权均值 */
+    std::vector<double> m_var;          /* 每桶速率的指数加权方差 */
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_STABILITY_HPP */
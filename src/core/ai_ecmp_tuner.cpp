@@ -0,0 +1,114 @@
+#include "ai_ecmp_tuner.hpp"
+#include <cmath>
+#include <limits>
+
+namespace ai_ecmp {
+
+ParameterTuner::ParameterTuner()
+    : m_activeArm(0)
+    , m_dwTotalPlays(0)
+    , m_bPinned(false) {
+    // 候选参数组：第0组为原有固定参数，其余在其附近有界取值
+    m_arms = {
+        {10000, 0.1,  0.05, 1.0},   // 默认
+        {2000,  0.1,  0.05, 1.0},   // 低CPU
+        {5000,  0.05, 0.05, 1.0},   // 低交换代价
+        {20000, 0.1,  0.08, 1.0},   // 深度搜索，放宽稳定门限
+        {5000,  0.2,  0.03, 2.0},   // 保守：更少交换、更严格门限
+        {1000,  0.2,  0.08, 3.0},   // 极低CPU，只下发显著改进
+    };
+
+    T_AI_ECMP_TUNER_ARM_STATS zeroStats = {0, 0, 0, 0, 0.0, 0.0, 0};
+    m_stats.assign(m_arms.size(), zeroStats);
+}
+
+void ParameterTuner::recordOutcome(double improvementPercent, WORD64 qwCpuMicros, WORD32 dwHwWrites) {
+    T_AI_ECMP_TUNER_ARM_STATS& stats = m_stats[m_activeArm];
+
+    // 单位代价收益：每折算毫秒带来的改进百分比
+    double reward = 0.0;
+    if (dwHwWrites > 0 && improvementPercent > 0) {
+        double costMs = static_cast<double>(qwCpuMicros) / 1000.0 + HW_WRITE_COST_MS * dwHwWrites;
+        double efficiency = improvementPercent / (costMs > 0 ? costMs : 1e-3);
+        reward = efficiency / (efficiency + 1.0);
+        stats.dwApplied++;
+        stats.improvementSum += improvementPercent;
+        stats.dwConsecutiveMisses = 0;
+    } else {
+        // 无收益：按CPU开销惩罚（以一次硬件写入的折算毫秒归一化到(-1,0]），同样无收益时更省CPU的参数组更优
+        double cpuMs = static_cast<double>(qwCpuMicros) / 1000.0;
+        reward = -cpuMs / (cpuMs + HW_WRITE_COST_MS);
+        stats.dwConsecutiveMisses++;
+    }
+
+    stats.dwPlays++;
+    stats.rewardSum += reward;
+    stats.qwCpuMicrosSum += qwCpuMicros;
+    m_dwTotalPlays++;
+
+    // 护栏：连续无收益的参数组暂停一段时间（默认组不暂停，保证始终有可用参数）
+    if (m_activeArm != 0 && stats.dwConsecutiveMisses >= MAX_CONSECUTIVE_MISSES) {
+        stats.dwSuspendRemaining = SUSPEND_PLAYS;
+        stats.dwConsecutiveMisses = 0;
+    }
+
+    for (auto& armStats : m_stats) {
+        if (armStats.dwSuspendRemaining > 0 && &armStats != &stats) {
+            armStats.dwSuspendRemaining--;
+        }
+    }
+
+    if (!m_bPinned) {
+        m_activeArm = selectNextArm();
+    }
+}
+
+bool ParameterTuner::pinArm(size_t armIndex) {
+    if (armIndex >= m_arms.size()) {
+        return false;
+    }
+    m_activeArm = armIndex;
+    m_bPinned = true;
+    return true;
+}
+
+void ParameterTuner::unpinArm() {
+    m_bPinned = false;
+    m_activeArm = selectNextArm();
+}
+
+size_t ParameterTuner::getMemoryFootprint() const {
+    return sizeof(*this)
+        + m_arms.capacity() * sizeof(T_AI_ECMP_TUNER_ARM)
+        + m_stats.capacity() * sizeof(T_AI_ECMP_TUNER_ARM_STATS);
+}
+
+size_t ParameterTuner::selectNextArm() {
+    // 先保证每个可用参数组至少被尝试一次
+    for (size_t i = 0; i < m_arms.size(); ++i) {
+        if (m_stats[i].dwPlays == 0 && m_stats[i].dwSuspendRemaining == 0) {
+            return i;
+        }
+    }
+
+    size_t bestArm = 0;
+    double bestValue = -std::numeric_limits<double>::infinity();
+    double logTotal = std::log(static_cast<double>(m_dwTotalPlays > 0 ? m_dwTotalPlays : 1));
+
+    for (size_t i = 0; i < m_arms.size(); ++i) {
+        const T_AI_ECMP_TUNER_ARM_STATS& stats = m_stats[i];
+        if (stats.dwSuspendRemaining > 0 || stats.dwPlays == 0) {
+            continue;
+        }
+        double mean = stats.rewardSum / stats.dwPlays;
+        double value = mean + UCB_EXPLORATION * std::sqrt(2.0 * logTotal / stats.dwPlays);
+        if (value > bestValue) {
+            bestValue = value;
+            bestArm = i;
+        }
+    }
+
+    return bestArm;
+}
+
+} // namespace ai_ecmp
@@ -0,0 +1,113 @@
+#ifndef AI_ECMP_TUNER_HPP
+#define AI_ECMP_TUNER_HPP
+
+#include <vector>
+#include "ai_ecmp_types.h"
+
+namespace ai_ecmp {
+
+/**
+ * 优化参数组（多臂老虎机的一个臂）
+ */
+typedef struct {
+    WORD32 dwMaxIterations;         /* 局部搜索最大迭代次数 */
+    double exchangeCostFactor;      /* 交换代价因子 */
+    double varianceThreshold;       /* 方差稳定阈值（旧判定方式的变异系数门限；加权判定方式下按与默认参数组的比值缩放SG的误差门限） */
+    double minImprovementPercent;   /* 下发所需的最小改进百分比 */
+} T_AI_ECMP_TUNER_ARM;
+
+/**
+ * 参数组的在线统计
+ */
+typedef struct {
+    WORD32 dwPlays;                 /* 被选用并产生结果的次数 */
+    WORD32 dwApplied;               /* 结果被下发到硬件的次数 */
+    WORD32 dwConsecutiveMisses;     /* 连续无收益次数 */
+    WORD32 dwSuspendRemaining;      /* 剩余暂停轮数（护栏） */
+    double rewardSum;               /* 累计奖励 */
+    double improvementSum;          /* 累计改进百分比（仅下发的结果） */
+    WORD64 qwCpuMicrosSum;          /* 累计算法CPU时间(微秒) */
+} T_AI_ECMP_TUNER_ARM_STATS;
+
+/**
+ * 每个ECMP实例的在线参数调优器（UCB1多臂老虎机）
+ * 奖励 = 改进百分比 / (算法CPU毫秒 + 每次硬件写入的折算毫秒)，再归一化到[0,1)；
+ * 无收益的尝试按CPU开销给出(-1,0]的负奖励
+ * 护栏：
+ * - 参数组来自预置的有界候选表，不会生成越界参数
+ * - 连续无收益的参数组被暂停若干轮
+ * - 支持通过诊断命令固定(pin)某个参数组
+ */
+class ParameterTuner {
+public:
+    ParameterTuner();
+
+    /**
+     * @brief 获取当前生效的参数组
+     */
+    const T_AI_ECMP_TUNER_ARM& getActiveArm() const { return m_arms[m_activeArm]; }
+
+    /**
+     * @brief 获取当前参数组对加权稳定性门限的缩放比例（当前参数组与默认参数组方差门限之比）
+     */
+    double getStabilityScale() const { return m_arms[m_activeArm].varianceThreshold / m_arms[0].varianceThreshold; }
+
+    /**
+     * @brief 获取当前生效的参数组下标
+     */
+    size_t getActiveArmIndex() const { return m_activeArm; }
+
+    /**
+     * @brief 记录一次优化尝试的结果，并选出下一次使用的参数组
+     * @param improvementPercent 改进百分比
+     * @param qwCpuMicros 算法消耗的CPU时间(微秒，含工作线程)
+     * @param dwHwWrites 产生的硬件写入次数（下发为1，未下发为0）
+     */
+    void recordOutcome(double improvementPercent, WORD64 qwCpuMicros, WORD32 dwHwWrites);
+
+    /**
+     * @brief 固定使用指定参数组
+     * @param armIndex 参数组下标
+     * @return 是否成功（下标越界返回false）
+     */
+    bool pinArm(size_t armIndex);
+
+    /**
+     * @brief 取消固定，恢复在线选择
+     */
+    void unpinArm();
+
+    bool isPinned() const { return m_bPinned; }
+    size_t getArmCount() const { return m_arms.size(); }
+    const T_AI_ECMP_TUNER_ARM& getArm(size_t armIndex) const { return m_arms[armIndex]; }
+    const T_AI_ECMP_TUNER_ARM_STATS& getArmStats(size_t armIndex) const { return m_stats[armIndex]; }
+    WORD32 getTotalPlays() const { return m_dwTotalPlays; }
+
+    /**
+     * @brief 获取调优器占用的内存字节数（含对象本身）
+     */
+    size_t getMemoryFootprint() const;
+
+private:
+    // 每次硬件写入折算的CPU毫秒数
+    static constexpr double HW_WRITE_COST_MS = 5.0;
+    // UCB探索系数
+    static constexpr double UCB_EXPLORATION = 0.5;
+    // 连续无收益多少次后暂停该参数组
+    static constexpr WORD32 MAX_CONSECUTIVE_MISSES = 4;
+    // 暂停轮数
+    static constexpr WORD32 SUSPEND_PLAYS = 16;
+
+    std::vector<T_AI_ECMP_TUNER_ARM> m_arms;
+    std::vector<T_AI_ECMP_TUNER_ARM_STATS> m_stats;
+    size_t m_activeArm;
+    WORD32 m_dwTotalPlays;
+    bool m_bPinned;
+
+    // UCB1选择下一个参数组
+    size_t selectNextArm();
+};
+
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_TUNER_HPP */
@@ -3,11 +3,14 @@
 #include "../core/ai_ecmp_instance.hpp"
 #include "../algorithms/ai_ecmp_local_search.hpp"
 #include "../algorithms/ai_ecmp_ga_imp.hpp"
+#include "../algorithms/ai_ecmp_portfolio.hpp"
 #include "../utils/ai_ecmp_metrics.hpp"
 #include "ai_ecmp_error.h"
 #include <memory>
 #include <vector>
 #include <random>
+#include <cstdio>
+#include <algorithm>
 #include <unordered_map> // Added for portItemCount
 
 
@@ -15,7 +18,11 @@
 static void printSingleInstanceConfig(WORD32 sgId, EcmpInstance* pInstance) {
     if (!pInstance) return;
     
-    const T_AI_ECMP_SG_CFG& cfg = pInstance->getSgConfig();
+    const T_AI_ECMP_SG_HDR& cfg = pInstance->getSgHeader();
+    const std::vector<WORD32>& portIds = pInstance->getPortIds();
+    const std::vector<WORD32>& portSpeeds = pInstance->getPortSpeeds();
+    const std::vector<WORD32>& portWeights = pInstance->getPortWeights();
+    const std::vector<WORD32>& memberTable = pInstance->getMemberTable();
     
     AI_DIAG_PRINTF("\n[DIAG] --- SG %u 配置详情 ---\n", sgId);
     AI_DIAG_PRINTF("[DIAG]   基本信息:\n");
@@ -37,18 +44,18 @@ static void printSingleInstanceConfig(WORD32 sgId, EcmpInstance* pInstance) {
               "序号", "端口ID", "速率(Mbps)", "权重");
     AI_DIAG_PRINTF("[DIAG]     %s\n", "----------------------------------------");
     
-    for (WORD32 i = 0; i < cfg.dwPortNum && i < FTM_LAG_MAX_MEM_NUM_15K; ++i) {
-        if (cfg.ports[i].dwPortId != 0) {  // 假设0表示无效端口
+    for (WORD32 i = 0; i < portIds.size(); ++i) {
+        if (portIds[i] != 0) {  // 假设0表示无效端口
             AI_DIAG_PRINTF("[DIAG]     %-8u %-12u %-12u %-8u\n",
-                      i, cfg.ports[i].dwPortId, cfg.ports[i].dwSpeed, cfg.ports[i].dwWeight);
+                      i, portIds[i], portSpeeds[i], portWeights[i]);
         }
     }
     
     // 打印逻辑成员分布统计
     AI_DIAG_PRINTF("\n[DIAG]   逻辑成员分布统计:\n");
     std::unordered_map<WORD32, WORD32> portItemCount;
-    for (WORD32 i = 0; i < cfg.dwItemNum && i < FTM_TRUNK_MAX_HASH_NUM_15K; ++i) {
-        WORD32 portId = cfg.items[i].dwPortId;
+    for (WORD32 i = 0; i < memberTable.size(); ++i) {
+        WORD32 portId = memberTable[i];
         if (portId != 0) {
             portItemCount[portId]++;
         }
@@ -161,6 +168,10 @@ static void printSingleInstanceOptimization(WORD32 sgId, EcmpInstance* pInstance
             AI_DIAG_PRINTF("[DIAG]   优化状态: 优化尝试失败\n");
             AI_DIAG_PRINTF("[DIAG]   优化效果: 无效 - 需要检查配置或流量特征\n");
             break;
+        case AI_ECMP_SHRINK:
+            AI_DIAG_PRINTF("[DIAG]   优化状态: 刚完成一次缩容操作\n");
+            AI_DIAG_PRINTF("[DIAG]   优化效果: 缩容 - 回收了多余的逻辑链路\n");
+            break;
         default:
             AI_DIAG_PRINTF("[DIAG]   优化状态: 未知状态 (%d)\n", status);
             break;
@@ -173,7 +184,8 @@ extern "C" {
 // 算法类型枚举
 enum AI_ECMP_ALGORITHM_TYPE {
     AI_ECMP_ALGO_LOCAL_SEARCH = 1,
-    AI_ECMP_ALGO_GA_IMP = 2
+    AI_ECMP_ALGO_GA_IMP = 2,
+    AI_ECMP_ALGO_PORTFOLIO = 3
 };
 
 // 诊断函数：启用ECMP智能优化算法
@@ -195,7 +207,8 @@ VOID diagAiEcmpEnableAlgorithm(WORD32 dwSgId) {
         AI_DIAG_PRINTF("[DIAG] 已对 %u 个实例启用优化算法\n", dwEnabledCount);
     } else {
         AI_DIAG_PRINTF("[DIAG] 对SG %u 启用优化算法\n", dwSgId);
-        EcmpInstance* pInstance = manager.getInstance(dwSgId);
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
         if (pInstance) {
             pInstance->enableOptimization();
             dwEnabledCount = 1;
@@ -229,7 +242,8 @@ VOID diagAiEcmpDisableAlgorithm(WORD32 dwSgId) {
         AI_DIAG_PRINTF("[DIAG] 已对 %u 个实例禁用优化算法\n", dwDisabledCount);
     } else {
         AI_DIAG_PRINTF("[DIAG] 对SG %u 禁用优化算法\n", dwSgId);
-        EcmpInstance* pInstance = manager.getInstance(dwSgId);
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
         if (pInstance) {
             pInstance->disableOptimization();
             dwDisabledCount = 1;
@@ -271,7 +285,8 @@ VOID diagAiEcmpPrintSgConfig(WORD32 dwSgId) {
         });
     } else {
         AI_DIAG_PRINTF("[DIAG] 打印SG %u 的配置信息\n", dwSgId);
-        EcmpInstance* pInstance = manager.getInstance(dwSgId);
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
         if (pInstance) {
             printSingleInstanceConfig(dwSgId, pInstance);
         } else {
@@ -309,7 +324,8 @@ VOID diagAiEcmpPrintBalanceStatus(WORD32 dwSgId) {
         });
     } else {
         AI_DIAG_PRINTF("[DIAG] 打印SG %u 的平衡状态\n", dwSgId);
-        EcmpInstance* pInstance = manager.getInstance(dwSgId);
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
         if (pInstance) {
             printSingleInstanceBalance(dwSgId, pInstance);
         } else {
@@ -348,7 +364,8 @@ VOID diagAiEcmpPrintOptimizationEffect(WORD32 dwSgId) {
         });
     } else {
         AI_DIAG_PRINTF("[DIAG] 打印SG %u 的优化效果\n", dwSgId);
-        EcmpInstance* pInstance = manager.getInstance(dwSgId);
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
         if (pInstance) {
             printSingleInstanceOptimization(dwSgId, pInstance);
         } else {
@@ -366,35 +383,40 @@ VOID diagAiEcmpPrintInstanceStatus() {
     AI_DIAG_PRINTF("[DIAG] ECMP实例状态概览\n");
     AI_DIAG_PRINTF("[DIAG] ============================================================\n");
     
-    auto& manager = CAISlbManagerSingleton::getManagerInstance();
-    WORD32 dwInstanceCount = manager.getInstanceCount();
+    // 读取状态发布板，不加锁，不会阻塞优化路径
+    std::vector<T_AI_ECMP_INSTANCE_STATUS> instances;
+    WORD64 qwVersion = CAISlbManagerSingleton::getManagerInstance().getStatusBoard().copyTo(instances);
     
-    AI_DIAG_PRINTF("[DIAG] 实例总数: %u\n", dwInstanceCount);
+    AI_DIAG_PRINTF("[DIAG] 实例总数: %zu（发布版本: %llu）\n", instances.size(), qwVersion);
     
-    if (dwInstanceCount == 0) {
+    if (instances.empty()) {
         AI_DIAG_PRINTF("[DIAG] 当前没有ECMP实例\n");
         AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
         return;
     }
     
-    AI_DIAG_PRINTF("[DIAG] %-10s %-15s %-10s %-10s %-15s %-15s %-15s\n", 
-              "SG ID", "状态", "周期数", "端口数", "逻辑成员数", "优化状态", "禁用周期数");
+    // 发布板中的记录按插入顺序排列，打印前按SG ID排序
+    std::sort(instances.begin(), instances.end(),
+              [](const T_AI_ECMP_INSTANCE_STATUS& left, const T_AI_ECMP_INSTANCE_STATUS& right) {
+                  return left.dwSgId < right.dwSgId;
+              });
+    
+    AI_DIAG_PRINTF("[DIAG] %-10s %-15s %-10s %-10s %-15s %-15s %-15s %-10s %-10s %-12s %-10s\n", 
+              "SG ID", "状态", "周期数", "端口数", "逻辑成员数", "优化状态", "禁用周期数", "平均差距",
+              "连续失败", "优化耗时(us)", "待确认");
     AI_DIAG_PRINTF("[DIAG] %s\n", 
-              "-------------------------------------------------------------------------------------------");
+              "---------------------------------------------------------------------------------------------------------------------------------------");
     
-    // 遍历所有实例并打印状态信息
-    manager.forEachInstance([](WORD32 sgId, EcmpInstance* pInstance) {
-        if (pInstance) {
-            const T_AI_ECMP_SG_CFG& cfg = pInstance->getSgConfig();  // 需要在EcmpInstance中添加此方法
-            const char* statusStr = utils::aiEcmpStatusToString(pInstance->getStatus());
-            const char* optStateStr = pInstance->isOptimizationEnabled() ? "启用" : "禁用";
-            WORD32 disabledCycles = pInstance->isOptimizationEnabled() ? 0 : pInstance->getDisabledCycles();
-            
-            AI_DIAG_PRINTF("[DIAG] %-10u %-15s %-10u %-10u %-15u %-15s %-15u\n",
-                      sgId, statusStr, pInstance->getCycle(),  // 需要在EcmpInstance中添加getCycle()方法
-                      cfg.dwPortNum, cfg.dwItemNum, optStateStr, disabledCycles);
+    for (const T_AI_ECMP_INSTANCE_STATUS& status : instances) {
+        char szPending[16] = "-";
+        if (status.dwPending) {
+            snprintf(szPending, sizeof(szPending), "%u", status.dwPendingSeqId);
         }
-    });
+        AI_DIAG_PRINTF("[DIAG] %-10u %-15s %-10u %-10u %-15u %-15s %-15u %-10.4f %-10u %-12u %-10s\n",
+                  status.dwSgId, utils::aiEcmpStatusToString(static_cast<T_AI_ECMP_STATUS>(status.dwStatus)),
+                  status.dwCycle, status.dwPortNum, status.dwItemNum, status.dwOptEnabled ? "启用" : "禁用",
+                  status.dwDisabledCycles, status.avgGap, status.dwFailures, status.dwLastOptMicros, szPending);
+    }
     
     AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
 }
@@ -435,7 +457,11 @@ VOID diagAiEcmpSetAlgorithm(WORD32 dwSgId, WORD32 dwAlgorithmType) {
             pszAlgoName = "局部搜索(LocalSearch)";
             break;
         case AI_ECMP_ALGO_GA_IMP:
-            pszAlgoName = "改进遗传算法(GA_IMP)";
+            // 遗传算法实现基于旧的算法接口，未接入优化流程
+            AI_DIAG_PRINTF("[DIAG] 错误：改进遗传算法(GA_IMP)未接入优化流程，不支持设置\n");
+            return;
+        case AI_ECMP_ALGO_PORTFOLIO:
+            pszAlgoName = "组合竞速(Portfolio)";
             break;
         default:
             AI_DIAG_PRINTF("[DIAG] 错误：不支持的算法类型 %u\n", dwAlgorithmType);
@@ -445,9 +471,891 @@ VOID diagAiEcmpSetAlgorithm(WORD32 dwSgId, WORD32 dwAlgorithmType) {
     
     AI_DIAG_PRINTF("[DIAG] 设置算法为: %s\n", pszAlgoName);
     
-    // TODO: 实现算法设置逻辑
+    auto createAlgorithm = [dwAlgorithmType]() -> std::unique_ptr<AlgorithmBase> {
+        if (dwAlgorithmType == AI_ECMP_ALGO_PORTFOLIO) {
+            return std::unique_ptr<AlgorithmBase>(PortfolioOptimizer::createDefault().release());
+        }
+        return std::unique_ptr<AlgorithmBase>(new LocalSearch(10000, 0.1));
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    WORD32 dwSetCount = 0;
+    
+    if (dwSgId == 0) {
+        manager.forEachInstance([&dwSetCount, &createAlgorithm](WORD32 sgId, EcmpInstance* pInstance) {
+            if (pInstance) {
+                pInstance->setAlgorithm(createAlgorithm());
+                dwSetCount++;
+            }
+        });
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            pInstance->setAlgorithm(createAlgorithm());
+            dwSetCount = 1;
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+            dwResult = AI_ECMP_ERR_NOT_FOUND;
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 算法类型设置完成，结果: 0x%x，影响实例数: %u\n", dwResult, dwSetCount);
+}
+
+// 诊断函数：打印组合优化器的算法胜出统计
+VOID diagAiEcmpPrintPortfolioStats(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印组合优化器胜出统计，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printStats = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        PortfolioOptimizer* pPortfolio = dynamic_cast<PortfolioOptimizer*>(pInstance->getAlgorithm());
+        if (!pPortfolio) {
+            AI_DIAG_PRINTF("[DIAG] SG %u: 未使用组合优化器\n", sgId);
+            return;
+        }
+        
+        AI_DIAG_PRINTF("[DIAG] SG %u: 竞速次数: %u, 截止时间: %u ms, 最近胜出: %s\n",
+                  sgId, pPortfolio->getRaceCount(), pPortfolio->getDeadlineMs(), pPortfolio->getLastWinnerName());
+        AI_DIAG_PRINTF("[DIAG]     %-16s %-10s %-10s %-10s %-15s\n", "算法", "参赛次数", "胜出次数", "胜率", "平均CPU(us)");
+        for (const auto& stats : pPortfolio->getMemberStats()) {
+            double winRate = stats.dwRaces > 0 ? (double)stats.dwWins / stats.dwRaces * 100.0 : 0.0;
+            WORD64 avgMicros = stats.dwRaces > 0 ? stats.qwTotalMicros / stats.dwRaces : 0;
+            AI_DIAG_PRINTF("[DIAG]     %-16s %-10u %-10u %-9.1f%% %-15llu\n",
+                      stats.pszName, stats.dwRaces, stats.dwWins, winRate, avgMicros);
+        }
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printStats);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printStats(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：打印在线参数调优器的各参数组统计
+VOID diagAiEcmpPrintTuner(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印在线参数调优器，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printTuner = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const ParameterTuner& tuner = pInstance->getTuner();
+        
+        AI_DIAG_PRINTF("[DIAG] SG %u: 当前参数组: #%zu%s, 总尝试次数: %u\n",
+                  sgId, tuner.getActiveArmIndex(), tuner.isPinned() ? " (已固定)" : "", tuner.getTotalPlays());
+        if (pInstance->getStabilityGate().getConfig().eMode == AI_ECMP_STABILITY_WEIGHTED) {
+            AI_DIAG_PRINTF("[DIAG]     加权稳定性判定：SG误差门限按方差门限与默认参数组之比缩放，当前 x%.2f\n",
+                      tuner.getStabilityScale());
+        }
+        AI_DIAG_PRINTF("[DIAG]     %-4s %-8s %-8s %-8s %-8s %-8s %-8s %-10s %-10s %-12s %-8s\n",
+                  "臂", "迭代", "交换成本", "方差门限", "改进门限", "尝试", "下发", "平均奖励", "平均改进%", "平均CPU(us)", "暂停");
+        for (size_t i = 0; i < tuner.getArmCount(); ++i) {
+            const T_AI_ECMP_TUNER_ARM& arm = tuner.getArm(i);
+            const T_AI_ECMP_TUNER_ARM_STATS& stats = tuner.getArmStats(i);
+            double avgReward = stats.dwPlays > 0 ? stats.rewardSum / stats.dwPlays : 0.0;
+            double avgImprovement = stats.dwApplied > 0 ? stats.improvementSum / stats.dwApplied : 0.0;
+            WORD64 avgMicros = stats.dwPlays > 0 ? stats.qwCpuMicrosSum / stats.dwPlays : 0;
+            AI_DIAG_PRINTF("[DIAG]   %s#%-3zu %-8u %-8.3f %-8.3f %-8.2f %-8u %-8u %-10.4f %-10.2f %-12llu %-8u\n",
+                      i == tuner.getActiveArmIndex() ? "*" : " ", i,
+                      arm.dwMaxIterations, arm.exchangeCostFactor, arm.varianceThreshold, arm.minImprovementPercent,
+                      stats.dwPlays, stats.dwApplied, avgReward, avgImprovement, avgMicros, stats.dwSuspendRemaining);
+        }
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printTuner);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printTuner(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：固定或取消固定在线调优器的参数组
+VOID diagAiEcmpPinTunerArm(WORD32 dwSgId, WORD32 dwArmIndex) {
+    const WORD32 dwUnpin = 0xFFFFFFFF;
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：%s调优参数组，SG ID: %u, 参数组: %u\n",
+              dwArmIndex == dwUnpin ? "取消固定" : "固定", dwSgId, dwArmIndex);
+    
+    WORD32 dwResult = AI_SUCCESS;
+    WORD32 dwAffected = 0;
+    
+    auto applyPin = [dwArmIndex, dwUnpin, &dwResult, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        ParameterTuner& tuner = pInstance->getTuner();
+        if (dwArmIndex == dwUnpin) {
+            tuner.unpinArm();
+            dwAffected++;
+        } else if (tuner.pinArm(dwArmIndex)) {
+            dwAffected++;
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：SG %u 参数组下标 %u 越界（共 %zu 组）\n", sgId, dwArmIndex, tuner.getArmCount());
+            dwResult = AI_ECMP_ERR_INVALID_PARAM;
+        }
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyPin);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyPin(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+            dwResult = AI_ECMP_ERR_NOT_FOUND;
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 调优参数组设置完成，结果: 0x%x，影响实例数: %u\n", dwResult, dwAffected);
+}
+
+// 诊断函数：打印优化解缓存的命中统计
+VOID diagAiEcmpPrintSolutionCache(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印优化解缓存，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printCache = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const SolutionCache& cache = pInstance->getSolutionCache();
+        WORD32 dwLookups = cache.getHits() + cache.getMisses();
+        AI_DIAG_PRINTF("[DIAG] SG %u: 缓存条目: %zu, 命中: %u, 未命中: %u, 命中率: %.2f%%\n",
+                  sgId, cache.size(), cache.getHits(), cache.getMisses(),
+                  dwLookups > 0 ? 100.0 * cache.getHits() / dwLookups : 0.0);
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printCache);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printCache(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置负载模型
+VOID diagAiEcmpSetLoadModel(WORD32 dwSgId, WORD32 dwModelType, WORD32 dwParam) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置负载模型，SG ID: %u, 模型: %u, 参数: %u\n", dwSgId, dwModelType, dwParam);
+    
+    if (dwModelType > AI_ECMP_LOAD_MODEL_PEAK_HOLD) {
+        AI_DIAG_PRINTF("[DIAG] 错误：无效的模型类型 %u（0=原始累计, 1=EWMA, 2=滑动窗口, 3=峰值保持）\n", dwModelType);
+        return;
+    }
+    
+    T_AI_ECMP_LOAD_MODEL_CFG cfg = {static_cast<T_AI_ECMP_LOAD_MODEL_TYPE>(dwModelType), 3.0, 8};
+    if (dwParam > 0) {
+        if (cfg.eType == AI_ECMP_LOAD_MODEL_WINDOW) {
+            cfg.dwWindowCycles = dwParam;
+        } else {
+            cfg.halfLifeCycles = static_cast<double>(dwParam);
+        }
+    }
+    
+    WORD32 dwAffected = 0;
+    auto applyModel = [&cfg, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setLoadModel(cfg);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyModel);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyModel(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 负载模型设置完成，模型: %s，影响实例数: %u\n", LoadModel::typeToString(cfg.eType), dwAffected);
+}
+
+// 诊断函数：启用或禁用优化报告打印
+VOID diagAiEcmpSetReport(WORD32 dwSgId, WORD32 dwEnable) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：%s优化报告，SG ID: %u\n", dwEnable ? "启用" : "禁用", dwSgId);
+    
+    WORD32 dwAffected = 0;
+    auto applyReport = [dwEnable, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setReportEnabled(dwEnable != 0);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyReport);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyReport(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 优化报告设置完成，影响实例数: %u\n", dwAffected);
+}
+
+// 诊断函数：打印实例内存占用
+VOID diagAiEcmpPrintMemoryUsage(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印实例内存占用，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId != 0) {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            AI_DIAG_PRINTF("[DIAG] SG %u: 逻辑成员数: %zu, 端口数: %zu, 内存占用: %zu 字节\n",
+                      dwSgId, pInstance->getMemberTable().size(), pInstance->getPortIds().size(),
+                      pInstance->getMemoryFootprint());
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    } else {
+        size_t totalBytes = 0;
+        size_t maxBytes = 0;
+        WORD32 dwCount = 0;
+        manager.forEachInstance([&totalBytes, &maxBytes, &dwCount](WORD32 sgId, EcmpInstance* pInstance) {
+            if (!pInstance) return;
+            size_t bytes = pInstance->getMemoryFootprint();
+            totalBytes += bytes;
+            maxBytes = std::max(maxBytes, bytes);
+            dwCount++;
+        });
+        AI_DIAG_PRINTF("[DIAG] 实例数: %u, 总内存: %zu 字节, 平均每实例: %zu 字节, 最大: %zu 字节\n",
+                  dwCount, totalBytes, dwCount > 0 ? totalBytes / dwCount : 0, maxBytes);
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置负载预测
+VOID diagAiEcmpSetForecast(WORD32 dwSgId, WORD32 dwForecastType, WORD32 dwSeasonCycles) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置负载预测，SG ID: %u, 类型: %u, 季节: %u\n", dwSgId, dwForecastType, dwSeasonCycles);
+    
+    if (dwForecastType > AI_ECMP_FORECAST_HOLT_WINTERS) {
+        AI_DIAG_PRINTF("[DIAG] 错误：无效的预测类型 %u（0=不预测, 1=Holt, 2=Holt-Winters）\n", dwForecastType);
+        return;
+    }
+    
+    T_AI_ECMP_FORECAST_CFG cfg = {static_cast<T_AI_ECMP_FORECAST_TYPE>(dwForecastType), 0.5, 0.2, 0.3, dwSeasonCycles};
+    
+    WORD32 dwAffected = 0;
+    auto applyForecast = [&cfg, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setForecaster(cfg);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyForecast);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyForecast(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 负载预测设置完成，影响实例数: %u\n", dwAffected);
+}
+
+// 诊断函数：打印负载预测状态及误差
+VOID diagAiEcmpPrintForecast(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印负载预测，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printForecast = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const LoadForecaster& forecaster = pInstance->getForecaster();
+        const T_AI_ECMP_FORECAST_CFG& cfg = forecaster.getConfig();
+        const T_AI_ECMP_FORECAST_ERROR& err = forecaster.getError();
+        AI_DIAG_PRINTF("[DIAG] SG %u: 类型: %s, alpha: %.2f, beta: %.2f, gamma: %.2f, 季节: %u 周期, 样本数: %u, %s\n",
+                  sgId, LoadForecaster::typeToString(cfg.eType), cfg.alpha, cfg.beta, cfg.gamma,
+                  cfg.dwSeasonCycles, forecaster.getSampleCount(),
+                  forecaster.isReady() ? "已就绪（优化器使用预测值）" : "未就绪（优化器使用负载模型估计）");
+        AI_DIAG_PRINTF("[DIAG]   预测误差: 评估次数: %u, 最近WAPE: %.2f%%, 平均WAPE: %.2f%%, 平均偏差: %+.2f%%\n",
+                  err.dwSamples, err.lastWape * 100.0, err.avgWape * 100.0, err.avgBias * 100.0);
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printForecast);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printForecast(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置大流桶检测
+VOID diagAiEcmpSetElephant(WORD32 dwSgId, WORD32 dwEnable, WORD32 dwEnterPercent, WORD32 dwExitPercent) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置大流桶检测，SG ID: %u, 启用: %u, 进入门限: %u%%, 退出门限: %u%%\n", 
+              dwSgId, dwEnable, dwEnterPercent, dwExitPercent);
+    
+    T_AI_ECMP_ELEPHANT_CFG cfg = {dwEnable != 0, 0.5, 0.3};
+    if (dwEnterPercent > 0) {
+        cfg.enterShare = dwEnterPercent / 100.0;
+    }
+    if (dwExitPercent > 0) {
+        cfg.exitShare = dwExitPercent / 100.0;
+    }
+    
+    WORD32 dwAffected = 0;
+    auto applyElephant = [&cfg, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setElephantConfig(cfg);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyElephant);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyElephant(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 大流桶检测设置完成，影响实例数: %u\n", dwAffected);
+}
+
+// 诊断函数：打印大流桶集合
+VOID diagAiEcmpPrintElephants(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印大流桶，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printElephants = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const ElephantDetector& detector = pInstance->getElephantDetector();
+        const T_AI_ECMP_ELEPHANT_CFG& cfg = detector.getConfig();
+        const std::vector<WORD32>& elephants = detector.getElephants();
+        AI_DIAG_PRINTF("[DIAG] SG %u: 检测%s（进入: %.0f%%, 退出: %.0f%% 端口平均负载），大流桶数: %zu，占总负载: %.2f%%\n",
+                  sgId, cfg.bEnable ? "启用" : "禁用", cfg.enterShare * 100.0, cfg.exitShare * 100.0,
+                  elephants.size(), detector.getTotalShare() * 100.0);
+        
+        const std::vector<WORD32>& memberTable = pInstance->getMemberTable();
+        for (WORD32 dwIndex : elephants) {
+            AI_DIAG_PRINTF("[DIAG]   hash_index %u -> 端口 %u\n", dwIndex,
+                      dwIndex < memberTable.size() ? memberTable[dwIndex] : 0);
+        }
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printElephants);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printElephants(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：模拟端口故障
+VOID diagAiEcmpPortDown(WORD32 dwPortId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：模拟端口故障，端口 ID: %u\n", dwPortId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    WORD32 dwResult = manager.handlePortDown(dwPortId);
+    
+    manager.forEachInstance([](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance || pInstance->getStatus() != AI_ECMP_ADJUST) return;
+        AI_DIAG_PRINTF("[DIAG] SG %u: 本次迁移 %zu 个桶\n", sgId, pInstance->getLastMemberChanges().size());
+    });
+    
+    AI_DIAG_PRINTF("[DIAG] 故障切换结果: 0x%x\n", dwResult);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：开始或取消端口排空
+VOID diagAiEcmpDrainPort(WORD32 dwPortId, WORD32 dwEnable, WORD32 dwStepPercent, WORD32 dwCapPercent, WORD32 dwCapOverride) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：%s端口排空，端口 ID: %u\n", dwEnable ? "开始" : "取消", dwPortId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    WORD32 dwResult;
+    if (dwEnable) {
+        double stepShare = dwStepPercent ? dwStepPercent / 100.0 : EcmpInstance::DRAIN_DEFAULT_STEP_SHARE;
+        double utilCap = dwCapPercent ? dwCapPercent / 100.0 : EcmpInstance::DRAIN_DEFAULT_UTIL_CAP;
+        dwResult = manager.startPortDrain(dwPortId, stepShare, utilCap, dwCapOverride != 0);
+    } else {
+        dwResult = manager.stopPortDrain(dwPortId);
+    }
+    
+    if (dwResult == AI_SUCCESS) {
+        AI_DIAG_PRINTF("[DIAG] 操作成功，排空在后续优化周期中分步进行\n");
+    } else {
+        AI_DIAG_PRINTF("[DIAG] 错误：没有实例%s端口 %u（结果: %u）\n", dwEnable ? "可排空" : "正在排空", dwPortId, dwResult);
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：打印端口排空进度
+VOID diagAiEcmpPrintDrain(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印端口排空进度，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printDrain = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const T_AI_ECMP_DRAIN_STATE& drain = pInstance->getDrainState();
+        if (!drain.bActive && !drain.bCompleted) {
+            AI_DIAG_PRINTF("[DIAG] SG %u: 没有端口排空\n", sgId);
+            return;
+        }
+        AI_DIAG_PRINTF("[DIAG] SG %u: 端口 %u %s，已完成 %u 步，进度 %u/%u 桶，剩余负载 %llu/%llu\n",
+                  sgId, drain.dwPortId, drain.bActive ? "排空中" : "已排空", drain.dwSteps,
+                  drain.dwStartBuckets - drain.dwRemainBuckets, drain.dwStartBuckets,
+                  drain.qwRemainLoad, drain.qwStartLoad);
+        AI_DIAG_PRINTF("[DIAG]   每步上限: %.0f%%，利用率上限: %.2f倍平均（%s），%s，连续停滞周期: %u，停滞期间再均衡: %u 次\n",
+                  drain.stepShare * 100.0, drain.utilCap, drain.bCapOverride ? "停滞时允许超出" : "硬约束",
+                  drain.dwStalledCycles > 0 ? "停滞中" : "正常推进", drain.dwStalledCycles, drain.dwRebalances);
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printDrain);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printDrain(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置稳定性判定
+VOID diagAiEcmpSetStability(WORD32 dwSgId, WORD32 dwMode, WORD32 dwErrorPercent, WORD32 dwMinSharePercent) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置稳定性判定，SG ID: %u, 方式: %u, 门限: %u%%, 显著桶下限: %u%%\n", 
+              dwSgId, dwMode, dwErrorPercent, dwMinSharePercent);
+    
+    if (dwMode > AI_ECMP_STABILITY_WEIGHTED) {
+        AI_DIAG_PRINTF("[DIAG] 错误：无效的判定方式 %u（0=旧方式, 1=按流量加权）\n", dwMode);
+        return;
+    }
+    
+    T_AI_ECMP_STABILITY_CFG cfg = {static_cast<T_AI_ECMP_STABILITY_MODE>(dwMode),
+                                   dwErrorPercent ? dwErrorPercent / 100.0 : 0.15,
+                                   dwMinSharePercent ? dwMinSharePercent / 100.0 : 0.1,
+                                   8.0};
+    
+    WORD32 dwAffected = 0;
+    auto applyStability = [&cfg, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setStabilityConfig(cfg);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyStability);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyStability(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 稳定性判定设置完成，影响实例数: %u\n", dwAffected);
+}
+
+// 诊断函数：打印稳定性判定配置及最近一次判定结果
+VOID diagAiEcmpPrintStability(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印稳定性判定，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printStability = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const StabilityGate& gate = pInstance->getStabilityGate();
+        const T_AI_ECMP_STABILITY_CFG& cfg = gate.getConfig();
+        const T_AI_ECMP_STABILITY_RESULT& result = gate.getLastResult();
+        AI_DIAG_PRINTF("[DIAG] SG %u: 方式: %s, 门限: %.3f（加权方式下按调优器参数组缩放）, 显著桶下限: %.2f 倍桶平均负载, 半衰期: %.1f 周期, 样本数: %u\n",
+                  sgId, StabilityGate::modeToString(cfg.eMode), cfg.errorThreshold, cfg.minBucketShare,
+                  cfg.halfLifeCycles, gate.getSampleCount());
+        if (cfg.eMode == AI_ECMP_STABILITY_WEIGHTED) {
+            AI_DIAG_PRINTF("[DIAG]   最近判定: 加权变异系数 %.6f，估计相对误差 %.6f（门限 %.6f），显著桶 %u 个占负载 %.2f%%，%s\n",
+                      result.weightedCv, result.estimateError, result.threshold, result.dwMaterialBuckets,
+                      result.materialShare * 100.0, result.bStable ? "稳定" : "不稳定");
+        }
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printStability);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printStability(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置优化效果显著性检验
+VOID diagAiEcmpSetSignificance(WORD32 dwSgId, WORD32 dwEnable, WORD32 dwConfidencePercent, WORD32 dwMinSamples) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置优化效果显著性检验，SG ID: %u, 启用: %u, 置信度: %u%%, 最少样本: %u\n", 
+              dwSgId, dwEnable, dwConfidencePercent, dwMinSamples);
+    
+    T_AI_ECMP_SIGNIFICANCE_CFG cfg = {dwEnable != 0,
+                                      dwConfidencePercent ? dwConfidencePercent / 100.0 : 0.90,
+                                      dwMinSamples ? dwMinSamples : 3};
+    
+    WORD32 dwAffected = 0;
+    auto applySignificance = [&cfg, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setSignificanceConfig(cfg);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applySignificance);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applySignificance(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] 显著性检验设置完成，影响实例数: %u\n", dwAffected);
+}
+
+// 诊断函数：打印显著性检验配置及最近一次检验结果
+VOID diagAiEcmpPrintSignificance(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印优化效果显著性检验，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto printSignificance = [](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const ImprovementTest& test = pInstance->getImprovementTest();
+        const T_AI_ECMP_SIGNIFICANCE_CFG& cfg = test.getConfig();
+        const T_AI_ECMP_SIGNIFICANCE_RESULT& result = test.getLastResult();
+        AI_DIAG_PRINTF("[DIAG] SG %u: %s, 置信度: %.2f, 最少样本: %u\n",
+                  sgId, cfg.bEnable ? "启用" : "禁用", cfg.confidence, cfg.dwMinSamples);
+        if (result.bTested) {
+            AI_DIAG_PRINTF("[DIAG]   最近检验: 样本 %u，平均总偏差 %.6f -> %.6f（改进 %.2f%%），t %.3f（临界值 %.3f），%s\n",
+                      result.dwSamples, result.meanGapBefore, result.meanGapAfter, result.meanImprovement,
+                      result.tStat, result.tCritical, result.bSignificant ? "显著" : "不显著");
+        } else {
+            AI_DIAG_PRINTF("[DIAG]   最近一次评估未做检验（样本数: %u）\n", result.dwSamples);
+        }
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printSignificance);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printSignificance(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置优化周期调度
+VOID diagAiEcmpSetScheduler(WORD32 dwBudgetMicros, WORD32 dwAgingPercent) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置优化周期调度，CPU预算: %u us, 老化系数: %u%%\n", 
+              dwBudgetMicros, dwAgingPercent);
+    
+    T_AI_ECMP_SCHED_CFG cfg = {dwBudgetMicros, dwAgingPercent / 100.0};
+    LockedRef<CycleScheduler> schedulerRef = CAISlbManagerSingleton::getManagerInstance().getScheduler();
+    CycleScheduler& scheduler = *schedulerRef;
+    scheduler.configure(cfg);
+    
+    AI_DIAG_PRINTF("[DIAG] 优化周期调度设置完成（预算: %u us%s, 老化系数: %.2f）\n",
+              scheduler.getConfig().dwBudgetMicros, scheduler.getConfig().dwBudgetMicros ? "" : "（不限制）",
+              scheduler.getConfig().agingFactor);
+}
+
+// 诊断函数：打印优化周期调度状态
+VOID diagAiEcmpPrintScheduler(WORD32 dwTopNum) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印优化周期调度状态\n");
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    LockedRef<CycleScheduler> schedulerRef = CAISlbManagerSingleton::getManagerInstance().getScheduler();
+    const CycleScheduler& scheduler = *schedulerRef;
+    const T_AI_ECMP_SCHED_CFG& cfg = scheduler.getConfig();
+    const T_AI_ECMP_SCHED_STATS& stats = scheduler.getStats();
+    AI_DIAG_PRINTF("[DIAG] CPU预算: %u us%s, 老化系数: %.2f, 调度周期: %u, 超出预算周期: %u\n",
+              cfg.dwBudgetMicros, cfg.dwBudgetMicros ? "" : "（不限制）", cfg.agingFactor,
+              stats.dwCycles, stats.dwOverruns);
+    AI_DIAG_PRINTF("[DIAG] 最近周期: 执行 %u 个, 推迟 %u 个（最长连续推迟 %u 周期）, 耗时 %llu us\n",
+              stats.dwScheduled, stats.dwDeferred, stats.dwMaxDeferredCycles, stats.qwSpentMicros);
+    
+    // 按优先级顺序打印参与最近周期调度的前N个SG，0表示全部
+    AI_DIAG_PRINTF("[DIAG] 调度条目: %zu 个, 参与最近周期调度: %zu 个\n",
+              scheduler.getEntryCount(), scheduler.getActiveCount());
+    size_t entryNum = scheduler.getActiveCount();
+    if (dwTopNum > 0 && dwTopNum < entryNum) {
+        entryNum = dwTopNum;
+    }
+    for (size_t i = 0; i < entryNum; ++i) {
+        const T_AI_ECMP_SCHED_ENTRY& entry = scheduler.getEntry(i);
+        AI_DIAG_PRINTF("[DIAG]   #%zu SG %u: 收益 %.1f, 优先级 %.1f, 耗时估计 %.1f us, 连续推迟 %u 周期, %s%s\n",
+                  i + 1, entry.dwSgId, entry.benefit, entry.priority, entry.costMicros, entry.dwDeferredCycles,
+                  entry.bScheduled ? "已执行" : "已推迟",
+                  entry.bUrgent ? "（必须执行）" : "");
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置实例处理相位数
+VOID diagAiEcmpSetPhases(WORD32 dwPhaseNum) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置实例处理相位数: %u\n", dwPhaseNum);
+    
+    LockedRef<PhasePlanner> plannerRef = CAISlbManagerSingleton::getManagerInstance().getPhasePlanner();
+    PhasePlanner& planner = *plannerRef;
+    planner.configure(dwPhaseNum ? dwPhaseNum : PhasePlanner::DEFAULT_PHASE_NUM);
+    planner.clearTickLatency();
+    
+    AI_DIAG_PRINTF("[DIAG] 相位数设置完成: %u（每个实例每 %u 个定时器节拍处理一次），节拍耗时统计已清空\n",
+              planner.getPhaseNum(), planner.getPhaseNum());
+}
+
+// 诊断函数：打印各相位的实例分布及节拍耗时直方图
+VOID diagAiEcmpPrintPhases() {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印实例处理相位\n");
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    LockedRef<PhasePlanner> plannerRef = CAISlbManagerSingleton::getManagerInstance().getPhasePlanner();
+    const PhasePlanner& planner = *plannerRef;
+    AI_DIAG_PRINTF("[DIAG] 相位数: %u, 已推进节拍: %llu\n", planner.getPhaseNum(), planner.getTickCount());
+    for (WORD32 dwPhase = 0; dwPhase < planner.getPhaseNum(); ++dwPhase) {
+        AI_DIAG_PRINTF("[DIAG]   相位 %2u: 实例 %zu 个, 权重 %llu, 最近节拍耗时 %llu us\n",
+                  dwPhase, planner.getPhaseSgs(dwPhase).size(), planner.getPhaseWeight(dwPhase),
+                  planner.getPhaseLastMicros(dwPhase));
+    }
+    
+    const T_AI_ECMP_LATENCY_HIST& hist = planner.getTickLatency();
+    AI_DIAG_PRINTF("[DIAG] 节拍耗时: 样本 %llu, 平均 %.1f us, 最大 %llu us\n",
+              hist.qwSamples, hist.qwSamples ? static_cast<double>(hist.qwTotalMicros) / hist.qwSamples : 0.0,
+              hist.qwMaxMicros);
+    for (WORD32 dwBucket = 0; dwBucket < AI_ECMP_LATENCY_BUCKET_NUM; ++dwBucket) {
+        if (hist.adwBuckets[dwBucket] == 0) {
+            continue;
+        }
+        if (dwBucket == 0) {
+            AI_DIAG_PRINTF("[DIAG]   [0, 1) us: %u\n", hist.adwBuckets[dwBucket]);
+        } else if (dwBucket + 1 == AI_ECMP_LATENCY_BUCKET_NUM) {
+            AI_DIAG_PRINTF("[DIAG]   [%u, +) us: %u\n", 1u << (dwBucket - 1), hist.adwBuckets[dwBucket]);
+        } else {
+            AI_DIAG_PRINTF("[DIAG]   [%u, %u) us: %u\n", 1u << (dwBucket - 1), 1u << dwBucket, hist.adwBuckets[dwBucket]);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置下一跳修改增量下发
+VOID diagAiEcmpSetNhopDelta(WORD32 dwEnable, WORD32 dwMaxSharePct) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置增量下发，启用: %u, 增量门限: %u%%\n", dwEnable, dwMaxSharePct);
+    
+    // 通过能力位设置，与FTM声明能力的路径一致；增量记录只能放在批量消息中，启用时同时声明批量消息
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    WORD32 dwCapability = manager.getFtmCapability();
+    dwCapability = dwEnable ? (dwCapability | AI_ECMP_FTM_CAP_NHOP_DELTA | AI_ECMP_FTM_CAP_NHOP_BATCH)
+                            : (dwCapability & ~AI_ECMP_FTM_CAP_NHOP_DELTA);
+    manager.setFtmCapability(dwCapability);
+    
+    LockedRef<NhopBatcher> batcherRef = manager.getNhopBatcher();
+    NhopBatcher& batcher = *batcherRef;
+    T_AI_ECMP_BATCH_CFG cfg = batcher.getConfig();
+    cfg.deltaMaxShare = dwMaxSharePct ? dwMaxSharePct / 100.0 : NhopBatcher::DEFAULT_DELTA_MAX_SHARE;
+    batcher.configure(cfg);
+    
+    AI_DIAG_PRINTF("[DIAG] 增量下发设置完成: %s, 变化表项超过 %.0f%% 时回退为全量\n",
+              batcher.getConfig().bDelta ? "启用" : "禁用", batcher.getConfig().deltaMaxShare * 100);
+}
+
+// 诊断函数：打印下一跳修改批量下发统计
+VOID diagAiEcmpPrintSendStats() {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印下一跳修改下发统计\n");
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    LockedRef<NhopBatcher> batcherRef = manager.getNhopBatcher();
+    const NhopBatcher& batcher = *batcherRef;
+    const T_AI_ECMP_BATCH_STATS& stats = batcher.getStats();
+    AI_DIAG_PRINTF("[DIAG] FTM能力: 0x%x, 批量消息: %s, 增量下发: %s, 增量门限: %.0f%%\n", manager.getFtmCapability(),
+              batcher.getConfig().bBatch ? "启用" : "禁用（逐个SG下发）",
+              batcher.getConfig().bDelta ? "启用" : "禁用", batcher.getConfig().deltaMaxShare * 100);
+    AI_DIAG_PRINTF("[DIAG] 提交修改数: %llu\n", stats.qwSubmitted);
+    AI_DIAG_PRINTF("[DIAG] 合并掉的修改数: %llu\n", stats.qwCoalesced);
+    AI_DIAG_PRINTF("[DIAG] 下发记录数: %llu（增量 %llu 条共 %llu 个表项, 全量回退 %llu 条）\n",
+              stats.qwRecords, stats.qwDeltaRecords, stats.qwDeltaEntries, stats.qwFullFallbacks);
+    AI_DIAG_PRINTF("[DIAG] 下发消息数: %llu\n", stats.qwMessages);
+    AI_DIAG_PRINTF("[DIAG] 下发总字节数: %llu\n", stats.qwBytes);
+    if (stats.qwMessages > 0) {
+        AI_DIAG_PRINTF("[DIAG] 平均每条消息: 记录 %.2f 条, %.1f 字节\n",
+                  static_cast<double>(stats.qwRecords) / stats.qwMessages,
+                  static_cast<double>(stats.qwBytes) / stats.qwMessages);
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
+}
+
+// 诊断函数：设置下一跳修改的在途确认跟踪
+VOID diagAiEcmpSetInflight(WORD32 dwSgId, WORD32 dwTimeoutMs, WORD32 dwMaxRetries) {
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：设置在途修改确认跟踪，SG ID: %u, 超时: %u ms, 重发次数: %u\n", 
+              dwSgId, dwTimeoutMs, dwMaxRetries);
+    
+    T_AI_ECMP_INFLIGHT_CFG cfg = {dwTimeoutMs ? dwTimeoutMs : InflightTracker::DEFAULT_TIMEOUT_MS,
+                                  dwMaxRetries};
+    
+    WORD32 dwAffected = 0;
+    auto applyInflight = [&cfg, &dwAffected](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        pInstance->setInflightConfig(cfg);
+        dwAffected++;
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(applyInflight);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            applyInflight(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
     
-    AI_DIAG_PRINTF("[DIAG] 算法类型设置完成，结果: 0x%x\n", dwResult);
+    AI_DIAG_PRINTF("[DIAG] 在途修改确认跟踪设置完成，影响实例数: %u\n", dwAffected);
+}
+
+// 诊断函数：打印下一跳修改的在途确认状态及统计
+VOID diagAiEcmpPrintInflight(WORD32 dwSgId) {
+    AI_DIAG_PRINTF("\n[DIAG] ============================================================\n");
+    AI_DIAG_PRINTF("[DIAG] 诊断命令：打印在途修改确认状态，SG ID: %u\n", dwSgId);
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n");
+    
+    const WORD64 qwNow = InflightTracker::nowMicros();
+    auto printInflight = [qwNow](WORD32 sgId, EcmpInstance* pInstance) {
+        if (!pInstance) return;
+        const InflightTracker& tracker = pInstance->getInflightTracker();
+        const T_AI_ECMP_INFLIGHT_CFG& cfg = tracker.getConfig();
+        const T_AI_ECMP_INFLIGHT_STATE& state = tracker.getState();
+        const T_AI_ECMP_INFLIGHT_STATS& stats = tracker.getStats();
+        AI_DIAG_PRINTF("[DIAG] SG %u: 超时 %u ms, 重发次数上限 %u\n", sgId, cfg.dwTimeoutMs, cfg.dwMaxRetries);
+        if (state.bActive) {
+            AI_DIAG_PRINTF("[DIAG]   等待确认: 版本号 %u, 成员数 %zu, 已等待 %llu ms, 已重发 %u 次\n",
+                      state.dwSeqId, tracker.getPendingTable().size(),
+                      (unsigned long long)((qwNow - state.qwFirstSendMicros) / 1000), state.dwRetries);
+        } else {
+            AI_DIAG_PRINTF("[DIAG]   没有待确认的修改\n");
+        }
+        AI_DIAG_PRINTF("[DIAG]   下发: %llu, 确认: %llu, 被取代: %llu, 冲突: %llu, 重发: %llu, 回滚: %llu\n",
+                  (unsigned long long)stats.qwSent, (unsigned long long)stats.qwAcked,
+                  (unsigned long long)stats.qwSuperseded, (unsigned long long)stats.qwConflicts,
+                  (unsigned long long)stats.qwRetries, (unsigned long long)stats.qwRollbacks);
+        AI_DIAG_PRINTF("[DIAG]   跳过优化周期: %llu, 丢弃计数器周期: %llu, 平均确认耗时: %llu us, 最大确认耗时: %llu us\n",
+                  (unsigned long long)stats.qwSkippedCycles, (unsigned long long)stats.qwDiscardedWindows,
+                  (unsigned long long)(stats.qwAcked ? stats.qwTotalAckMicros / stats.qwAcked : 0),
+                  (unsigned long long)stats.qwMaxAckMicros);
+    };
+    
+    auto& manager = CAISlbManagerSingleton::getManagerInstance();
+    if (dwSgId == 0) {
+        manager.forEachInstance(printInflight);
+    } else {
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
+        if (pInstance) {
+            printInflight(dwSgId, pInstance);
+        } else {
+            AI_DIAG_PRINTF("[DIAG] 错误：未找到SG %u 的实例\n", dwSgId);
+        }
+    }
+    
+    AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
 }
 
 // 诊断函数：打印计数器历史信息
@@ -507,7 +1415,8 @@ VOID diagAiEcmpResetInstance(WORD32 dwSgId) {
         });
     } else {
         AI_DIAG_PRINTF("[DIAG] 重置SG %u\n", dwSgId);
-        EcmpInstance* pInstance = manager.getInstance(dwSgId);
+        InstanceRef instanceRef = manager.getInstance(dwSgId);
+        EcmpInstance* pInstance = instanceRef.get();
         if (pInstance) {
             pInstance->reset();
             AI_DIAG_PRINTF("[DIAG] 实例 %u 重置完成\n", dwSgId);
@@ -627,7 +1536,7 @@ VOID diagAiEcmpHelp() {
     AI_DIAG_PRINTF("[DIAG] 8. diagAiEcmpSetAlgorithm(sgId, algoType)\n");
     AI_DIAG_PRINTF("[DIAG]    - 设置优化算法类型\n");
     AI_DIAG_PRINTF("[DIAG]    - sgId: SG ID，0表示所有实例\n");
-    AI_DIAG_PRINTF("[DIAG]    - algoType: 1=LocalSearch, 2=GA_IMP\n");
+    AI_DIAG_PRINTF("[DIAG]    - algoType: 1=LocalSearch, 3=Portfolio（2=GA_IMP未接入）\n");
     AI_DIAG_PRINTF("[DIAG] \n");
     
     AI_DIAG_PRINTF("[DIAG] 9. diagAiEcmpPrintCounterHistory(sgId, histNum)\n");
@@ -659,6 +1568,135 @@ VOID diagAiEcmpHelp() {
     AI_DIAG_PRINTF("[DIAG]     - pattern: 1=均匀, 2=不平衡, 3=随机\n");
     AI_DIAG_PRINTF("[DIAG] \n");
     
+    AI_DIAG_PRINTF("[DIAG] 14. diagAiEcmpPrintPortfolioStats(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印组合优化器的算法胜出统计\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 15. diagAiEcmpPrintTuner(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印在线参数调优器的各参数组统计\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 16. diagAiEcmpPinTunerArm(sgId, armIndex)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 固定调优参数组，armIndex=0xFFFFFFFF表示取消固定\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 17. diagAiEcmpPrintSolutionCache(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印优化解缓存的命中统计\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 18. diagAiEcmpSetLoadModel(sgId, modelType, param)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置负载模型：0=原始累计, 1=EWMA, 2=滑动窗口, 3=峰值保持\n");
+    AI_DIAG_PRINTF("[DIAG]     - param: 半衰期或窗口长度（周期数），0表示默认\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 19. diagAiEcmpSetReport(sgId, enable)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 启用(1)或禁用(0)优化报告打印，禁用后不分配打印器\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 20. diagAiEcmpPrintMemoryUsage(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印实例内存占用\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例的汇总\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 21. diagAiEcmpSetForecast(sgId, type, seasonCycles)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置负载预测：0=不预测, 1=Holt, 2=Holt-Winters\n");
+    AI_DIAG_PRINTF("[DIAG]     - seasonCycles: 季节周期长度（周期数），仅Holt-Winters\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 22. diagAiEcmpPrintForecast(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印负载预测状态及预测误差\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 23. diagAiEcmpSetElephant(sgId, enable, enterPercent, exitPercent)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置大流桶检测，门限为端口平均负载的百分比，0表示默认（50%%/30%%）\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 24. diagAiEcmpPrintElephants(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印大流桶集合及其所在端口\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 25. diagAiEcmpPortDown(portId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 模拟端口故障，只把故障端口上的桶重分配到存活端口并立即下发，保留负载历史\n");
+    AI_DIAG_PRINTF("[DIAG]     - portId: 故障端口ID\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 26. diagAiEcmpDrainPort(portId, enable, stepPercent, capPercent, capOverride)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 开始(1)或取消(0)端口排空，每个优化周期下发一步迁移，直到端口上没有桶\n");
+    AI_DIAG_PRINTF("[DIAG]     - stepPercent: 每步迁移上限，0表示默认25%%；capPercent: 存活端口利用率上限，0表示默认120%%\n");
+    AI_DIAG_PRINTF("[DIAG]     - capOverride: 1表示允许停滞时超出利用率上限，0表示上限为硬约束（停滞时只在存活端口间再均衡）\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 27. diagAiEcmpPrintDrain(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印端口排空进度\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 28. diagAiEcmpSetStability(sgId, mode, errorPercent, minSharePercent)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置稳定性判定：0=旧方式（各桶变异系数平均）, 1=按流量加权（仅显著桶）\n");
+    AI_DIAG_PRINTF("[DIAG]     - errorPercent: 负载估计相对误差门限，0表示默认15%%；minSharePercent: 显著桶下限，0表示默认10%%\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 29. diagAiEcmpPrintStability(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印稳定性判定配置及最近一次判定结果\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 30. diagAiEcmpSetSignificance(sgId, enable, confidencePercent, minSamples)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 启用(1)或禁用(0)优化效果显著性检验：在历史窗口上对候选表和当前表做配对检验，显著才下发\n");
+    AI_DIAG_PRINTF("[DIAG]     - confidencePercent: 单侧置信度（80~99），0表示默认90%%；minSamples: 最少速率样本数，0表示默认3\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 31. diagAiEcmpPrintSignificance(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印显著性检验配置及最近一次检验结果\n");
+    AI_DIAG_PRINTF("[DIAG]     - sgId: SG ID，0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 32. diagAiEcmpSetScheduler(budgetMicros, agingPercent)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置优化周期调度：各SG按期望收益（不均衡度 × 流量）排序，在每周期CPU预算内依次优化\n");
+    AI_DIAG_PRINTF("[DIAG]     - budgetMicros: 每周期CPU预算（微秒），0表示不限制；agingPercent: 每推迟一个周期优先级增加的百分比\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 33. diagAiEcmpPrintScheduler(topNum)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印调度统计及参与最近周期调度、按优先级排序的SG列表\n");
+    AI_DIAG_PRINTF("[DIAG]     - topNum: 打印的SG数，0表示全部\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 34. diagAiEcmpSetPhases(phaseNum)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置实例处理相位数：每个定时器节拍只处理一个相位的实例，0表示默认10\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 35. diagAiEcmpPrintPhases()\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印各相位的实例分布及节拍耗时直方图\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 36. diagAiEcmpPrintSendStats()\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印下一跳修改批量下发统计（提交、合并、记录、消息数及字节数）\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 37. diagAiEcmpSetNhopDelta(enable, maxSharePct)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置下一跳修改增量下发：enable 1启用/0禁用，变化表项超过maxSharePct%%时回退为全量，0表示默认50\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 38. diagAiEcmpSetInflight(sgId, timeoutMs, maxRetries)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 设置下一跳修改确认跟踪：超时未确认时全量重发maxRetries次后回滚，sgId为0表示所有实例，timeoutMs为0表示默认3000\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
+    AI_DIAG_PRINTF("[DIAG] 39. diagAiEcmpPrintInflight(sgId)\n");
+    AI_DIAG_PRINTF("[DIAG]     - 打印待确认的下一跳修改及确认、冲突、重发、回滚统计，sgId为0表示所有实例\n");
+    AI_DIAG_PRINTF("[DIAG] \n");
+    
     AI_DIAG_PRINTF("[DIAG] ============================================================\n\n");
 }
 
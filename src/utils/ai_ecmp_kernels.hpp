@@ -0,0 +1,336 @@
+#ifndef AI_ECMP_KERNELS_HPP
+#define AI_ECMP_KERNELS_HPP
+
+#include "ai_ecmp_types.h"
+#include "ai_ecmp_metrics.hpp"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace ai_ecmp {
+namespace kernels {
+
+/**
+ * 编译期容量标签，用于把运行时规模分派到对应容量的内核实例
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+struct CapacityTag {
+    static constexpr WORD32 dwMaxItems = MAX_ITEMS;
+    static constexpr WORD32 dwMaxPorts = MAX_PORTS;
+};
+
+/**
+ * 定长稠密问题，全部数据驻留在栈上
+ * 表项按槽位编号（仅包含计数有效的表项），端口按槽位编号（仅包含成员表中出现的端口）；
+ * 成员表记录表项槽位到端口槽位的映射
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+struct DenseProblem {
+    static_assert(MAX_PORTS <= 256, "端口槽位使用BYTE存储，容量不能超过256");
+
+    WORD32 dwItemNum;                   /* 有效表项数 */
+    WORD32 dwPortNum;                   /* 端口数 */
+    WORD32 adwHashIndex[MAX_ITEMS];     /* 表项槽位 -> hash_index */
+    WORD64 aqwCounts[MAX_ITEMS];        /* 表项槽位 -> 流量计数 */
+    BYTE   abyMemberPort[MAX_ITEMS];    /* 成员表：表项槽位 -> 端口槽位 */
+    WORD32 adwPortIds[MAX_PORTS];       /* 端口槽位 -> portId */
+    double adInvSpeeds[MAX_PORTS];      /* 端口槽位 -> 1/速率，速率未知或为0时为0（不参与评估） */
+    WORD64 aqwLoads[MAX_PORTS];         /* 端口槽位 -> 当前负载 */
+};
+
+/**
+ * @brief 查找端口槽位，端口首次出现时分配端口槽位
+ * @param lookupSpeed 端口速率查询函数（portId -> speed），仅在分配新端口槽位时调用
+ * @return 端口槽位，端口数超出容量返回MAX_PORTS
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS, typename SpeedLookup>
+inline WORD32 findOrAddDensePort(DenseProblem<MAX_ITEMS, MAX_PORTS>& problem,
+                                 WORD32 dwPortId, const SpeedLookup& lookupSpeed) {
+    WORD32 dwPortSlot = 0;
+    while (dwPortSlot < problem.dwPortNum && problem.adwPortIds[dwPortSlot] != dwPortId) {
+        ++dwPortSlot;
+    }
+    if (dwPortSlot == problem.dwPortNum) {
+        if (problem.dwPortNum >= MAX_PORTS) {
+            return MAX_PORTS;
+        }
+        WORD32 dwSpeed = lookupSpeed(dwPortId);
+        problem.adwPortIds[dwPortSlot] = dwPortId;
+        problem.adInvSpeeds[dwPortSlot] = dwSpeed > 0 ? 1.0 / dwSpeed : 0.0;
+        problem.aqwLoads[dwPortSlot] = 0;
+        problem.dwPortNum++;
+    }
+    return dwPortSlot;
+}
+
+/**
+ * @brief 向稠密问题追加一个表项，端口首次出现时分配端口槽位
+ * @param lookupSpeed 端口速率查询函数（portId -> speed），仅在分配新端口槽位时调用
+ * @return 规模超出容量返回false
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS, typename SpeedLookup>
+inline bool appendDenseItem(DenseProblem<MAX_ITEMS, MAX_PORTS>& problem,
+                            WORD32 dwHashIndex, WORD32 dwPortId, WORD64 qwCount,
+                            const SpeedLookup& lookupSpeed) {
+    if (problem.dwItemNum >= MAX_ITEMS) {
+        return false;
+    }
+
+    WORD32 dwPortSlot = findOrAddDensePort(problem, dwPortId, lookupSpeed);
+    if (dwPortSlot >= MAX_PORTS) {
+        return false;
+    }
+
+    WORD32 dwItemSlot = problem.dwItemNum++;
+    problem.adwHashIndex[dwItemSlot] = dwHashIndex;
+    problem.aqwCounts[dwItemSlot] = qwCount;
+    problem.abyMemberPort[dwItemSlot] = static_cast<BYTE>(dwPortSlot);
+    problem.aqwLoads[dwPortSlot] += qwCount;
+    return true;
+}
+
+/**
+ * @brief 由成员表、计数和端口速率构建稠密问题
+ * @param memberTable 成员表(hash_index -> portId)
+ * @param memberCounts 成员计数表
+ * @param portSpeeds 端口速率表(portId -> speed)
+ * @param problem 输出的稠密问题
+ * @return 规模超出容量返回false
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline bool buildDenseProblem(
+    const std::unordered_map<WORD32, WORD32>& memberTable,
+    const std::vector<WORD64>& memberCounts,
+    const std::unordered_map<WORD32, WORD32>& portSpeeds,
+    DenseProblem<MAX_ITEMS, MAX_PORTS>& problem) {
+
+    problem.dwItemNum = 0;
+    problem.dwPortNum = 0;
+
+    auto lookupSpeed = [&portSpeeds](WORD32 dwPortId) -> WORD32 {
+        auto speedIt = portSpeeds.find(dwPortId);
+        return speedIt != portSpeeds.end() ? speedIt->second : 0;
+    };
+
+    for (const auto& entry : memberTable) {
+        // 与 utils::calculatePortLoads 一致：越界的hash_index不计入负载，也不参与交换
+        if (entry.first >= memberCounts.size()) {
+            continue;
+        }
+        if (!appendDenseItem(problem, entry.first, entry.second, memberCounts[entry.first], lookupSpeed)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 由数组形式的成员表（以hash_index为下标）、计数和端口数组构建稠密问题
+ * 固定表项只把负载计入所在端口，不占用表项槽位，因此不参与交换，写回时保持不变
+ * @param pdwMemberTable 成员表
+ * @param dwTableSize 成员表长度
+ * @param pqwCounts 成员计数
+ * @param dwCountNum 成员计数长度
+ * @param pdwPortIds 端口ID数组
+ * @param pdwPortSpeeds 端口速率数组，与pdwPortIds等长同序
+ * @param dwPortNum 端口数组长度
+ * @param problem 输出的稠密问题
+ * @param pbyPinned 固定表项掩码（以hash_index为下标，长度不小于成员表），nullptr表示无固定表项
+ * @return 规模超出容量返回false
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline bool buildDenseProblem(
+    const WORD32* pdwMemberTable, WORD32 dwTableSize,
+    const WORD64* pqwCounts, WORD32 dwCountNum,
+    const WORD32* pdwPortIds, const WORD32* pdwPortSpeeds, WORD32 dwPortNum,
+    DenseProblem<MAX_ITEMS, MAX_PORTS>& problem,
+    const BYTE* pbyPinned = nullptr) {
+
+    problem.dwItemNum = 0;
+    problem.dwPortNum = 0;
+
+    auto lookupSpeed = [pdwPortIds, pdwPortSpeeds, dwPortNum](WORD32 dwPortId) -> WORD32 {
+        for (WORD32 i = 0; i < dwPortNum; ++i) {
+            if (pdwPortIds[i] == dwPortId) {
+                return pdwPortSpeeds[i];
+            }
+        }
+        return 0;
+    };
+
+    WORD32 dwItemNum = std::min(dwTableSize, dwCountNum);
+    for (WORD32 dwHashIndex = 0; dwHashIndex < dwItemNum; ++dwHashIndex) {
+        if (pbyPinned && pbyPinned[dwHashIndex]) {
+            WORD32 dwPortSlot = findOrAddDensePort(problem, pdwMemberTable[dwHashIndex], lookupSpeed);
+            if (dwPortSlot >= MAX_PORTS) {
+                return false;
+            }
+            problem.aqwLoads[dwPortSlot] += pqwCounts[dwHashIndex];
+            continue;
+        }
+        if (!appendDenseItem(problem, dwHashIndex, pdwMemberTable[dwHashIndex], pqwCounts[dwHashIndex], lookupSpeed)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 将稠密成员表写回哈希成员表（未纳入稠密问题的表项保持不变）
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline void writeBackMemberTable(
+    const DenseProblem<MAX_ITEMS, MAX_PORTS>& problem,
+    std::unordered_map<WORD32, WORD32>& memberTable) {
+
+    for (WORD32 i = 0; i < problem.dwItemNum; ++i) {
+        memberTable[problem.adwHashIndex[i]] = problem.adwPortIds[problem.abyMemberPort[i]];
+    }
+}
+
+/**
+ * @brief 将稠密成员表写回数组形式的成员表（以hash_index为下标，未纳入的表项保持不变）
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline void writeBackMemberTable(
+    const DenseProblem<MAX_ITEMS, MAX_PORTS>& problem,
+    std::vector<WORD32>& memberTable) {
+
+    for (WORD32 i = 0; i < problem.dwItemNum; ++i) {
+        if (problem.adwHashIndex[i] < memberTable.size()) {
+            memberTable[problem.adwHashIndex[i]] = problem.adwPortIds[problem.abyMemberPort[i]];
+        }
+    }
+}
+
+/**
+ * @brief 计算负载分布指标，语义与 utils::calculateLoadBalanceMetrics 一致
+ * @param aqwLoads 端口槽位负载
+ * @param adInvSpeeds 端口槽位速率倒数
+ * @param dwPortNum 端口数
+ * @return 评估结果
+ */
+template <WORD32 MAX_PORTS>
+inline T_AI_ECMP_EVAL evaluateLoads(const WORD64 (&aqwLoads)[MAX_PORTS],
+                                    const double (&adInvSpeeds)[MAX_PORTS],
+                                    WORD32 dwPortNum) {
+    T_AI_ECMP_EVAL eval = {};
+
+    double adNormalized[MAX_PORTS];
+    WORD32 dwValid = 0;
+    for (WORD32 i = 0; i < dwPortNum; ++i) {
+        if (adInvSpeeds[i] > 0) {
+            adNormalized[dwValid++] = static_cast<double>(aqwLoads[i]) * adInvSpeeds[i];
+        }
+    }
+    if (dwValid == 0) {
+        return eval;
+    }
+
+    double sum = 0.0;
+    double minLoad = adNormalized[0];
+    double maxLoad = adNormalized[0];
+    for (WORD32 i = 0; i < dwValid; ++i) {
+        sum += adNormalized[i];
+        minLoad = std::min(minLoad, adNormalized[i]);
+        maxLoad = std::max(maxLoad, adNormalized[i]);
+    }
+
+    double avgLoad = sum / dwValid;
+    if (avgLoad <= 0) {
+        return eval;
+    }
+
+    double sumAbsDev = 0.0;
+    for (WORD32 i = 0; i < dwValid; ++i) {
+        sumAbsDev += std::abs(adNormalized[i] - avgLoad);
+    }
+
+    eval.upBoundGap = (maxLoad - avgLoad) / avgLoad;
+    eval.lowBoundGap = (avgLoad - minLoad) / avgLoad;
+    eval.totalGap = eval.upBoundGap + eval.lowBoundGap;
+    eval.avgGap = sumAbsDev / dwValid / avgLoad;
+    eval.balanceScore = -eval.totalGap;
+    return eval;
+}
+
+/**
+ * @brief 评估稠密问题当前成员表的负载分布
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline T_AI_ECMP_EVAL evaluateProblem(const DenseProblem<MAX_ITEMS, MAX_PORTS>& problem) {
+    return evaluateLoads<MAX_PORTS>(problem.aqwLoads, problem.adInvSpeeds, problem.dwPortNum);
+}
+
+/**
+ * @brief 增量评估交换两个表项的改进量，语义与 utils::calculateSwapImprovement 一致
+ * @param problem 稠密问题
+ * @param currentScore 当前成员表的平衡得分
+ * @param dwSlot1 表项槽位1
+ * @param dwSlot2 表项槽位2
+ * @return 改进量（交换后得分 - 当前得分），同端口返回0
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline double evaluateSwap(const DenseProblem<MAX_ITEMS, MAX_PORTS>& problem,
+                           double currentScore, WORD32 dwSlot1, WORD32 dwSlot2) {
+    BYTE byPort1 = problem.abyMemberPort[dwSlot1];
+    BYTE byPort2 = problem.abyMemberPort[dwSlot2];
+    if (byPort1 == byPort2) {
+        return 0.0;
+    }
+
+    WORD64 aqwLoads[MAX_PORTS];
+    std::copy(problem.aqwLoads, problem.aqwLoads + problem.dwPortNum, aqwLoads);
+    aqwLoads[byPort1] = aqwLoads[byPort1] - problem.aqwCounts[dwSlot1] + problem.aqwCounts[dwSlot2];
+    aqwLoads[byPort2] = aqwLoads[byPort2] - problem.aqwCounts[dwSlot2] + problem.aqwCounts[dwSlot1];
+
+    T_AI_ECMP_EVAL newEval = evaluateLoads<MAX_PORTS>(aqwLoads, problem.adInvSpeeds, problem.dwPortNum);
+    return utils::calculateBalanceScore(newEval) - currentScore;
+}
+
+/**
+ * @brief 执行交换：更新成员表和端口负载
+ */
+template <WORD32 MAX_ITEMS, WORD32 MAX_PORTS>
+inline void applySwap(DenseProblem<MAX_ITEMS, MAX_PORTS>& problem, WORD32 dwSlot1, WORD32 dwSlot2) {
+    BYTE byPort1 = problem.abyMemberPort[dwSlot1];
+    BYTE byPort2 = problem.abyMemberPort[dwSlot2];
+
+    problem.aqwLoads[byPort1] = problem.aqwLoads[byPort1] - problem.aqwCounts[dwSlot1] + problem.aqwCounts[dwSlot2];
+    problem.aqwLoads[byPort2] = problem.aqwLoads[byPort2] - problem.aqwCounts[dwSlot2] + problem.aqwCounts[dwSlot1];
+    problem.abyMemberPort[dwSlot1] = byPort2;
+    problem.abyMemberPort[dwSlot2] = byPort1;
+}
+
+/**
+ * @brief 按规模分派到最小可容纳的容量档位（16/32/64/128）
+ * 成员表中出现的端口数不会超过表项数，因此各档位的端口容量与表项容量相同
+ * @param dwItemNum 表项数
+ * @param dwPortNum 端口数
+ * @param visitor 访问者，需提供 template<WORD32 I, WORD32 P> void operator()(CapacityTag<I, P>)
+ * @return 规模超出最大容量返回false
+ */
+template <typename Visitor>
+inline bool dispatchByCapacity(WORD32 dwItemNum, WORD32 dwPortNum, Visitor& visitor) {
+    WORD32 dwScale = std::max(dwItemNum, dwPortNum);
+    if (dwScale <= 16) {
+        visitor(CapacityTag<16, 16>());
+    } else if (dwScale <= 32) {
+        visitor(CapacityTag<32, 32>());
+    } else if (dwScale <= 64) {
+        visitor(CapacityTag<64, 64>());
+    } else if (dwScale <= FTM_TRUNK_MAX_HASH_NUM_15K) {
+        visitor(CapacityTag<FTM_TRUNK_MAX_HASH_NUM_15K, FTM_LAG_MAX_MEM_NUM_15K>());
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace kernels
+} // namespace ai_ecmp
+
+#endif /* AI_ECMP_KERNELS_HPP */
@@ -15,6 +15,7 @@ const char* aiEcmpStatusToString(T_AI_ECMP_STATUS status) {
         case AI_ECMP_EXPAND:  return "EXPAND";
         case AI_ECMP_BALANCE: return "BALANCE";
         case AI_ECMP_FAIL:    return "FAIL";
+        case AI_ECMP_SHRINK:  return "SHRINK";
         default:              return "UNKNOWN";
     }
 }
@@ -39,6 +40,57 @@ std::unordered_map<WORD32, WORD64> calculatePortLoads(
     return portLoads;
 }
 
+std::unordered_map<WORD32, WORD64> calculatePortLoads(
+    const std::vector<WORD32>& v_memberTable,
+    const std::vector<WORD64>& v_memberCounts) {
+    
+    std::unordered_map<WORD32, WORD64> portLoads;
+    
+    size_t itemNum = std::min(v_memberTable.size(), v_memberCounts.size());
+    for (size_t i = 0; i < itemNum; ++i) {
+        portLoads[v_memberTable[i]] += v_memberCounts[i];
+    }
+    
+    return portLoads;
+}
+
+void calculatePortLoads(
+    const std::vector<WORD32>& v_memberTable,
+    const std::vector<WORD64>& v_memberCounts,
+    const std::vector<WORD32>& v_portIds,
+    std::vector<WORD64>& v_portLoads) {
+    
+    v_portLoads.assign(v_portIds.size(), 0);
+    
+    size_t itemNum = std::min(v_memberTable.size(), v_memberCounts.size());
+    for (size_t i = 0; i < itemNum; ++i) {
+        size_t portIndex = std::find(v_portIds.begin(), v_portIds.end(), v_memberTable[i]) - v_portIds.begin();
+        if (portIndex < v_portIds.size()) {
+            v_portLoads[portIndex] += v_memberCounts[i];
+        }
+    }
+}
+
+std::unordered_map<WORD32, WORD32> memberTableToMap(const std::vector<WORD32>& v_memberTable) {
+    std::unordered_map<WORD32, WORD32> memberTable;
+    memberTable.reserve(v_memberTable.size());
+    for (size_t i = 0; i < v_memberTable.size(); ++i) {
+        memberTable[static_cast<WORD32>(i)] = v_memberTable[i];
+    }
+    return memberTable;
+}
+
+std::unordered_map<WORD32, WORD32> portArrayToMap(
+    const std::vector<WORD32>& v_portIds,
+    const std::vector<WORD32>& v_portValues) {
+    std::unordered_map<WORD32, WORD32> portMap;
+    portMap.reserve(v_portIds.size());
+    for (size_t i = 0; i < v_portIds.size() && i < v_portValues.size(); ++i) {
+        portMap[v_portIds[i]] = v_portValues[i];
+    }
+    return portMap;
+}
+
 std::unordered_map<WORD32, double> calculatePortUtilization(
     const std::unordered_map<WORD32, WORD64>& v_portLoads,
     const std::unordered_map<WORD32, WORD32>& v_portSpeeds) {
@@ -133,6 +185,62 @@ T_AI_ECMP_EVAL calculateLoadBalanceMetrics(
     return eval;
 }
 
+T_AI_ECMP_EVAL calculateLoadBalanceMetrics(
+    const std::vector<WORD32>& v_memberTable,
+    const std::vector<WORD64>& v_memberCounts,
+    const std::vector<WORD32>& v_portIds,
+    const std::vector<WORD32>& v_portSpeeds) {
+    
+    T_AI_ECMP_EVAL eval = {};
+    
+    const size_t portNum = std::min(v_portIds.size(), v_portSpeeds.size());
+    std::vector<WORD64> portLoads(portNum, 0);
+    std::vector<bool> portUsed(portNum, false);
+    
+    size_t itemNum = std::min(v_memberTable.size(), v_memberCounts.size());
+    for (size_t i = 0; i < itemNum; ++i) {
+        size_t portIndex = std::find(v_portIds.begin(), v_portIds.begin() + portNum, v_memberTable[i]) - v_portIds.begin();
+        if (portIndex < portNum) {
+            portLoads[portIndex] += v_memberCounts[i];
+            portUsed[portIndex] = true;
+        }
+    }
+    
+    // 计算归一化负载 (考虑端口速率)
+    std::vector<double> normalizedLoads;
+    normalizedLoads.reserve(portNum);
+    for (size_t p = 0; p < portNum; ++p) {
+        if (portUsed[p] && v_portSpeeds[p] > 0) {
+            normalizedLoads.push_back(static_cast<double>(portLoads[p]) / v_portSpeeds[p]);
+        }
+    }
+    
+    // 如果没有有效的归一化负载，直接返回默认值
+    if (normalizedLoads.empty()) {
+        return eval;
+    }
+    
+    double avgLoad = std::accumulate(normalizedLoads.begin(), normalizedLoads.end(), 0.0) / normalizedLoads.size();
+    double minLoad = *std::min_element(normalizedLoads.begin(), normalizedLoads.end());
+    double maxLoad = *std::max_element(normalizedLoads.begin(), normalizedLoads.end());
+    
+    if (avgLoad > 0) {
+        eval.upBoundGap = (maxLoad - avgLoad) / avgLoad;
+        eval.lowBoundGap = (avgLoad - minLoad) / avgLoad;
+        eval.totalGap = eval.upBoundGap + eval.lowBoundGap;
+        
+        double sumAbsDev = 0.0;
+        for (double loadValue : normalizedLoads) {
+            sumAbsDev += std::abs(loadValue - avgLoad);
+        }
+        eval.avgGap = sumAbsDev / normalizedLoads.size() / avgLoad;
+    }
+    
+    eval.balanceScore = -eval.totalGap;
+    
+    return eval;
+}
+
 double calculateSwapImprovement(
     const std::unordered_map<WORD32, WORD32>& v_memberTable,
     const std::vector<WORD64>& v_memberCounts,
@@ -290,6 +398,34 @@ double calculateCounterVarianceCoefficient(
     return calculateMean(allVarianceCoeffs);
 }
 
+double calculateCounterVarianceCoefficient(
+    const std::vector<WORD64>& counterHistory,
+    size_t historyNum,
+    size_t memberNum) {
+    
+    if (historyNum < 2 || counterHistory.size() < historyNum * memberNum) {
+        return 1.0; // 返回高方差，表示不稳定
+    }
+    
+    // 计算每个哈希索引在历史周期中的变异系数，然后取平均值
+    std::vector<double> allVarianceCoeffs;
+    allVarianceCoeffs.reserve(memberNum);
+    std::vector<double> memberValues(historyNum);
+    
+    for (size_t hashIndex = 0; hashIndex < memberNum; ++hashIndex) {
+        for (size_t cycle = 0; cycle < historyNum; ++cycle) {
+            memberValues[cycle] = static_cast<double>(counterHistory[cycle * memberNum + hashIndex]);
+        }
+        allVarianceCoeffs.push_back(calculateVariationCoefficient(memberValues));
+    }
+    
+    if (allVarianceCoeffs.empty()) {
+        return 1.0; // 返回高方差，表示不稳定
+    }
+    
+    return calculateMean(allVarianceCoeffs);
+}
+
 // 注意：isCounterVarianceStable 方法已移动到 EcmpInstance 类中，这里不再实现
 
 // ===== 新增：改进百分比计算函数实现 =====
@@ -319,6 +455,163 @@ double calculateImprovementPercentage(
     return improvementPercent;
 }
 
+// 由总流量、最大单桶流量、总速率和最大速率估计可达最优得分
+static double estimateTargetBalanceScore(WORD64 totalLoad, WORD64 maxCount, WORD64 totalSpeed, WORD32 maxSpeed) {
+    if (totalLoad == 0 || totalSpeed == 0 || maxSpeed == 0) {
+        return 0.0;
+    }
+
+    // 平均利用率与最大单桶在最快端口上的利用率
+    double avgUtil = static_cast<double>(totalLoad) / totalSpeed;
+    double maxBucketUtil = static_cast<double>(maxCount) / maxSpeed;
+
+    if (maxBucketUtil <= avgUtil) {
+        return 0.0;
+    }
+
+    return -((maxBucketUtil - avgUtil) / avgUtil);
+}
+
+double calculateTargetBalanceScore(
+    const std::vector<WORD64>& v_memberCounts,
+    const std::unordered_map<WORD32, WORD32>& v_portSpeeds) {
+
+    WORD64 totalLoad = 0;
+    WORD64 maxCount = 0;
+    for (WORD64 count : v_memberCounts) {
+        totalLoad += count;
+        maxCount = std::max(maxCount, count);
+    }
+
+    WORD64 totalSpeed = 0;
+    WORD32 maxSpeed = 0;
+    for (const auto& entry : v_portSpeeds) {
+        totalSpeed += entry.second;
+        maxSpeed = std::max(maxSpeed, entry.second);
+    }
+
+    return estimateTargetBalanceScore(totalLoad, maxCount, totalSpeed, maxSpeed);
+}
+
+double calculateTargetBalanceScore(
+    const WORD64* pqwCounts, size_t countNum,
+    const WORD32* pdwPortSpeeds, size_t portNum) {
+
+    WORD64 totalLoad = 0;
+    WORD64 maxCount = 0;
+    for (size_t i = 0; i < countNum; ++i) {
+        totalLoad += pqwCounts[i];
+        maxCount = std::max(maxCount, pqwCounts[i]);
+    }
+
+    WORD64 totalSpeed = 0;
+    WORD32 maxSpeed = 0;
+    for (size_t i = 0; i < portNum; ++i) {
+        totalSpeed += pdwPortSpeeds[i];
+        maxSpeed = std::max(maxSpeed, pdwPortSpeeds[i]);
+    }
+
+    return estimateTargetBalanceScore(totalLoad, maxCount, totalSpeed, maxSpeed);
+}
+
+bool apportionBySpeed(
+    const std::vector<WORD32>& v_portSpeeds,
+    WORD32 dwTotalItems,
+    std::vector<WORD32>& v_weights) {
+
+    const size_t portNum = v_portSpeeds.size();
+    if (portNum == 0 || dwTotalItems < portNum) {
+        return false;
+    }
+
+    // 每个端口先分配一个逻辑成员，保证端口不被移出成员表
+    v_weights.assign(portNum, 1);
+    WORD32 dwAssigned = static_cast<WORD32>(portNum);
+
+    while (dwAssigned < dwTotalItems) {
+        size_t bestPort = portNum;
+        double bestPriority = 0.0;
+        for (size_t i = 0; i < portNum; ++i) {
+            if (v_portSpeeds[i] == 0) {
+                continue;
+            }
+            double priority = static_cast<double>(v_portSpeeds[i]) / (2.0 * v_weights[i] + 1.0);
+            if (bestPort == portNum || priority > bestPriority) {
+                bestPort = i;
+                bestPriority = priority;
+            }
+        }
+        if (bestPort == portNum) {
+            // 所有端口速率未知：均分剩余逻辑成员
+            for (size_t i = 0; dwAssigned < dwTotalItems; i = (i + 1) % portNum) {
+                v_weights[i]++;
+                dwAssigned++;
+            }
+            break;
+        }
+        v_weights[bestPort]++;
+        dwAssigned++;
+    }
+
+    return true;
+}
+
+double calculateSpeedShareDeviation(
+    const std::vector<WORD32>& v_portSpeeds,
+    const std::vector<WORD32>& v_weights) {
+
+    const size_t portNum = std::min(v_portSpeeds.size(), v_weights.size());
+    double totalSpeed = 0.0;
+    double totalWeight = 0.0;
+    for (size_t i = 0; i < portNum; ++i) {
+        totalSpeed += v_portSpeeds[i];
+        totalWeight += v_weights[i];
+    }
+    if (portNum == 0 || totalWeight <= 0.0) {
+        return 0.0;
+    }
+
+    double maxDeviation = 0.0;
+    for (size_t i = 0; i < portNum; ++i) {
+        double speedShare = totalSpeed > 0.0 ? v_portSpeeds[i] / totalSpeed : 1.0 / portNum;
+        if (speedShare <= 0.0) {
+            continue;
+        }
+        double weightShare = v_weights[i] / totalWeight;
+        maxDeviation = std::max(maxDeviation, std::fabs(weightShare - speedShare) / speedShare);
+    }
+
+    return maxDeviation;
+}
+
+void layoutInterleaved(
+    const std::vector<WORD32>& v_portIds,
+    const std::vector<WORD32>& v_weights,
+    std::vector<WORD32>& v_memberTable) {
+
+    const size_t portNum = std::min(v_portIds.size(), v_weights.size());
+    long long totalWeight = 0;
+    for (size_t i = 0; i < portNum; ++i) {
+        totalWeight += v_weights[i];
+    }
+
+    v_memberTable.clear();
+    v_memberTable.reserve(static_cast<size_t>(totalWeight));
+
+    // 平滑加权轮询：每步各端口累加自身权重，选出当前值最大的端口并减去总权重
+    std::vector<long long> current(portNum, 0);
+    for (long long n = 0; n < totalWeight; ++n) {
+        size_t bestPort = 0;
+        for (size_t i = 0; i < portNum; ++i) {
+            current[i] += v_weights[i];
+            if (current[i] > current[bestPort]) {
+                bestPort = i;
+            }
+        }
+        current[bestPort] -= totalWeight;
+        v_memberTable.push_back(v_portIds[bestPort]);
+    }
+}
 
 
 } // namespace utils
@@ -25,6 +25,36 @@ std::unordered_map<WORD32, WORD64> calculatePortLoads(
     const std::unordered_map<WORD32, WORD32>& v_memberTable,
     const std::vector<WORD64>& v_memberCounts);
 
+/**
+ * @brief 根据数组形式的成员表和计数器计算各端口负载
+ * @param v_memberTable 成员表（下标为hash_index，值为port_id）
+ * @param v_memberCounts 成员计数表
+ * @return 端口负载映射 (port_id -> load_count)
+ */
+std::unordered_map<WORD32, WORD64> calculatePortLoads(
+    const std::vector<WORD32>& v_memberTable,
+    const std::vector<WORD64>& v_memberCounts);
+
+/**
+ * @brief 按端口数组计算各端口负载（不分配节点容器）
+ * @param v_memberTable 成员表（下标为hash_index，值为port_id）
+ * @param v_memberCounts 成员计数表
+ * @param v_portIds 端口ID数组
+ * @param v_portLoads 输出：与v_portIds下标对应的端口负载
+ */
+void calculatePortLoads(
+    const std::vector<WORD32>& v_memberTable,
+    const std::vector<WORD64>& v_memberCounts,
+    const std::vector<WORD32>& v_portIds,
+    std::vector<WORD64>& v_portLoads);
+
+/**
+ * @brief 将数组形式的成员表转换为映射形式（用于打印报告）
+ * @param v_memberTable 成员表（下标为hash_index，值为port_id）
+ * @return 成员表 (hash_index -> port_id)
+ */
+std::unordered_map<WORD32, WORD32> memberTableToMap(const std::vector<WORD32>& v_memberTable);
+
 /**
  * @brief 计算端口利用率
  * @param v_portLoads 端口负载映射 (port_id -> load_count)
@@ -35,6 +65,16 @@ std::unordered_map<WORD32, double> calculatePortUtilization(
     const std::unordered_map<WORD32, WORD64>& v_portLoads,
     const std::unordered_map<WORD32, WORD32>& v_portSpeeds);
 
+/**
+ * @brief 将端口ID数组和属性数组转换为映射形式（用于打印报告）
+ * @param v_portIds 端口ID数组
+ * @param v_portValues 与端口ID下标对应的属性数组
+ * @return 端口属性映射 (port_id -> value)
+ */
+std::unordered_map<WORD32, WORD32> portArrayToMap(
+    const std::vector<WORD32>& v_portIds,
+    const std::vector<WORD32>& v_portValues);
+
 /**
  * @brief 计算利用率平均值
  * @param v_portUtilization 端口利用率映射
@@ -53,6 +93,21 @@ T_AI_ECMP_EVAL calculateLoadBalanceMetrics(
     const std::unordered_map<WORD32, WORD64>& v_portLoads,
     const std::unordered_map<WORD32, WORD32>& v_portSpeeds);
 
+/**
+ * @brief 按数组形式的成员表和端口数组计算负载平衡指标
+ * 与映射版本口径一致：只统计至少分配了一个逻辑成员且速率有效的端口
+ * @param v_memberTable 成员表（下标为hash_index，值为port_id）
+ * @param v_memberCounts 成员计数表
+ * @param v_portIds 端口ID数组
+ * @param v_portSpeeds 与端口ID下标对应的速率数组
+ * @return 负载平衡评估结果
+ */
+T_AI_ECMP_EVAL calculateLoadBalanceMetrics(
+    const std::vector<WORD32>& v_memberTable,
+    const std::vector<WORD64>& v_memberCounts,
+    const std::vector<WORD32>& v_portIds,
+    const std::vector<WORD32>& v_portSpeeds);
+
 /**
  * @brief 计算两个哈希索引交换后的负载改进量
  * @param v_memberTable 成员表
@@ -119,6 +174,18 @@ double calculateCounterVarianceCoefficient(
     const std::vector<std::vector<WORD64>>& counterHistory,
     const std::vector<WORD64>& memberCounts);
 
+/**
+ * @brief 计算平铺存放的计数器历史的整体变异系数
+ * @param counterHistory 计数器历史（每周期memberNum个计数连续存放，周期顺序不影响结果）
+ * @param historyNum 有效历史周期数
+ * @param memberNum 每周期的成员数
+ * @return 整体变异系数
+ */
+double calculateCounterVarianceCoefficient(
+    const std::vector<WORD64>& counterHistory,
+    size_t historyNum,
+    size_t memberNum);
+
 /**
  * @brief 计算负载均衡改进百分比
  * @param beforeEval 优化前的评估结果
@@ -129,6 +196,66 @@ double calculateImprovementPercentage(
     const T_AI_ECMP_EVAL& beforeEval,
     const T_AI_ECMP_EVAL& afterEval);
 
+/**
+ * @brief 估计当前流量下可达到的最优平衡得分（用于算法提前终止）
+ * 连续松弛估计：最大的单个哈希桶至少落在最快端口上，若其利用率已超过
+ * 平均利用率，则正偏差无法低于该差值；否则理想得分为0
+ * @param v_memberCounts 成员计数表
+ * @param v_portSpeeds 端口速率映射 (port_id -> speed)
+ * @return 可达最优得分估计（<=0，越接近0越好）
+ */
+double calculateTargetBalanceScore(
+    const std::vector<WORD64>& v_memberCounts,
+    const std::unordered_map<WORD32, WORD32>& v_portSpeeds);
+
+/**
+ * @brief 估计当前流量下可达到的最优平衡得分（端口速率为数组，不分配容器）
+ * @param pqwCounts 成员计数
+ * @param countNum 成员计数个数
+ * @param pdwPortSpeeds 端口速率数组
+ * @param portNum 端口数
+ * @return 可达最优得分估计（<=0，越接近0越好）
+ */
+double calculateTargetBalanceScore(
+    const WORD64* pqwCounts, size_t countNum,
+    const WORD32* pdwPortSpeeds, size_t portNum);
+
+/**
+ * @brief 按端口速率比例分配逻辑成员数（Webster/Sainte-Laguë最高平均数法）
+ * 每个端口至少分配一个逻辑成员，其余按 speed/(2*weight+1) 的优先级逐个分配；
+ * 速率为0的端口只保留一个逻辑成员
+ * @param v_portSpeeds 端口速率数组
+ * @param dwTotalItems 逻辑成员总数（不小于端口数）
+ * @param v_weights 输出：与v_portSpeeds下标对应的逻辑成员数
+ * @return 逻辑成员总数小于端口数时返回false
+ */
+bool apportionBySpeed(
+    const std::vector<WORD32>& v_portSpeeds,
+    WORD32 dwTotalItems,
+    std::vector<WORD32>& v_weights);
+
+/**
+ * @brief 计算各端口逻辑成员占比相对其速率占比的最大相对偏差
+ * 速率为0的端口不参与比较；所有端口速率未知时按均分比较
+ * @param v_portSpeeds 端口速率数组
+ * @param v_weights 与v_portSpeeds下标对应的逻辑成员数
+ * @return 最大相对偏差（0表示逻辑成员数与速率严格成比例）
+ */
+double calculateSpeedShareDeviation(
+    const std::vector<WORD32>& v_portSpeeds,
+    const std::vector<WORD32>& v_weights);
+
+/**
+ * @brief 按端口逻辑成员数交织生成成员表（平滑加权轮询），同一端口的表项尽量分散
+ * @param v_portIds 端口ID数组
+ * @param v_weights 与v_portIds下标对应的逻辑成员数
+ * @param v_memberTable 输出：成员表（下标为hash_index，值为port_id），长度为逻辑成员数之和
+ */
+void layoutInterleaved(
+    const std::vector<WORD32>& v_portIds,
+    const std::vector<WORD32>& v_weights,
+    std::vector<WORD32>& v_memberTable);
+
 /**
  * @brief 评估优化效果是否达到最小改进阈值
  * @param beforeEval 优化前的评估结果